@@ -48,9 +48,6 @@ void UAIEQS_Thermal::RunTest(FEnvQueryInstance& QueryInstance) const
 		return;
 	}
 
-	// For LOS and time-of-day composition, we’ll use the current time (UTC)
-	const FDateTime NowUTC = FDateTime::UtcNow();
-
 	// Pull item data as points
 	const UEnvQueryItemType_Point* PointTypeCDO = GetDefault<UEnvQueryItemType_Point>();
 	if (!PointTypeCDO) return;
@@ -77,7 +74,7 @@ void UAIEQS_Thermal::RunTest(FEnvQueryInstance& QueryInstance) const
 		}
 
 		// Compose current temperature using Thermo Forge
-		const FThermoForgeGridHit Hit = Thermo->QueryNearestBakedGridPoint(ItemLoc, NowUTC);
+		const FThermoForgeGridHit Hit = Thermo->QueryNearestBakedGridPointNow(ItemLoc);
 		if (!Hit.bFound)
 		{
 			It.ForceItemState(EEnvItemStatus::Failed);
@@ -58,6 +58,7 @@ void UAISense_Thermal::HandleListenerRemoved(const FPerceptionListener& RemovedL
     if (UAIPerceptionComponent* Comp = RemovedListener.Listener.Get())
     {
         ListenerComps.RemoveAll([Comp](const TWeakObjectPtr<UAIPerceptionComponent>& X){ return X.Get() == Comp; });
+        ListenerCursors.Remove(Comp);
         UE_LOG(LogTemp, Log, TEXT("[ThermoForge] Listener removed: %s"), *GetNameSafe(Comp));
     }
 }
@@ -149,6 +150,7 @@ static bool ProbeThermoRing(UWorld& World,
                             UThermoForgeSubsystem* Thermo,
                             const UAISenseConfig_Thermal& Cfg,
                             const FVector& ListenerLoc,
+                            TArray<FThermoQueryCursor>& Cursors,
                             float& OutBestTempC,
                             FVector& OutBestLoc)
 {
@@ -161,15 +163,53 @@ static bool ProbeThermoRing(UWorld& World,
     const int32 N1 = 16;
     const int32 N2 = 24;
 
+    // Slots: 2 gradient samples, then ring 1, then ring 2
+    Cursors.SetNum(2 + N1 + N2);
+    int32 Slot = 0;
+
     bool bFound = false;
     float BestT = -FLT_MAX;
     FVector BestP = ListenerLoc;
 
-    auto SampleRing = [&](float Radius, int32 Count)
+    // Uphill along the horizontal gradient: one analytic query + a sample per ring radius
+    if (Cfg.bUseGradientProbe)
+    {
+        FVector Grad;
+        Thermo->ComputeTemperatureGradientAt(ListenerLoc, Grad);
+        const FVector Dir = FVector(Grad.X, Grad.Y, 0.f).GetSafeNormal(1e-10f);
+        if (!Dir.IsZero())
+        {
+            for (const float Radius : { R1, R2 })
+            {
+                FThermoQueryCursor& Cursor = Cursors[Slot++];
+                if (Radius <= 1.f) continue;
+                const FVector P = ListenerLoc + Dir * Radius;
+                if (!HasLineOfSightMulti(World, Cfg, ListenerLoc, P, {}))
+                    continue;
+
+                const float T = Thermo->ComputeTemperatureNow(P, Cursor);
+                if (T > BestT)
+                {
+                    BestT = T;
+                    BestP = P;
+                    bFound = true;
+                }
+            }
+            if (bFound)
+            {
+                OutBestTempC = BestT;
+                OutBestLoc   = BestP;
+                return true;
+            }
+        }
+    }
+
+    auto SampleRing = [&](float Radius, int32 Count, int32 FirstSlot)
     {
         if (Radius <= 1.f || Count <= 0) return;
         for (int32 i = 0; i < Count; ++i)
         {
+            FThermoQueryCursor& Cursor = Cursors[FirstSlot + i];
             const float Ang = (2.f * PI) * (float(i) / float(Count));
             const FVector2D D2(FMath::Cos(Ang), FMath::Sin(Ang));
             const FVector P = ListenerLoc + FVector(D2.X * Radius, D2.Y * Radius, 0.f);
@@ -178,7 +218,7 @@ static bool ProbeThermoRing(UWorld& World,
             if (!HasLineOfSightMulti(World, Cfg, ListenerLoc, P, {}))
                 continue;
 
-            const float T = Thermo->ComputeCurrentTemperatureAt(P, /*bWinter=*/false, /*TimeHours=*/12.f, /*WeatherAlpha01=*/0.3f);
+            const float T = Thermo->ComputeTemperatureNow(P, Cursor);
             if (T > BestT)
             {
                 BestT = T;
@@ -197,8 +237,8 @@ static bool ProbeThermoRing(UWorld& World,
         }
     };
 
-    SampleRing(R1, N1);
-    SampleRing(R2, N2);
+    SampleRing(R1, N1, 2);
+    SampleRing(R2, N2, 2 + N1);
 
     OutBestTempC = BestT;
     OutBestLoc   = BestP;
@@ -221,7 +261,7 @@ float UAISense_Thermal::Update()
     for (int32 i = ListenerComps.Num() - 1; i >= 0; --i)
     {
         UAIPerceptionComponent* Comp = ListenerComps[i].Get();
-        if (!Comp) { ListenerComps.RemoveAtSwap(i); continue; }
+        if (!Comp) { ListenerCursors.Remove(ListenerComps[i]); ListenerComps.RemoveAtSwap(i); continue; }
         if (!Comp->IsSenseEnabled(UAISense_Thermal::StaticClass())) continue;
 
         const UAISenseConfig_Thermal* Cfg = Cast<UAISenseConfig_Thermal>(Comp->GetSenseConfig(GetSenseID()));
@@ -237,7 +277,7 @@ float UAISense_Thermal::Update()
         // Probe the grid around the listener and pick the hottest visible point
         float BestTempC = -FLT_MAX;
         FVector BestLoc = L;
-        const bool bAny = ProbeThermoRing(*World, Thermo, *Cfg, L, BestTempC, BestLoc);
+        const bool bAny = ProbeThermoRing(*World, Thermo, *Cfg, L, ListenerCursors.FindOrAdd(Comp), BestTempC, BestLoc);
 
         if (bAny)
         {
@@ -296,7 +336,7 @@ float UAISense_Thermal::Update()
             float EventTempC = E.TemperatureC;
             if (Thermo)
             {
-                const float GridC = Thermo->ComputeCurrentTemperatureAt(E.Location, /*bWinter=*/false, /*TimeHours=*/12.f, /*WeatherAlpha01=*/0.3f);
+                const float GridC = Thermo->ComputeTemperatureNow(E.Location);
                 EventTempC = FMath::Max(EventTempC, GridC);
             }
 
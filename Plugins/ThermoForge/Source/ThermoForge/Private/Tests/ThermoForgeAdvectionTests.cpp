@@ -0,0 +1,81 @@
+﻿#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ThermoForgeDiffusion.h"
+#include "ThermoForgeTestFields.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeAdvectionMaskTest, "ThermoForge.Diffusion.AdvectionSkyMask",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// Wind carries heat under open sky and leaves enclosed cells alone, for the uniform wind and a coarse wind field
+bool FThermoForgeAdvectionMaskTest::RunTest(const FString& Parameters)
+{
+    const FIntVector Dim(16, 6, 4);
+    UThermoForgeFieldAsset* Field = TF_MakeTestField(Dim, 49);
+
+    // Unrotated, walls fully closed (no conduction), enclosed for x < 8 and open sky beyond
+    const int32 Open = Dim.X / 2;
+    Field->GridRotation = FRotator::ZeroRotator;
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    for (int32 x=0; x<Dim.X; ++x)
+    {
+        const int32 i = Field->Index(x,y,z);
+        Field->SkyView01[i]          = x >= Open ? 1.f : 0.f;
+        Field->WallPermeability01[i] = 0.f;
+        Field->Indoorness01[i]       = 1.f - Field->SkyView01[i];
+    }
+    Field->RebuildDerivedData();
+
+    // A ramp of 1 °C per cell along X: the upwind read of a +X wind is exactly x minus the displacement
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    TArray<float> Ramp;
+    Ramp.SetNumUninitialized(N);
+    for (int32 i=0; i<N; ++i) Ramp[i] = float(i % Dim.X);
+
+    FThermoForgeDiffusionGrid::FParams Params;
+    Params.DiffusivityCm2PerSec = 0.f;
+    Params.ExchangeSeconds      = 1e6f;
+    Params.StepSeconds          = 0.1f;
+    Params.MaxStepsPerAdvance   = 4;
+
+    const float WindCmPerSec = 100.f;
+    TSharedPtr<FThermoWindField> WindField = MakeShared<FThermoWindField>();
+    WindField->WindDim = FIntVector(2, 2, 2);
+    WindField->WindCmPerSec.Init(FVector3f(WindCmPerSec, 0.f, 0.f), 8);
+
+    struct FCase { const TCHAR* Name; FVector Uniform; TSharedPtr<const FThermoWindField> Coarse; };
+    const FCase Cases[] =
+    {
+        { TEXT("Uniform wind"), FVector(WindCmPerSec, 0.0, 0.0), nullptr },
+        { TEXT("Wind field"),   FVector::ZeroVector,             WindField },
+    };
+
+    for (const FCase& Case : Cases)
+    {
+        FThermoForgeDiffusionGrid Grid;
+        Grid.Init(Field, 1, Ramp);
+        Grid.SetWind(Case.Uniform, Case.Coarse);
+
+        const int32 Steps = Grid.Advance(0.4f, Params, Ramp);
+        if (!TestTrue(FString::Printf(TEXT("%s: steps taken"), Case.Name), Steps > 0)) return false;
+        const float Shift = WindCmPerSec / Field->CellSizeCm * Params.StepSeconds * Steps;
+
+        TArray<float> T;
+        Grid.CopyTemperatures(T);
+        float WorstEnclosed = 0.f, WorstOpen = 0.f;
+        for (int32 i=0; i<N; ++i)
+        {
+            // The kink at the mask edge spreads one open column per pass; past that the ramp is intact
+            const int32 x = i % Dim.X;
+            if (x < Open)               WorstEnclosed = FMath::Max(WorstEnclosed, FMath::Abs(T[i] - Ramp[i]));
+            else if (x >= Open + Steps) WorstOpen     = FMath::Max(WorstOpen, FMath::Abs(T[i] - (Ramp[i] - Shift)));
+        }
+        TestTrue(FString::Printf(TEXT("%s: enclosed cells hold still (worst %.5f)"), Case.Name, WorstEnclosed), WorstEnclosed < 1e-3f);
+        TestTrue(FString::Printf(TEXT("%s: open cells drift downwind by %.2f cells (worst %.5f)"), Case.Name, Shift, WorstOpen), WorstOpen < 1e-3f);
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
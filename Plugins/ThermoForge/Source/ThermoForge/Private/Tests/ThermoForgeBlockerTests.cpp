@@ -0,0 +1,85 @@
+﻿#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ThermoForgeSnapshot.h"
+#include "ThermoForgeTestFields.h"
+#include "ThermoForgeTestWorld.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeBlockerOverrideTest, "ThermoForge.Blockers.OverrideLayer",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// A blocker's override reaches its own world's snapshot as it opens, closes and goes away, and never the shared asset or another world
+bool FThermoForgeBlockerOverrideTest::RunTest(const FString& Parameters)
+{
+    const FIntVector Dim(8, 8, 4);
+    UThermoForgeFieldAsset* Field = TF_MakeTestField(Dim, 50, 0.25f);
+    const FTransform Frame = Field->GetGridFrame();
+    const float Cell = Field->CellSizeCm;
+
+    // Two worlds on one asset, like the editor world and a PIE world
+    FThermoForgeTestWorld WorldA, WorldB;
+    const FVector Center = Frame.TransformPosition(FVector(Dim) * (0.5 * Cell));
+    WorldA.SpawnVolume(Field, Center, FVector(400.0));
+    WorldB.SpawnVolume(Field, Center, FVector(400.0));
+    UThermoForgeSubsystem* SubA = WorldA.GetSubsystem();
+    UThermoForgeSubsystem* SubB = WorldB.GetSubsystem();
+    if (!TestNotNull(TEXT("Subsystem A"), SubA) || !TestNotNull(TEXT("Subsystem B"), SubB)) return false;
+
+    // An interior cell the bake left mostly closed; the empty world traces it fully open
+    int32 Linear = INDEX_NONE;
+    FIntVector Picked;
+    for (int32 z=1; z<Dim.Z-1 && Linear == INDEX_NONE; ++z)
+    for (int32 y=1; y<Dim.Y-1 && Linear == INDEX_NONE; ++y)
+    for (int32 x=1; x<Dim.X-1 && Linear == INDEX_NONE; ++x)
+    {
+        if (Field->WallPermeability01[Field->Index(x,y,z)] <= 0.5f)
+        {
+            Linear = Field->Index(x,y,z);
+            Picked = FIntVector(x, y, z);
+        }
+    }
+    if (!TestTrue(TEXT("Found a closed interior cell"), Linear != INDEX_NONE)) return false;
+
+    const float Baked = Field->WallPermeability01[Linear];
+    const TArray<float> BakedChannel = Field->WallPermeability01;
+    const FVector CellCenter = Frame.TransformPosition((FVector(Picked) + FVector(0.5)) * Cell);
+
+    auto SnapshotPerm = [Linear](const UThermoForgeSubsystem* Sub)
+    {
+        const TSharedPtr<const FThermoForgeSnapshot> Snap = Sub->GetSnapshot();
+        return (Snap && Snap->Volumes.Num() > 0 && Snap->Volumes[0].Field) ? Snap->Volumes[0].Field->WallAt(Linear) : -1.f;
+    };
+    // Tracing runs under a per-frame budget, so tick until the snapshot shows Expected
+    auto TickUntil = [&SnapshotPerm](UThermoForgeSubsystem* Sub, float Expected)
+    {
+        for (int32 i=0; i<200; ++i)
+        {
+            Sub->Tick(0.f);
+            if (FMath::IsNearlyEqual(SnapshotPerm(Sub), Expected, 1e-4f)) return true;
+        }
+        return false;
+    };
+
+    SubA->Tick(0.f);
+    SubB->Tick(0.f);
+    TestEqual(TEXT("Baked before any blocker"), SnapshotPerm(SubA), Baked, 1e-4f);
+
+    const int32 Id = SubA->AddDynamicBlockerBox(FBox::BuildAABB(CellCenter, FVector(5.0)), 1.f);
+    if (!TestTrue(TEXT("Blocker added"), Id > 0)) return false;
+
+    TestTrue(TEXT("Open blocker reaches the snapshot"), TickUntil(SubA, 1.f));
+    SubB->Tick(0.f);
+    TestEqual(TEXT("Other world keeps the bake"), SnapshotPerm(SubB), Baked, 1e-4f);
+    TestTrue(TEXT("Asset untouched while open"), Field->WallPermeability01 == BakedChannel);
+
+    SubA->SetDynamicBlockerOpen(Id, 0.5f);
+    TestTrue(TEXT("Half-open blocker re-blends the override"), TickUntil(SubA, Baked + 0.5f * (1.f - Baked)));
+
+    SubA->RemoveDynamicBlocker(Id);
+    TestTrue(TEXT("Removed blocker restores the bake"), TickUntil(SubA, Baked));
+    TestTrue(TEXT("Asset untouched after removal"), Field->WallPermeability01 == BakedChannel);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
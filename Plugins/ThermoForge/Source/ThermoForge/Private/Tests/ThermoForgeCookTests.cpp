@@ -0,0 +1,87 @@
+﻿#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "ThermoForgeTestFields.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeCookedFieldTest, "ThermoForge.Field.CookedRoundTrip",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// Cook a field, decode the payload into a fresh asset and check every value; then corrupt it and expect a rejection
+// (channels or pyramid bounds) or a rebuilt pyramid (pyramid layout)
+bool FThermoForgeCookedFieldTest::RunTest(const FString& Parameters)
+{
+    const FIntVector Dim(13, 10, 7);
+    UThermoForgeFieldAsset* Source = TF_MakeTestField(Dim, 2024);
+
+    Source->BuildCookedField();
+    const FThermoForgeCookedField Cooked = Source->CookedField;
+    if (!TestTrue(TEXT("Payload built"), Cooked.bValid)) return false;
+    TestFalse(TEXT("Indoorness dropped (matches the bake formula)"), Cooked.bHasIndoorness);
+    TestTrue(TEXT("Verified error within tolerance"), Cooked.MaxError <= UThermoForgeFieldAsset::CookTolerance);
+
+    auto Decode = [](const FThermoForgeCookedField& Payload, const FIntVector& AsDim)
+    {
+        UThermoForgeFieldAsset* Loaded = NewObject<UThermoForgeFieldAsset>(GetTransientPackage());
+        Loaded->Dim = AsDim;
+        Loaded->CookedField = Payload;
+        return Loaded->DecodeCookedField() ? Loaded : nullptr;
+    };
+
+    const UThermoForgeFieldAsset* Loaded = Decode(Cooked, Dim);
+    if (!TestNotNull(TEXT("Payload decodes"), Loaded)) return false;
+    TestTrue(TEXT("Pyramid restored"), Loaded->HasSkyViewHierarchy());
+    TestTrue(TEXT("Dropped Indoorness stays derived, not materialised"), Loaded->IsIndoornessDerived() && Loaded->Indoorness01.Num() == 0);
+
+    // Decoded values are exactly the uint16 lattice point nearest the editor value
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    int32 NumWrong = 0;
+    for (int32 i=0; i<N; ++i)
+    {
+        const float Sky  = float(FMath::RoundToInt(Source->SkyView01[i] * 65535.f)) / 65535.f;
+        const float Wall = float(FMath::RoundToInt(Source->WallPermeability01[i] * 65535.f)) / 65535.f;
+        if (Loaded->SkyView01[i] != Sky || Loaded->WallPermeability01[i] != Wall
+            || Loaded->GetIndoorByLinearIdx(i) != (1.f - Sky) * (1.f - Wall))
+        {
+            ++NumWrong;
+        }
+    }
+    TestEqual(TEXT("Cells decoded off the quantisation lattice"), NumWrong, 0);
+
+    // One flipped bit must fail the checksum
+    FThermoForgeCookedField Corrupt = Cooked;
+    Corrupt.Quantized[Corrupt.Quantized.Num() / 2] ^= 0x0100;
+    AddExpectedError(TEXT("checksum mismatch"), EAutomationExpectedErrorFlags::Contains, 1);
+    TestNull(TEXT("Corrupt payload rejected"), Decode(Corrupt, Dim));
+
+    // The checksum covers the pyramid as well: a tampered bound would let the search prune live cells
+    FThermoForgeCookedField BadBounds = Cooked;
+    BadBounds.SkyViewHierarchy.Last().Max[0] = -1.f;
+    AddExpectedError(TEXT("checksum mismatch"), EAutomationExpectedErrorFlags::Contains, 1);
+    TestNull(TEXT("Corrupt pyramid rejected"), Decode(BadBounds, Dim));
+
+    // A pyramid whose layout doesn't follow the grid is rebuilt rather than trusted, even with a matching checksum
+    FThermoForgeCookedField BadLayout = Cooked;
+    BadLayout.SkyViewHierarchy.Pop();
+    BadLayout.Checksum = UThermoForgeFieldAsset::ComputeCookedChecksum(BadLayout);
+    if (UThermoForgeFieldAsset* Rebuilt = Decode(BadLayout, Dim))
+    {
+        TestTrue(TEXT("Short pyramid rebuilt"), Rebuilt->HasSkyViewHierarchy());
+        TestEqual(TEXT("Rebuilt pyramid has every level"), Rebuilt->SkyViewHierarchy.Num(), Cooked.SkyViewHierarchy.Num());
+
+        // Every level is checked, not just the finest
+        Rebuilt->SkyViewHierarchy[1].Min.Pop();
+        TestFalse(TEXT("Truncated upper level detected"), Rebuilt->HasSkyViewHierarchy());
+    }
+    else
+    {
+        AddError(TEXT("Payload with a short pyramid did not decode"));
+    }
+
+    // A payload for another grid must not be read with the wrong layout
+    AddExpectedError(TEXT("does not match grid"), EAutomationExpectedErrorFlags::Contains, 1);
+    TestNull(TEXT("Mismatched grid rejected"), Decode(Cooked, FIntVector(Dim.X, Dim.Y, Dim.Z + 1)));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
@@ -0,0 +1,77 @@
+﻿#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ThermoForgeFieldPatch.h"
+#include "ThermoForgeTestFields.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeFieldPatchTest, "ThermoForge.Field.PatchDiffApply",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// Diff a rebake against its base, ship the patch through an archive and apply it to a copy of the base
+bool FThermoForgeFieldPatchTest::RunTest(const FString& Parameters)
+{
+    const FIntVector Dim(20, 13, 9); // 3 x 2 x 2 tiles, clipped on every axis
+    constexpr float Tolerance = 1e-4f;
+    const UThermoForgeFieldAsset* Base = TF_MakeTestField(Dim, 5);
+
+    TArray<float> Sky    = Base->SkyView01;
+    TArray<float> Wall   = Base->WallPermeability01;
+    TArray<float> Indoor = Base->Indoorness01;
+
+    // Three tiles change, one of them only in a clipped corner cell
+    Sky[Base->Index(1, 2, 3)]      = 0.25f;
+    Wall[Base->Index(9, 12, 0)]    = 0.75f;
+    Indoor[Base->Index(19, 12, 8)] = 0.5f;
+    // A change below the tolerance in an otherwise untouched tile is not a patch
+    const int32 Quiet = Base->Index(10, 0, 8);
+    Sky[Quiet] += 0.5f * Tolerance;
+
+    FThermoForgeFieldPatch Patch;
+    const bool bDiffed = FThermoForgeFieldPatch::Diff(*Base, Base->Dim, Base->CellSizeCm, Base->OriginWS, Base->GridRotation,
+        Sky, Wall, Indoor, Tolerance, Patch);
+    if (!TestTrue(TEXT("Same grid diffs"), bDiffed)) return false;
+    TestEqual(TEXT("Dirty tiles"), Patch.Tiles.Num(), 3);
+
+    int64 ExpectCells = 0;
+    for (const FThermoForgeFieldPatchTile& T : Patch.Tiles)
+    {
+        FIntVector Min, Max;
+        Patch.TileRange(T.Tile, Min, Max);
+        ExpectCells += int64(Max.X - Min.X) * (Max.Y - Min.Y) * (Max.Z - Min.Z);
+    }
+    TestEqual(TEXT("Cells carried"), Patch.NumCells(), ExpectCells);
+
+    // Through the .tfpatch encoding
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    Patch.Serialize(Writer);
+    FThermoForgeFieldPatch Loaded;
+    FMemoryReader Reader(Bytes);
+    Loaded.Serialize(Reader);
+    if (!TestFalse(TEXT("Patch reads back"), Reader.IsError())) return false;
+
+    UThermoForgeFieldAsset* Target = TF_MakeTestField(Dim, 5);
+    if (!TestTrue(TEXT("Patch applies"), Target->ApplyPatch(Loaded))) return false;
+
+    // Everything but the quiet cell now matches the rebake exactly
+    Sky[Quiet] = Base->SkyView01[Quiet];
+    TestTrue(TEXT("SkyView01 matches the rebake"), Target->SkyView01 == Sky);
+    TestTrue(TEXT("WallPermeability01 matches the rebake"), Target->WallPermeability01 == Wall);
+    TestTrue(TEXT("Indoorness01 matches the rebake"), Target->Indoorness01 == Indoor);
+    TestTrue(TEXT("Derived data rebuilt"), Target->HasSkyViewHierarchy());
+
+    // Another grid needs a full rebake, and a patch never lands on a field it wasn't made for
+    FThermoForgeFieldPatch Other;
+    TestFalse(TEXT("Resized grid does not diff"), FThermoForgeFieldPatch::Diff(*Base, FIntVector(Dim.X + 1, Dim.Y, Dim.Z),
+        Base->CellSizeCm, Base->OriginWS, Base->GridRotation, Sky, Wall, Indoor, Tolerance, Other));
+
+    UThermoForgeFieldAsset* Moved = TF_MakeTestField(Dim, 5);
+    Moved->OriginWS += FVector(100.0, 0.0, 0.0);
+    TestFalse(TEXT("Patch rejected by a moved field"), Moved->ApplyPatch(Loaded));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
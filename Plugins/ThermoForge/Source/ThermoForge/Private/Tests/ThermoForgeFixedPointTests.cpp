@@ -0,0 +1,170 @@
+﻿#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ThermoForgeFixedPoint.h"
+#include "ThermoForgeClimate.h"
+#include "ThermoForgeSourceComponent.h"
+#include "ThermoForgeTestFields.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeFixedPointTest, "ThermoForge.Diffusion.FixedPointChecksum",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// Two grids fed the same inputs stay bit-identical step after step; different inputs show in the checksum
+bool FThermoForgeFixedPointTest::RunTest(const FString& Parameters)
+{
+    const FIntVector Dim(21, 17, 9);
+    const UThermoForgeFieldAsset* Field = TF_MakeTestField(Dim, 77);
+
+    FThermoClimateState Climate;
+    Climate.AmbientSeaLevelC = 14.5f;
+    Climate.SeaLevelZcm      = 0.f;
+    Climate.LapseCPerCm      = 0.0065f / 100.f;
+    Climate.SolarC           = 6.f; // varies the target with SkyView01, so diffusion has work to do
+    const FThermoFixedClimate Fixed = FThermoFixedClimate::FromClimate(Climate);
+
+    FThermoSourceShape Shape;
+    Shape.Transform        = FTransform(Field->GetGridFrame().TransformPosition(FVector(Dim) * (0.5 * Field->CellSizeCm)));
+    Shape.Shape            = EThermoSourceShape::Point;
+    Shape.IntensityCelsius = 30.f;
+    Shape.RadiusCm         = 300.f;
+
+    const FThermoForgeFixedGrid::FParams Params = FThermoForgeFixedGrid::FParams::Make(20000.f, 60.f, 1.f / 30.f, Field->CellSizeCm);
+
+    FThermoForgeFixedGrid A, B;
+    A.Init(Field, 1);
+    B.Init(Field, 1);
+
+    FThermoFixedSource Source;
+    if (!TestTrue(TEXT("Source reaches the grid"), A.MakeSource(Shape, Source))) return false;
+    const TArray<FThermoFixedSource> Sources = { Source };
+
+    A.Snap(Fixed, {});
+    B.Snap(Fixed, {});
+    TestEqual(TEXT("Checksum after Snap"), A.GetChecksum(), B.GetChecksum());
+
+    // Diffusion pulls the state off the snapped target, and the source switching on halfway moves it again
+    for (int32 s=0; s<50; ++s)
+    {
+        const TConstArrayView<FThermoFixedSource> Active = s < 25 ? TConstArrayView<FThermoFixedSource>() : TConstArrayView<FThermoFixedSource>(Sources);
+        const uint32 Before = A.GetChecksum();
+        A.Step(Fixed, Active, Params);
+        B.Step(Fixed, Active, Params);
+        if (!TestEqual(FString::Printf(TEXT("Checksum after step %d"), s + 1), A.GetChecksum(), B.GetChecksum())) return false;
+        if (s == 0 || s == 25)
+        {
+            TestNotEqual(FString::Printf(TEXT("State moves at step %d"), s + 1), A.GetChecksum(), Before);
+        }
+    }
+
+    // A degree of extra solar heating reaches every cell with sky
+    FThermoFixedClimate Warmer = Fixed;
+    Warmer.SolarQ += ThermoFixed::One;
+    FThermoForgeFixedGrid C;
+    C.Init(Field, 1);
+    C.Snap(Warmer, {});
+    A.Init(Field, 1);
+    A.Snap(Fixed, {});
+    TestNotEqual(TEXT("Different climate, different checksum"), C.GetChecksum(), A.GetChecksum());
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeFixedPointGoldenTest, "ThermoForge.Diffusion.FixedPointGolden",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// Unrotated field whose channels are exact binary fractions, so nothing platform-dependent precedes quantisation
+static UThermoForgeFieldAsset* TF_MakeGoldenField(const FIntVector& Dim)
+{
+    UThermoForgeFieldAsset* Field = NewObject<UThermoForgeFieldAsset>(GetTransientPackage());
+    Field->Dim        = Dim;
+    Field->CellSizeCm = 50.f;
+    Field->OriginWS   = FVector::ZeroVector;
+
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    Field->SkyView01.SetNumUninitialized(N);
+    Field->WallPermeability01.SetNumUninitialized(N);
+    Field->Indoorness01.SetNumUninitialized(N);
+    for (int32 i=0; i<N; ++i)
+    {
+        Field->SkyView01[i]          = float((i * 37 + 11) % 65) / 64.f;
+        Field->WallPermeability01[i] = float((i * 53 + 7) % 33) / 32.f;
+        Field->Indoorness01[i]       = (1.f - Field->SkyView01[i]) * (1.f - Field->WallPermeability01[i]);
+    }
+    Field->RebuildDerivedData();
+    return Field;
+}
+
+// The checksum after a fixed run is pinned, and peers that batch the same steps differently per frame agree with it
+bool FThermoForgeFixedPointGoldenTest::RunTest(const FString& Parameters)
+{
+    // Golden values from an independent reimplementation of the integer pipeline; a change here is a desync
+    constexpr uint32 GoldenSnap   = 0x9DC8A465u;
+    constexpr uint32 GoldenSteps  = 0x14CB04D0u;
+    constexpr int32  NumSteps     = 40;
+
+    const UThermoForgeFieldAsset* Field = TF_MakeGoldenField(FIntVector(12, 10, 6));
+
+    FThermoFixedClimateModel Model;
+    Model.WinterAvgQ     = 5  * ThermoFixed::One;
+    Model.SummerAvgQ     = 28 * ThermoFixed::One;
+    Model.WinterDeltaQ   = 8  * ThermoFixed::One;
+    Model.SummerDeltaQ   = 10 * ThermoFixed::One;
+    Model.PeakTicks      = 15 * ETimespan::TicksPerHour;
+    Model.LapsePerMetreQ = 655; // 0.01 °C/m
+    Model.SeaLevelZ8     = 0;
+    Model.SolarScaleQ    = 6 * ThermoFixed::One;
+    const int32 WeatherQ = ThermoFixed::FromFloat(0.3f);
+
+    // Midsummer dawn, ten game minutes per step: the diurnal curve climbs over the run
+    const int64 StartTicks = FDateTime(2025, 6, 21, 6).GetTicks();
+    const int64 StepTicks  = 600 * ETimespan::TicksPerSecond;
+
+    FThermoForgeFixedGrid::FParams Params;
+    Params.RQ    = ThermoFixed::One / 16;
+    Params.KQ    = ThermoFixed::One / 64;
+    Params.Split = 2;
+
+    FThermoSourceShape Shape;
+    Shape.Transform        = FTransform(FVector(275.0, 225.0, 125.0)); // centre of cell (5,4,2)
+    Shape.Shape            = EThermoSourceShape::Point;
+    Shape.Falloff          = EThermoSourceFalloff::InverseSquare;
+    Shape.IntensityCelsius = 30.f;
+    Shape.RadiusCm         = 150.f;
+
+    struct FPeer
+    {
+        FThermoForgeFixedGrid Grid;
+        int64 ClockTicks = 0;
+    };
+    FPeer A, B;
+    FThermoFixedSource Source;
+    for (FPeer* Peer : { &A, &B })
+    {
+        Peer->Grid.Init(Field, 1);
+        if (!TestTrue(TEXT("Source reaches the grid"), Peer->Grid.MakeSource(Shape, Source))) return false;
+        Peer->Grid.Snap(Model.At(StartTicks, WeatherQ), MakeArrayView(&Source, 1));
+    }
+    TestEqual(TEXT("Golden checksum after Snap"), A.Grid.GetChecksum(), GoldenSnap);
+
+    // As AdvanceFixedGrids: each step reads the climate at its own clock reading
+    auto Advance = [&](FPeer& Peer, int32 Steps)
+    {
+        for (int32 s=0; s<Steps; ++s)
+        {
+            Peer.Grid.Step(Model.At(StartTicks + Peer.ClockTicks, WeatherQ), MakeArrayView(&Source, 1), Params);
+            Peer.ClockTicks += StepTicks;
+        }
+    };
+
+    // A: one step per frame. B: long frames catch up several steps at once.
+    for (int32 f=0; f<NumSteps; ++f) Advance(A, 1);
+    const int32 Batches[] = { 3, 1, 7, 2, 5, 1, 1, 8, 4, 6, 2 };
+    for (const int32 Steps : Batches) Advance(B, Steps);
+
+    TestEqual(TEXT("Both peers took the same steps"), B.ClockTicks, A.ClockTicks);
+    TestEqual(TEXT("Golden checksum after the run"), A.Grid.GetChecksum(), GoldenSteps);
+    TestEqual(TEXT("Frame batching does not change the checksum"), B.Grid.GetChecksum(), A.Grid.GetChecksum());
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
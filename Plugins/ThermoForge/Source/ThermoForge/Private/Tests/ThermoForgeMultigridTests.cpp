@@ -0,0 +1,100 @@
+﻿#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ThermoForgeMultigrid.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeMultigridTest, "ThermoForge.Diffusion.MultigridEquilibrium",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// The V-cycles must hit the tolerance they report, and land on the solution a plain double Gauss-Seidel finds.
+// The operator has unit row sums and a non-negative stencil, so the error is bounded by the max-norm residual.
+bool FThermoForgeMultigridTest::RunTest(const FString& Parameters)
+{
+    const FIntVector Dim(23, 19, 11); // odd on every axis, so coarsening rounds up
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    const int32 SY = Dim.X, SZ = Dim.X * Dim.Y;
+    const float Beta = 2.5f;
+    auto Index = [&Dim](int32 x, int32 y, int32 z) { return (z * Dim.Y + y) * Dim.X + x; };
+
+    FRandomStream Rng(42);
+    TArray<float> Gx, Gy, Gz, B;
+    Gx.SetNumZeroed(N); Gy.SetNumZeroed(N); Gz.SetNumZeroed(N); B.SetNumUninitialized(N);
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    for (int32 x=0; x<Dim.X; ++x)
+    {
+        const int32 i = Index(x,y,z);
+        if (x+1 < Dim.X) Gx[i] = Rng.GetFraction();
+        if (y+1 < Dim.Y) Gy[i] = Rng.GetFraction();
+        if (z+1 < Dim.Z) Gz[i] = Rng.GetFraction();
+        B[i] = Rng.FRandRange(0.f, 40.f);
+    }
+
+    FThermoForgeMultigrid Solver;
+    Solver.Build(Dim, Gx, Gy, Gz, Beta);
+    TestTrue(TEXT("Coarse levels built"), Solver.GetNumLevels() > 1);
+
+    FThermoMultigridParams Params;
+    Params.ToleranceC = 1e-3f;
+    Params.MaxCycles  = 40;
+    TArray<float> X;
+    float Reported = -1.f;
+    const int32 Cycles = Solver.Solve(B, X, Params, &Reported);
+    if (!TestEqual(TEXT("Solution size"), X.Num(), N)) return false;
+    TestTrue(TEXT("Converged before MaxCycles"), Cycles > 0 && Cycles < Params.MaxCycles);
+    TestTrue(TEXT("Reported residual within tolerance"), Reported >= 0.f && Reported <= Params.ToleranceC);
+
+    // Residual and reference solution computed here, in double: Σ G_f and Σ G_f · V_n over the faces of a cell
+    auto Faces = [&](const auto& V, int32 x, int32 y, int32 z, double& OutSumG, double& OutSumGV)
+    {
+        const int32 i = Index(x,y,z);
+        OutSumG = 0.0; OutSumGV = 0.0;
+        if (x+1 < Dim.X) { OutSumG += Gx[i];      OutSumGV += double(Gx[i])      * V[i + 1];  }
+        if (x > 0)       { OutSumG += Gx[i - 1];  OutSumGV += double(Gx[i - 1])  * V[i - 1];  }
+        if (y+1 < Dim.Y) { OutSumG += Gy[i];      OutSumGV += double(Gy[i])      * V[i + SY]; }
+        if (y > 0)       { OutSumG += Gy[i - SY]; OutSumGV += double(Gy[i - SY]) * V[i - SY]; }
+        if (z+1 < Dim.Z) { OutSumG += Gz[i];      OutSumGV += double(Gz[i])      * V[i + SZ]; }
+        if (z > 0)       { OutSumG += Gz[i - SZ]; OutSumGV += double(Gz[i - SZ]) * V[i - SZ]; }
+    };
+
+    double MaxResidual = 0.0;
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    for (int32 x=0; x<Dim.X; ++x)
+    {
+        const int32 i = Index(x,y,z);
+        double SumG, SumGV;
+        Faces(X, x, y, z, SumG, SumGV);
+        const double R = B[i] - (X[i] + Beta * (SumG * X[i] - SumGV));
+        MaxResidual = FMath::Max(MaxResidual, FMath::Abs(R));
+    }
+    TestTrue(FString::Printf(TEXT("Equation residual %.2e within tolerance"), MaxResidual), MaxResidual <= 2e-3);
+
+    TArray<double> Ref;
+    Ref.SetNumUninitialized(N);
+    for (int32 i=0; i<N; ++i) Ref[i] = B[i];
+    for (int32 Sweep=0; Sweep<5000; ++Sweep)
+    {
+        double MaxStep = 0.0;
+        for (int32 z=0; z<Dim.Z; ++z)
+        for (int32 y=0; y<Dim.Y; ++y)
+        for (int32 x=0; x<Dim.X; ++x)
+        {
+            const int32 i = Index(x,y,z);
+            double SumG, SumGV;
+            Faces(Ref, x, y, z, SumG, SumGV);
+            const double Next = (B[i] + Beta * SumGV) / (1.0 + Beta * SumG);
+            MaxStep = FMath::Max(MaxStep, FMath::Abs(Next - Ref[i]));
+            Ref[i] = Next;
+        }
+        if (MaxStep < 1e-9) break;
+    }
+
+    double MaxError = 0.0;
+    for (int32 i=0; i<N; ++i) MaxError = FMath::Max(MaxError, FMath::Abs(X[i] - Ref[i]));
+    TestTrue(FString::Printf(TEXT("Error against Gauss-Seidel %.2e within tolerance"), MaxError), MaxError <= 3e-3);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,57 @@
+﻿#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ThermoForgeTestFields.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeExtremePruningTest, "ThermoForge.Field.ExtremeSearchMatchesScan",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// The pyramid descent must return exactly what the flat scan returns, ties included
+bool FThermoForgeExtremePruningTest::RunTest(const FString& Parameters)
+{
+    const FIntVector Dim(37, 29, 11); // not a multiple of the brick size on any axis
+    const UThermoForgeFieldAsset* Pruned = TF_MakeTestField(Dim, 1234);
+    if (!TestTrue(TEXT("Pyramid built"), Pruned->HasSkyViewHierarchy())) return false;
+
+    // Same channels without derived data: FindExtremeCell falls back to the flat scan
+    UThermoForgeFieldAsset* Scan = NewObject<UThermoForgeFieldAsset>(GetTransientPackage());
+    Scan->Dim                = Pruned->Dim;
+    Scan->CellSizeCm         = Pruned->CellSizeCm;
+    Scan->OriginWS           = Pruned->OriginWS;
+    Scan->GridRotation       = Pruned->GridRotation;
+    Scan->SkyView01          = Pruned->SkyView01;
+    Scan->WallPermeability01 = Pruned->WallPermeability01;
+    Scan->Indoorness01       = Pruned->Indoorness01;
+    if (!TestFalse(TEXT("Scan copy has no pyramid"), Scan->HasSkyViewHierarchy())) return false;
+
+    FRandomStream Rng(99);
+    for (int32 q=0; q<96; ++q)
+    {
+        FThermoBakedExtremeQuery Query;
+        Query.CenterCell  = FIntVector(Rng.RandRange(-4, Dim.X + 3), Rng.RandRange(-4, Dim.Y + 3), Rng.RandRange(-2, Dim.Z + 1));
+        Query.RadiusCells = Rng.RandRange(0, 24);
+        Query.bHottest    = (q & 1) == 0;
+        Query.Model.AmbientSeaLevelC = 15.f;
+        Query.Model.SeaLevelZcm      = 0.f;
+        Query.Model.LapseCPerCm      = (q & 2) ? 0.0065f / 100.f : 0.f;
+        // Every fourth query has no solar term: whole layers tie and the lowest linear index must win
+        Query.Model.SolarC           = (q % 4 == 3) ? 0.f : Rng.FRandRange(1.f, 20.f);
+
+        FIntVector CellA, CellB;
+        float TempA = 0.f, TempB = 0.f;
+        const bool bFoundA = Pruned->FindExtremeCell(Query, CellA, TempA);
+        const bool bFoundB = Scan->FindExtremeCell(Query, CellB, TempB);
+
+        const FString What = FString::Printf(TEXT("Query %d (center %s, radius %d)"), q, *Query.CenterCell.ToString(), Query.RadiusCells);
+        TestEqual(What + TEXT(" found"), bFoundA, bFoundB);
+        if (bFoundA && bFoundB)
+        {
+            TestTrue(What + FString::Printf(TEXT(" cell %s == %s"), *CellA.ToString(), *CellB.ToString()), CellA == CellB);
+            TestTrue(What + FString::Printf(TEXT(" temp %.6f == %.6f"), TempA, TempB), TempA == TempB);
+        }
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,55 @@
+﻿#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ThermoForgeTestFields.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeSummedVolumeTest, "ThermoForge.Field.SummedVolumeMatchesLoop",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// Channels on a 1/256 lattice are exact in the 24-bit fixed point, so table and loop must agree bit for bit
+bool FThermoForgeSummedVolumeTest::RunTest(const FString& Parameters)
+{
+    const FIntVector Dim(23, 17, 9);
+    UThermoForgeFieldAsset* Field = TF_MakeTestField(Dim, 42, 1.f / 256.f);
+
+    // Tables are built on first use, per channel
+    Field->bBuildSummedVolumeTables = true;
+    TestFalse(TEXT("No table before a query"), Field->HasSummedVolumeTable(EThermoFieldChannel::SkyView));
+    Field->SumChannelInBox(EThermoFieldChannel::SkyView, FIntVector::ZeroValue, Dim);
+    TestTrue(TEXT("SkyView table built by its query"), Field->HasSummedVolumeTable(EThermoFieldChannel::SkyView));
+    TestFalse(TEXT("WallPermeability table not built"), Field->HasSummedVolumeTable(EThermoFieldChannel::WallPermeability));
+
+    const EThermoFieldChannel Channels[] = { EThermoFieldChannel::SkyView, EThermoFieldChannel::WallPermeability };
+
+    FRandomStream Rng(7);
+    for (int32 b=0; b<128; ++b)
+    {
+        // Boxes may reach outside the grid or be inverted; both paths clamp the same way
+        const FIntVector A(Rng.RandRange(-3, Dim.X + 2), Rng.RandRange(-3, Dim.Y + 2), Rng.RandRange(-3, Dim.Z + 2));
+        const FIntVector B(Rng.RandRange(-3, Dim.X + 2), Rng.RandRange(-3, Dim.Y + 2), Rng.RandRange(-3, Dim.Z + 2));
+
+        for (EThermoFieldChannel Channel : Channels)
+        {
+            Field->bBuildSummedVolumeTables = true;
+            const float SumTable = Field->SumChannelInBox(Channel, A, B);
+            const float AvgTable = Field->AverageChannelInBox(Channel, A, B);
+
+            Field->bBuildSummedVolumeTables = false;
+            const float SumLoop = Field->SumChannelInBox(Channel, A, B);
+            const float AvgLoop = Field->AverageChannelInBox(Channel, A, B);
+
+            const FString What = FString::Printf(TEXT("Box %d channel %d [%s, %s]"), b, int32(Channel), *A.ToString(), *B.ToString());
+            TestTrue(What + FString::Printf(TEXT(" sum %.6f == %.6f"), SumTable, SumLoop), SumTable == SumLoop);
+            TestTrue(What + FString::Printf(TEXT(" average %.6f == %.6f"), AvgTable, AvgLoop), AvgTable == AvgLoop);
+        }
+    }
+
+    // Rebuilding derived data drops the tables until the next query
+    Field->bBuildSummedVolumeTables = true;
+    Field->RebuildDerivedData();
+    TestFalse(TEXT("Tables dropped by RebuildDerivedData"), Field->HasSummedVolumeTable(EThermoFieldChannel::SkyView));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+#include "ThermoForgeFieldAsset.h"
+
+/**
+ * Transient field with reproducible channels for the automation tests: a smooth SkyView pattern plus noise
+ * (so the pyramid has something to prune), random WallPermeability and the bake's Indoorness formula.
+ * Quantum > 0 snaps Sky and Wall to multiples of it, for tests that need exact sums.
+ */
+inline UThermoForgeFieldAsset* TF_MakeTestField(const FIntVector& Dim, int32 Seed, float Quantum = 0.f)
+{
+    UThermoForgeFieldAsset* Field = NewObject<UThermoForgeFieldAsset>(GetTransientPackage());
+    Field->Dim          = Dim;
+    Field->CellSizeCm   = 50.f;
+    Field->OriginWS     = FVector(-300.0, 200.0, 100.0);
+    Field->GridRotation = FRotator(0.0, 30.0, 0.0);
+
+    auto Snap = [Quantum](float V)
+    {
+        V = FMath::Clamp(V, 0.f, 1.f);
+        return Quantum > 0.f ? FMath::RoundToFloat(V / Quantum) * Quantum : V;
+    };
+
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    Field->SkyView01.SetNumUninitialized(N);
+    Field->WallPermeability01.SetNumUninitialized(N);
+    Field->Indoorness01.SetNumUninitialized(N);
+
+    FRandomStream Rng(Seed);
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    for (int32 x=0; x<Dim.X; ++x)
+    {
+        const int32 i = Field->Index(x,y,z);
+        const float Pattern = 0.5f + 0.35f * FMath::Sin(x * 0.31f) * FMath::Cos(y * 0.23f + z * 0.5f);
+        Field->SkyView01[i]          = Snap(Pattern + Rng.FRandRange(-0.1f, 0.1f));
+        Field->WallPermeability01[i] = Snap(Rng.FRand());
+        Field->Indoorness01[i]       = (1.f - Field->SkyView01[i]) * (1.f - Field->WallPermeability01[i]);
+    }
+
+    Field->RebuildDerivedData();
+    return Field;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
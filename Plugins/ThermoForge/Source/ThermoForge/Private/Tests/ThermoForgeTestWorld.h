@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "ThermoForgeSubsystem.h"
+#include "ThermoForgeVolume.h"
+
+/**
+ * Transient game world for tests that need volumes or the subsystem; destroyed with the helper.
+ * Nothing ticks by itself: tests call the subsystem's Tick to advance it.
+ */
+class FThermoForgeTestWorld
+{
+public:
+    UE_NONCOPYABLE(FThermoForgeTestWorld);
+
+    FThermoForgeTestWorld()
+    {
+        World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld=*/false);
+        GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+    }
+
+    ~FThermoForgeTestWorld()
+    {
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(/*bInformEngineOfWorld=*/false);
+    }
+
+    UWorld* Get() const { return World; }
+    UThermoForgeSubsystem* GetSubsystem() const { return World->GetSubsystem<UThermoForgeSubsystem>(); }
+
+    /** Bounded, unrotated volume of Extent around Center with Field baked into it. */
+    AThermoForgeVolume* SpawnVolume(UThermoForgeFieldAsset* Field, const FVector& Center, const FVector& Extent, float BlendBorderCm = 0.f)
+    {
+        AThermoForgeVolume* Vol = World->SpawnActor<AThermoForgeVolume>(Center, FRotator::ZeroRotator);
+        Vol->BoxExtent     = Extent;
+        Vol->BlendBorderCm = BlendBorderCm;
+        Vol->SetBakedField(Field);
+        return Vol;
+    }
+
+private:
+    UWorld* World = nullptr;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
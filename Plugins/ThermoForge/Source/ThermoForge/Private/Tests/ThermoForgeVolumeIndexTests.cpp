@@ -0,0 +1,65 @@
+﻿#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ThermoForgeVolumeIndex.h"
+#include "ThermoForgeTestFields.h"
+#include "ThermoForgeTestWorld.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FThermoForgeNestedBlendTest, "ThermoForge.Volumes.NestedBlend",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+// Three nested volumes with border bands: the blended value has no step anywhere along a line out of them
+bool FThermoForgeNestedBlendTest::RunTest(const FString& Parameters)
+{
+    FThermoForgeTestWorld TestWorld;
+    UThermoForgeFieldAsset* Field = TF_MakeTestField(FIntVector(4, 4, 4), 46);
+
+    // Same cell size everywhere, so the smaller box resolves first
+    const AThermoForgeVolume* Outer = TestWorld.SpawnVolume(Field, FVector::ZeroVector, FVector(1000.0), 0.f);
+    const AThermoForgeVolume* Mid   = TestWorld.SpawnVolume(Field, FVector::ZeroVector, FVector(400.0),  100.f);
+    const AThermoForgeVolume* Inner = TestWorld.SpawnVolume(Field, FVector::ZeroVector, FVector(150.0),  50.f);
+
+    FThermoForgeVolumeIndex Index;
+    Index.Build(TestWorld.Get());
+    if (!TestEqual(TEXT("Every volume indexed"), Index.Num(), 3)) return false;
+    TestTrue(TEXT("Finest first"), Index[0].Volume.Get() == Inner && Index[1].Volume.Get() == Mid && Index[2].Volume.Get() == Outer);
+
+    // Each volume reports its own constant, so the blend weights show directly in the result
+    const TMap<const AThermoForgeVolume*, float> Values = { { Inner, 0.f }, { Mid, 10.f }, { Outer, 20.f } };
+    auto Sample = [&Values](const FThermoVolumeNode& Node, float& Out)
+    {
+        Out = Values.FindChecked(Node.Volume.Get());
+        return true;
+    };
+    auto BlendAt = [&](double X)
+    {
+        float V = -1.f;
+        Index.Blend(FVector(X, 0.0, 0.0), Sample, V);
+        return V;
+    };
+
+    // Exact where one volume has full weight, halfway inside each band
+    TestEqual(TEXT("Inner core"),           BlendAt(0.0),   0.f,  1e-4f);
+    TestEqual(TEXT("Inner band midpoint"),  BlendAt(125.0), 5.f,  1e-4f);
+    TestEqual(TEXT("Inner face"),           BlendAt(150.0), 10.f, 1e-4f);
+    TestEqual(TEXT("Mid core"),             BlendAt(250.0), 10.f, 1e-4f);
+    TestEqual(TEXT("Mid band midpoint"),    BlendAt(350.0), 15.f, 1e-4f);
+    TestEqual(TEXT("Mid face"),             BlendAt(400.0), 20.f, 1e-4f);
+    TestEqual(TEXT("Outer only"),           BlendAt(700.0), 20.f, 1e-4f);
+
+    // Continuity: no jump between neighbouring samples beyond the steepest band's slope (10 °C over 50 cm)
+    const double Step = 1.0;
+    const float MaxJump = float(10.0 / 50.0 * Step) + 1e-4f;
+    float Prev = BlendAt(0.0), Worst = 0.f;
+    for (double X=Step; X<=900.0; X+=Step)
+    {
+        const float V = BlendAt(X);
+        Worst = FMath::Max(Worst, FMath::Abs(V - Prev));
+        Prev = V;
+    }
+    TestTrue(FString::Printf(TEXT("Continuous across nested faces (largest step %.4f, allowed %.4f)"), Worst, MaxJump), Worst <= MaxJump);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
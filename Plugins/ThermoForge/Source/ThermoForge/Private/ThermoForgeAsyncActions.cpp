@@ -0,0 +1,97 @@
+﻿#include "ThermoForgeAsyncActions.h"
+#include "ThermoForgeVolume.h"
+
+#include "Async/Async.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+// ---- Temperature ----
+UThermoForgeAsyncTemperature* UThermoForgeAsyncTemperature::ComputeTemperatureAsync(UObject* WorldContextObject, FVector InWorldPos)
+{
+    UThermoForgeAsyncTemperature* Action = NewObject<UThermoForgeAsyncTemperature>();
+    Action->World    = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+    Action->WorldPos = InWorldPos;
+    Action->RegisterWithGameInstance(WorldContextObject);
+    return Action;
+}
+
+void UThermoForgeAsyncTemperature::Activate()
+{
+    UWorld* W = World.Get();
+    UThermoForgeSubsystem* TF = W ? W->GetSubsystem<UThermoForgeSubsystem>() : nullptr;
+    if (!TF)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Compute Temperature (Async): no ThermoForge subsystem"));
+        SetReadyToDestroy();
+        return;
+    }
+
+    TWeakObjectPtr<UThermoForgeAsyncTemperature> WeakThis(this);
+    TF->ComputeTemperatureAsync(WorldPos).Next([WeakThis](float TempC)
+    {
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, TempC]()
+        {
+            if (UThermoForgeAsyncTemperature* This = WeakThis.Get())
+            {
+                This->Completed.Broadcast(TempC);
+                This->SetReadyToDestroy();
+            }
+        });
+    });
+}
+
+// ---- Extreme ----
+UThermoForgeAsyncExtreme* UThermoForgeAsyncExtreme::FindBakedExtremeNearAsync(UObject* WorldContextObject, FVector InCenterWS, float InRadiusCm, bool bInHottest)
+{
+    UThermoForgeAsyncExtreme* Action = NewObject<UThermoForgeAsyncExtreme>();
+    Action->World    = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+    Action->CenterWS = InCenterWS;
+    Action->RadiusCm = InRadiusCm;
+    Action->bHottest = bInHottest;
+    Action->RegisterWithGameInstance(WorldContextObject);
+    return Action;
+}
+
+void UThermoForgeAsyncExtreme::Activate()
+{
+    UWorld* W = World.Get();
+    UThermoForgeSubsystem* TF = W ? W->GetSubsystem<UThermoForgeSubsystem>() : nullptr;
+    if (!TF)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Find Baked Extreme Near (Async): no ThermoForge subsystem"));
+        NotFound.Broadcast(FThermoForgeGridHit());
+        SetReadyToDestroy();
+        return;
+    }
+
+    TWeakObjectPtr<UThermoForgeAsyncExtreme> WeakThis(this);
+    TF->FindBakedExtremeNearAsync(CenterWS, RadiusCm, bHottest).Next([WeakThis](const FThermoSnapshotCellHit& Cell)
+    {
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, Cell]()
+        {
+            UThermoForgeAsyncExtreme* This = WeakThis.Get();
+            if (!This) return;
+
+            // Volume may have been removed while the search ran
+            FThermoForgeGridHit Hit;
+            Hit.Volume = Cell.Volume.Get();
+            Hit.bFound = Cell.bFound && Hit.Volume != nullptr;
+            if (Hit.bFound)
+            {
+                Hit.GridIndex    = Cell.GridIndex;
+                Hit.LinearIndex  = Cell.LinearIndex;
+                Hit.CellCenterWS = Cell.CellCenterWS;
+                Hit.DistanceSq   = Cell.DistanceSq;
+                Hit.CellSizeCm   = Cell.CellSizeCm;
+                Hit.QueryTimeUTC = Cell.TimeUTC;
+                Hit.CurrentTempC = Cell.TempC;
+                This->Found.Broadcast(Hit);
+            }
+            else
+            {
+                This->NotFound.Broadcast(Hit);
+            }
+            This->SetReadyToDestroy();
+        });
+    });
+}
@@ -0,0 +1,206 @@
+﻿#include "ThermoForgeClipmap.h"
+#include "ThermoForgeFieldAsset.h"
+
+static const FIntVector TF_EMPTY_KEY(MIN_int32);
+
+void FThermoForgeClipmap::Init(const FParams& InParams)
+{
+    Params = InParams;
+    Params.Levels = FMath::Clamp(InParams.Levels, 1, 8);
+    Params.Resolution = int32(FMath::RoundUpToPowerOfTwo(uint32(FMath::Clamp(InParams.Resolution, 8, 128))));
+    Params.BaseCellSizeCm = FMath::Max(10.f, InParams.BaseCellSizeCm);
+    Mask = Params.Resolution - 1;
+
+    const int32 N = Params.Resolution * Params.Resolution * Params.Resolution;
+    Levels.SetNum(Params.Levels);
+    for (int32 l=0; l<Levels.Num(); ++l)
+    {
+        FLevel& L = Levels[l];
+        L = FLevel();
+        L.CellSizeCm = Params.BaseCellSizeCm * float(1 << l);
+        L.Sky.SetNumZeroed(N);
+        L.Perm.SetNumZeroed(N);
+        L.Key.Init(TF_EMPTY_KEY, N);
+    }
+}
+
+bool FThermoForgeClipmap::IsValidFor(const FParams& InParams) const
+{
+    return Levels.Num() == FMath::Clamp(InParams.Levels, 1, 8)
+        && Params.Resolution == int32(FMath::RoundUpToPowerOfTwo(uint32(FMath::Clamp(InParams.Resolution, 8, 128))))
+        && Params.BaseCellSizeCm == FMath::Max(10.f, InParams.BaseCellSizeCm);
+}
+
+void FThermoForgeClipmap::Recenter(const FVector& CenterWS)
+{
+    const int32 R = Params.Resolution;
+
+    for (FLevel& L : Levels)
+    {
+        const FIntVector CenterCell(
+            FMath::FloorToInt(CenterWS.X / L.CellSizeCm),
+            FMath::FloorToInt(CenterWS.Y / L.CellSizeCm),
+            FMath::FloorToInt(CenterWS.Z / L.CellSizeCm));
+
+        // Even min corners keep each ring aligned to the cells of the next coarser one
+        const FIntVector NewMin((CenterCell.X - R/2) & ~1, (CenterCell.Y - R/2) & ~1, (CenterCell.Z - R/2) & ~1);
+        if (L.bPlaced && NewMin == L.Min) continue;
+
+        const FIntVector OldMin = L.Min;
+        const bool bWasPlaced = L.bPlaced;
+        L.Min = NewMin;
+        L.bPlaced = true;
+
+        // Drop queued cells that scrolled out
+        TArray<FIntVector> Pending;
+        Pending.Reserve(L.Queue.Num() - L.QueueHead);
+        for (int32 q=L.QueueHead; q<L.Queue.Num(); ++q)
+        {
+            if (InWindow(L.Min, L.Queue[q])) Pending.Add(L.Queue[q]);
+        }
+
+        // Cells in [Lo, Hi)
+        auto AddBox = [&Pending](const FIntVector& Lo, const FIntVector& Hi)
+        {
+            for (int32 z=Lo.Z; z<Hi.Z; ++z)
+            for (int32 y=Lo.Y; y<Hi.Y; ++y)
+            for (int32 x=Lo.X; x<Hi.X; ++x)
+            {
+                Pending.Add(FIntVector(x, y, z));
+            }
+        };
+
+        const FIntVector Delta = NewMin - OldMin;
+        const FIntVector NewMax = NewMin + FIntVector(R);
+        if (!bWasPlaced || FMath::Abs(Delta.X) >= R || FMath::Abs(Delta.Y) >= R || FMath::Abs(Delta.Z) >= R)
+        {
+            // A jump of a whole ring exposes everything
+            AddBox(NewMin, NewMax);
+        }
+        else
+        {
+            // Newly exposed slabs only, one per moved axis. Each later axis is clipped to the
+            // overlap with the old window on the earlier axes so no cell is queued twice.
+            const FIntVector OldMax = OldMin + FIntVector(R);
+            FIntVector Lo = NewMin, Hi = NewMax;
+            for (int32 a=0; a<3; ++a)
+            {
+                if (Delta[a] != 0)
+                {
+                    FIntVector SlabLo = Lo, SlabHi = Hi;
+                    if (Delta[a] > 0) SlabLo[a] = OldMax[a];
+                    else              SlabHi[a] = OldMin[a];
+                    AddBox(SlabLo, SlabHi);
+                }
+                Lo[a] = FMath::Max(NewMin[a], OldMin[a]);
+                Hi[a] = FMath::Min(NewMax[a], OldMax[a]);
+            }
+        }
+
+        Pending.Sort([&CenterCell](const FIntVector& A, const FIntVector& B)
+        {
+            const FIntVector DA = A - CenterCell, DB = B - CenterCell;
+            return DA.X*DA.X + DA.Y*DA.Y + DA.Z*DA.Z < DB.X*DB.X + DB.Y*DB.Y + DB.Z*DB.Z;
+        });
+        L.Queue = MoveTemp(Pending);
+        L.QueueHead = 0;
+    }
+}
+
+int32 FThermoForgeClipmap::Fill(int32 TraceBudget, const UThermoForgeFieldAsset* Coarse, FCellFn TraceCell)
+{
+    const bool bCoarse = Coarse && Coarse->Dim.X > 0 && Coarse->Dim.Y > 0 && Coarse->Dim.Z > 0 && Coarse->CellSizeCm > 0.f
+        && Coarse->SkyView01.Num() == Coarse->Dim.X * Coarse->Dim.Y * Coarse->Dim.Z
+        && Coarse->WallPermeability01.Num() == Coarse->SkyView01.Num();
+    const FTransform CoarseInv = bCoarse ? Coarse->GetGridFrame().Inverse() : FTransform::Identity;
+
+    auto CoarseCovers = [&](const FVector& P)
+    {
+        const FVector G = CoarseInv.TransformPosition(P) / Coarse->CellSizeCm;
+        return G.X >= 0.0 && G.Y >= 0.0 && G.Z >= 0.0 && G.X < Coarse->Dim.X && G.Y < Coarse->Dim.Y && G.Z < Coarse->Dim.Z;
+    };
+
+    int32 Traced = 0;
+
+    // Level l may trace up to Cap cells; returns once its queue is empty or it needs a trace it can't afford
+    auto Drain = [&](FLevel& L, int32 Cap)
+    {
+        const bool bUseCoarse = bCoarse && L.CellSizeCm >= Coarse->CellSizeCm;
+        int32 Used = 0;
+        while (L.QueueHead < L.Queue.Num())
+        {
+            const FIntVector C = L.Queue[L.QueueHead];
+            const int32 s = Slot(C);
+            if (!InWindow(L.Min, C) || L.Key[s] == C) { ++L.QueueHead; continue; }
+
+            const FVector P((C.X + 0.5f) * L.CellSizeCm, (C.Y + 0.5f) * L.CellSizeCm, (C.Z + 0.5f) * L.CellSizeCm);
+            if (bUseCoarse && CoarseCovers(P))
+            {
+                L.Sky[s]  = FMath::Clamp(Coarse->SampleSkyView01(P), 0.f, 1.f);
+                L.Perm[s] = FMath::Clamp(Coarse->SampleWallPerm01(P), 0.f, 1.f);
+            }
+            else
+            {
+                if (Used >= Cap || Traced >= TraceBudget) return;
+                float Sky = 0.f, Perm = 1.f;
+                TraceCell(P, L.CellSizeCm, Sky, Perm);
+                L.Sky[s]  = FMath::Clamp(Sky, 0.f, 1.f);
+                L.Perm[s] = FMath::Clamp(Perm, 0.f, 1.f);
+                ++Used;
+                ++Traced;
+            }
+            L.Key[s] = C;
+            ++L.QueueHead;
+        }
+        L.Queue.Reset();
+        L.QueueHead = 0;
+    };
+
+    // An even share per level first so coarse rings keep up while the fine ones scroll, then leftovers finest first
+    const int32 Share = FMath::Max(1, TraceBudget / FMath::Max(1, Levels.Num()));
+    for (FLevel& L : Levels) Drain(L, Share);
+    for (FLevel& L : Levels) Drain(L, MAX_int32);
+
+    return Traced;
+}
+
+bool FThermoForgeClipmap::Sample(const FVector& P, float& OutSky01, float& OutWallPerm01) const
+{
+    for (const FLevel& L : Levels)
+    {
+        if (!L.bPlaced) continue;
+
+        // Cell-centre space
+        const FVector G = P / L.CellSizeCm - FVector(0.5f);
+        const FIntVector C0(FMath::FloorToInt(G.X), FMath::FloorToInt(G.Y), FMath::FloorToInt(G.Z));
+        if (!InWindow(L.Min, C0) || !InWindow(L.Min, C0 + FIntVector(1))) continue;
+
+        const float ax = float(G.X - C0.X), ay = float(G.Y - C0.Y), az = float(G.Z - C0.Z);
+
+        float Sky = 0.f, Perm = 0.f;
+        bool bFilled = true;
+        for (int32 k=0; k<8 && bFilled; ++k)
+        {
+            const FIntVector C = C0 + FIntVector(k & 1, (k >> 1) & 1, (k >> 2) & 1);
+            const int32 s = Slot(C);
+            bFilled = L.Key[s] == C;
+
+            const float W = ((k & 1) ? ax : 1.f - ax) * ((k & 2) ? ay : 1.f - ay) * ((k & 4) ? az : 1.f - az);
+            Sky  += W * L.Sky[s];
+            Perm += W * L.Perm[s];
+        }
+        if (!bFilled) continue;
+
+        OutSky01      = Sky;
+        OutWallPerm01 = Perm;
+        return true;
+    }
+    return false;
+}
+
+int32 FThermoForgeClipmap::GetPendingCells() const
+{
+    int32 Pending = 0;
+    for (const FLevel& L : Levels) Pending += L.Queue.Num() - L.QueueHead;
+    return Pending;
+}
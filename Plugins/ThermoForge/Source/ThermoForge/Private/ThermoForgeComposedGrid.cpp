@@ -0,0 +1,386 @@
+﻿#include "ThermoForgeComposedGrid.h"
+#include "ThermoForgeBlockers.h"
+#include "ThermoForgeFieldAsset.h"
+#include "ThermoForgeSourceComponent.h"
+
+#include "HAL/PlatformTime.h"
+
+void FThermoForgeComposedGrid::Init(const UThermoForgeFieldAsset* InField)
+{
+    Field = InField;
+    Dim = InField ? InField->Dim : FIntVector::ZeroValue;
+
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    if (!InField || N <= 0 || InField->SkyView01.Num() != N)
+    {
+        Dim = FIntVector::ZeroValue;
+        BrickDim = FIntVector::ZeroValue;
+        SourceC.Empty();
+        TempC.Empty();
+        DirtyBricks.Empty();
+        BrickTempStamp.Empty();
+        BrickSourceStamp.Empty();
+        NumDirty = 0;
+        ++Revision;
+        ++TempStamp;
+        return;
+    }
+
+    CellSizeCm = FMath::Max(1.f, InField->CellSizeCm);
+    Frame      = InField->GetGridFrame();
+    InvFrame   = Frame.Inverse();
+
+    Z0 = Frame.TransformPosition(FVector(0.5f * CellSizeCm)).Z;
+    Zx = Frame.TransformVector(FVector(CellSizeCm, 0, 0)).Z;
+    Zy = Frame.TransformVector(FVector(0, CellSizeCm, 0)).Z;
+    Zz = Frame.TransformVector(FVector(0, 0, CellSizeCm)).Z;
+
+    BrickDim = FIntVector(
+        FMath::DivideAndRoundUp(Dim.X, BrickSize),
+        FMath::DivideAndRoundUp(Dim.Y, BrickSize),
+        FMath::DivideAndRoundUp(Dim.Z, BrickSize));
+
+    SourceC.SetNumZeroed(N);
+    TempC.SetNumZeroed(N);
+    BrickTempStamp.Init(++TempStamp, BrickDim.X * BrickDim.Y * BrickDim.Z);
+    BrickSourceStamp.Init(++SourceStamp, BrickDim.X * BrickDim.Y * BrickDim.Z);
+
+    SunLobeMax = 0.f;
+    if (InField->HasSunVisibility())
+    {
+        for (const FVector4f& SH : InField->SunVisibilitySH)
+        {
+            SunLobeMax = FMath::Max(SunLobeMax, FVector3f(SH.X, SH.Y, SH.Z).Size());
+        }
+    }
+
+    // Force the first ApplyClimate to compose
+    AppliedAmbientSeaLevelC = TNumericLimits<float>::Max();
+
+    MarkAllDirty();
+}
+
+bool FThermoForgeComposedGrid::IsValidFor(const UThermoForgeFieldAsset* InField) const
+{
+    return InField && Field.Get() == InField && InField->Dim == Dim && BrickDim.X > 0
+        && FMath::IsNearlyEqual(FMath::Max(1.f, InField->CellSizeCm), CellSizeCm)
+        && InField->GetGridFrame().Equals(Frame);
+}
+
+void FThermoForgeComposedGrid::MarkAllDirty()
+{
+    const int32 NB = BrickDim.X * BrickDim.Y * BrickDim.Z;
+    DirtyBricks.Init(true, NB);
+    NumDirty = NB;
+    ScanCursor = 0;
+    ++Revision;
+}
+
+void FThermoForgeComposedGrid::MarkWorldBoxDirty(const FBox& WorldBox)
+{
+    if (!WorldBox.IsValid || NumDirty == DirtyBricks.Num() || BrickDim.X <= 0) return;
+
+    // World box → grid-local AABB → brick range
+    FBox Local(ForceInit);
+    for (int32 i=0; i<8; ++i)
+    {
+        const FVector C(
+            (i & 1) ? WorldBox.Max.X : WorldBox.Min.X,
+            (i & 2) ? WorldBox.Max.Y : WorldBox.Min.Y,
+            (i & 4) ? WorldBox.Max.Z : WorldBox.Min.Z);
+        Local += InvFrame.TransformPosition(C);
+    }
+
+    const float BrickCm = CellSizeCm * BrickSize;
+    const int32 bx0 = FMath::Max(0, FMath::FloorToInt(Local.Min.X / BrickCm));
+    const int32 by0 = FMath::Max(0, FMath::FloorToInt(Local.Min.Y / BrickCm));
+    const int32 bz0 = FMath::Max(0, FMath::FloorToInt(Local.Min.Z / BrickCm));
+    const int32 bx1 = FMath::Min(BrickDim.X - 1, FMath::FloorToInt(Local.Max.X / BrickCm));
+    const int32 by1 = FMath::Min(BrickDim.Y - 1, FMath::FloorToInt(Local.Max.Y / BrickCm));
+    const int32 bz1 = FMath::Min(BrickDim.Z - 1, FMath::FloorToInt(Local.Max.Z / BrickCm));
+
+    bool bChanged = false;
+    for (int32 bz=bz0; bz<=bz1; ++bz)
+    for (int32 by=by0; by<=by1; ++by)
+    for (int32 bx=bx0; bx<=bx1; ++bx)
+    {
+        const int32 B = BrickIndex(bx, by, bz);
+        if (!DirtyBricks[B])
+        {
+            DirtyBricks[B] = true;
+            ++NumDirty;
+            bChanged = true;
+        }
+    }
+    if (bChanged) ++Revision;
+}
+
+FBox FThermoForgeComposedGrid::BrickWorldBounds(const FIntVector& Brick) const
+{
+    const FVector Min = FVector(Brick * BrickSize) * CellSizeCm;
+    const FVector Max = FVector(FIntVector(
+        FMath::Min((Brick.X + 1) * BrickSize, Dim.X),
+        FMath::Min((Brick.Y + 1) * BrickSize, Dim.Y),
+        FMath::Min((Brick.Z + 1) * BrickSize, Dim.Z))) * CellSizeCm;
+
+    return FBox(Min, Max).TransformBy(Frame);
+}
+
+void FThermoForgeComposedGrid::ComposeBrick(const FIntVector& Brick, const FThermoClimateState& /*Climate*/,
+    TConstArrayView<FThermoComposeSource> Sources, FOcclusionFn Occlusion)
+{
+    const UThermoForgeFieldAsset* F = Field.Get();
+    if (!F) return;
+    const FThermoPermOverrideLayer* Overrides = PermOverrides.Get();
+
+    // Only sources whose support touches this brick
+    const FBox BrickBox = BrickWorldBounds(Brick);
+    TArray<const FThermoComposeSource*, TInlineAllocator<16>> Local;
+    for (const FThermoComposeSource& S : Sources)
+    {
+        if (S.Source && S.BoundsWS.Intersect(BrickBox)) Local.Add(&S);
+    }
+
+    const int32 x0 = Brick.X * BrickSize, x1 = FMath::Min(x0 + BrickSize, Dim.X);
+    const int32 y0 = Brick.Y * BrickSize, y1 = FMath::Min(y0 + BrickSize, Dim.Y);
+    const int32 z0 = Brick.Z * BrickSize, z1 = FMath::Min(z0 + BrickSize, Dim.Z);
+
+    for (int32 z=z0; z<z1; ++z)
+    for (int32 y=y0; y<y1; ++y)
+    for (int32 x=x0; x<x1; ++x)
+    {
+        const int32 i = Index(x,y,z);
+
+        float Sum = 0.f;
+        if (Local.Num() > 0)
+        {
+            const FVector P = Frame.TransformPosition(FVector((x + 0.5f) * CellSizeCm, (y + 0.5f) * CellSizeCm, (z + 0.5f) * CellSizeCm));
+            const float Baked    = F->GetWallPermByLinearIdx(i);
+            const float WallPerm = FMath::Clamp(Overrides ? Overrides->GetWallPerm(i, Baked) : Baked, 0.f, 1.f);
+
+            for (const FThermoComposeSource* S : Local)
+            {
+                const float Intensity = S->Source->SampleAt(P);
+                if (Intensity == 0.f) continue;
+                Sum += Intensity * Occlusion(P, S->LocationWS) * WallPerm;
+            }
+        }
+        SourceC[i] = Sum;
+
+        // Composed with the climate the rest of the grid currently holds
+        const float Sky = F->GetSolarViewByLinearIdx(i, AppliedSunDirWS);
+        const float Amb = AppliedAmbientSeaLevelC - AppliedLapseCPerCm * float(CellZ(x,y,z) - AppliedSeaLevelZcm);
+        TempC[i] = Amb + AppliedSolarC * Sky + Sum;
+    }
+}
+
+int32 FThermoForgeComposedGrid::UpdateDirty(const FThermoClimateState& Climate, TConstArrayView<FThermoComposeSource> Sources,
+    FOcclusionFn Occlusion, double DeadlineSeconds)
+{
+    if (NumDirty <= 0 || !Field.IsValid()) return 0;
+
+    int32 Done = 0;
+    const int32 NB = DirtyBricks.Num();
+    while (NumDirty > 0)
+    {
+        int32 B = DirtyBricks.FindFrom(true, ScanCursor);
+        if (B == INDEX_NONE) B = DirtyBricks.Find(true);
+        if (B == INDEX_NONE) { NumDirty = 0; break; }
+
+        const FIntVector Brick(B % BrickDim.X, (B / BrickDim.X) % BrickDim.Y, B / (BrickDim.X * BrickDim.Y));
+        ComposeBrick(Brick, Climate, Sources, Occlusion);
+
+        DirtyBricks[B] = false;
+        BrickTempStamp[B] = ++TempStamp;
+        BrickSourceStamp[B] = ++SourceStamp;
+        --NumDirty;
+        ++Done;
+        ScanCursor = (B + 1) % NB;
+
+        if (FPlatformTime::Seconds() >= DeadlineSeconds) break;
+    }
+    if (Done > 0) ++Revision;
+    return Done;
+}
+
+void FThermoForgeComposedGrid::ApplyClimate(const FThermoClimateState& Climate, float EpsilonC)
+{
+    const UThermoForgeFieldAsset* F = Field.Get();
+    if (!F || BrickDim.X <= 0) return;
+
+    // Largest change any cell would see: ambient offset + lapse over the grid's Z span + full-sky solar + sun travel
+    const double ZA = Z0, ZB = Z0 + Zx * (Dim.X-1) + Zy * (Dim.Y-1) + Zz * (Dim.Z-1);
+    const double ZLo = FMath::Min(ZA, ZB) - FMath::Abs(Zx) * Dim.X - FMath::Abs(Zy) * Dim.Y - FMath::Abs(Zz) * Dim.Z;
+    const double ZHi = FMath::Max(ZA, ZB) + FMath::Abs(Zx) * Dim.X + FMath::Abs(Zy) * Dim.Y + FMath::Abs(Zz) * Dim.Z;
+
+    auto AmbAt = [](float Amb, float Lapse, float Sea, double Z){ return Amb - Lapse * float(Z - Sea); };
+    const float DLo = FMath::Abs(AmbAt(Climate.AmbientSeaLevelC, Climate.LapseCPerCm, Climate.SeaLevelZcm, ZLo)
+                               - AmbAt(AppliedAmbientSeaLevelC,  AppliedLapseCPerCm,  AppliedSeaLevelZcm,  ZLo));
+    const float DHi = FMath::Abs(AmbAt(Climate.AmbientSeaLevelC, Climate.LapseCPerCm, Climate.SeaLevelZcm, ZHi)
+                               - AmbAt(AppliedAmbientSeaLevelC,  AppliedLapseCPerCm,  AppliedSeaLevelZcm,  ZHi));
+    const float SunDelta = (Climate.SunDirWS.IsZero() != AppliedSunDirWS.IsZero())
+        ? FMath::Abs(Climate.SolarC)
+        : FMath::Abs(Climate.SolarC) * SunLobeMax * float(FVector::Distance(Climate.SunDirWS, AppliedSunDirWS));
+    const float MaxDelta = FMath::Max(DLo, DHi) + FMath::Abs(Climate.SolarC - AppliedSolarC) + SunDelta;
+
+    if (AppliedAmbientSeaLevelC != TNumericLimits<float>::Max() && MaxDelta <= EpsilonC) return;
+
+    AppliedAmbientSeaLevelC = Climate.AmbientSeaLevelC;
+    AppliedLapseCPerCm      = Climate.LapseCPerCm;
+    AppliedSeaLevelZcm      = Climate.SeaLevelZcm;
+    AppliedSolarC           = Climate.SolarC;
+    AppliedSunDirWS         = Climate.SunDirWS;
+
+    // No traces here: ambient and solar only, SourceC is reused
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    for (int32 x=0; x<Dim.X; ++x)
+    {
+        const int32 i = Index(x,y,z);
+        const float Sky = F->GetSolarViewByLinearIdx(i, AppliedSunDirWS);
+        const float Amb = AppliedAmbientSeaLevelC - AppliedLapseCPerCm * float(CellZ(x,y,z) - AppliedSeaLevelZcm);
+        TempC[i] = Amb + AppliedSolarC * Sky + SourceC[i];
+    }
+
+    ++TempStamp;
+    for (uint32& Stamp : BrickTempStamp) Stamp = TempStamp;
+}
+
+void FThermoForgeComposedGrid::CopyBrickSourceC(int32 Brick, TArray<float>& Out) const
+{
+    Out.SetNumZeroed(BrickSize * BrickSize * BrickSize);
+    if (BrickDim.X <= 0 || Brick < 0 || Brick >= BrickSourceStamp.Num()) return;
+
+    const FIntVector Min = FIntVector(Brick % BrickDim.X, (Brick / BrickDim.X) % BrickDim.Y, Brick / (BrickDim.X * BrickDim.Y)) * BrickSize;
+    const int32 ex = FMath::Min(BrickSize, Dim.X - Min.X);
+    const int32 ey = FMath::Min(BrickSize, Dim.Y - Min.Y);
+    const int32 ez = FMath::Min(BrickSize, Dim.Z - Min.Z);
+    for (int32 z=0; z<ez; ++z)
+    for (int32 y=0; y<ey; ++y)
+    {
+        FMemory::Memcpy(&Out[(z * BrickSize + y) * BrickSize], &SourceC[Index(Min.X, Min.Y + y, Min.Z + z)], ex * sizeof(float));
+    }
+}
+
+bool FThermoForgeComposedGrid::IsBrickDirty(int32 x, int32 y, int32 z) const
+{
+    return DirtyBricks[BrickIndex(x / BrickSize, y / BrickSize, z / BrickSize)];
+}
+
+bool FThermoForgeComposedGrid::TrilinearCells(const FVector& LocalCm, float InCellSizeCm, const FIntVector& InDim,
+    FIntVector (&OutCells)[8], float (&OutW)[8], FVector* OutDW)
+{
+    if (InDim.X <= 0 || InDim.Y <= 0 || InDim.Z <= 0 || InCellSizeCm <= 0.f) return false;
+
+    // Cell-center space
+    const FVector L = LocalCm / InCellSizeCm - FVector(0.5f);
+    if (L.X < -0.5f || L.Y < -0.5f || L.Z < -0.5f ||
+        L.X > InDim.X - 0.5f || L.Y > InDim.Y - 0.5f || L.Z > InDim.Z - 0.5f) return false;
+
+    // da/dv is 1 inside the interpolation span, 0 where clamped
+    auto Axis = [](double v, int32 N, int32& i0, int32& i1, float& a, float& da)
+    {
+        const double c = FMath::Clamp(v, 0.0, double(N - 1));
+        i0 = FMath::Min(FMath::FloorToInt(c), FMath::Max(0, N - 2));
+        i1 = FMath::Min(i0 + 1, N - 1);
+        a  = float(c - i0);
+        da = (N > 1 && v > 0.0 && v < double(N - 1)) ? 1.f : 0.f;
+    };
+
+    int32 x0, x1, y0, y1, z0, z1;
+    float ax, ay, az, dax, day, daz;
+    Axis(L.X, InDim.X, x0, x1, ax, dax);
+    Axis(L.Y, InDim.Y, y0, y1, ay, day);
+    Axis(L.Z, InDim.Z, z0, z1, az, daz);
+
+    const int32 Xs[2] = { x0, x1 }, Ys[2] = { y0, y1 }, Zs[2] = { z0, z1 };
+    const float Wx[2] = { 1.f - ax, ax }, Wy[2] = { 1.f - ay, ay }, Wz[2] = { 1.f - az, az };
+
+    const float InvCell = 1.f / InCellSizeCm;
+    const float Dx[2] = { -dax * InvCell, dax * InvCell }, Dy[2] = { -day * InvCell, day * InvCell }, Dz[2] = { -daz * InvCell, daz * InvCell };
+
+    for (int32 k=0; k<8; ++k)
+    {
+        const int32 i = k & 1, j = (k >> 1) & 1, l = (k >> 2) & 1;
+        OutCells[k] = FIntVector(Xs[i], Ys[j], Zs[l]);
+        OutW[k]     = Wx[i] * Wy[j] * Wz[l];
+        if (OutDW)
+        {
+            OutDW[k] = FVector(Dx[i] * Wy[j] * Wz[l], Wx[i] * Dy[j] * Wz[l], Wx[i] * Wy[j] * Dz[l]);
+        }
+    }
+    return true;
+}
+
+bool FThermoForgeComposedGrid::Trilinear(const FVector& P, int32 (&OutIdx)[8], float (&OutW)[8]) const
+{
+    if (BrickDim.X <= 0) return false;
+
+    FIntVector Cells[8];
+    if (!TrilinearCells(InvFrame.TransformPosition(P), CellSizeCm, Dim, Cells, OutW)) return false;
+
+    for (int32 k=0; k<8; ++k)
+    {
+        if (IsBrickDirty(Cells[k].X, Cells[k].Y, Cells[k].Z)) return false;
+        OutIdx[k] = Index(Cells[k].X, Cells[k].Y, Cells[k].Z);
+    }
+    return true;
+}
+
+bool FThermoForgeComposedGrid::SampleTemp(const FVector& P, float& OutTempC) const
+{
+    int32 Idx[8]; float W[8];
+    if (!Trilinear(P, Idx, W)) return false;
+
+    float T = 0.f;
+    for (int32 k=0; k<8; ++k) T += W[k] * TempC[Idx[k]];
+    OutTempC = T;
+    return true;
+}
+
+bool FThermoForgeComposedGrid::SampleSourceAndSky(const FVector& P, const FVector& SunDirWS, float& OutSourceC, float& OutSky01) const
+{
+    const UThermoForgeFieldAsset* F = Field.Get();
+    int32 Idx[8]; float W[8];
+    if (!F || !Trilinear(P, Idx, W)) return false;
+
+    float Src = 0.f, Sky = 0.f;
+    for (int32 k=0; k<8; ++k)
+    {
+        Src += W[k] * SourceC[Idx[k]];
+        Sky += W[k] * F->GetSolarViewByLinearIdx(Idx[k], SunDirWS);
+    }
+    OutSourceC = Src;
+    OutSky01   = Sky;
+    return true;
+}
+
+bool FThermoForgeComposedGrid::SampleWithGradient(const FVector& P, const FVector& SunDirWS, float& OutSourceC, FVector& OutSourceGrad, float& OutSky01, FVector& OutSkyGrad) const
+{
+    const UThermoForgeFieldAsset* F = Field.Get();
+    if (!F || BrickDim.X <= 0) return false;
+
+    FIntVector Cells[8]; float W[8]; FVector DW[8];
+    if (!TrilinearCells(InvFrame.TransformPosition(P), CellSizeCm, Dim, Cells, W, DW)) return false;
+
+    float Src = 0.f, Sky = 0.f;
+    FVector GSrc = FVector::ZeroVector, GSky = FVector::ZeroVector;
+    for (int32 k=0; k<8; ++k)
+    {
+        if (IsBrickDirty(Cells[k].X, Cells[k].Y, Cells[k].Z)) return false;
+
+        const int32 i = Index(Cells[k].X, Cells[k].Y, Cells[k].Z);
+        const float s = F->GetSolarViewByLinearIdx(i, SunDirWS);
+        Src  += W[k] * SourceC[i];
+        Sky  += W[k] * s;
+        GSrc += DW[k] * SourceC[i];
+        GSky += DW[k] * s;
+    }
+
+    // Grid-local → world (the frame is rotation + translation only)
+    OutSourceC    = Src;
+    OutSky01      = Sky;
+    OutSourceGrad = Frame.TransformVectorNoScale(GSrc);
+    OutSkyGrad    = Frame.TransformVectorNoScale(GSky);
+    return true;
+}
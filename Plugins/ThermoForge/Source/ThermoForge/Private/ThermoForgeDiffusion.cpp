@@ -0,0 +1,458 @@
+﻿#include "ThermoForgeDiffusion.h"
+#include "ThermoForgeBlockers.h"
+#include "ThermoForgeComposedGrid.h"
+#include "ThermoForgeFieldAsset.h"
+
+#include "Async/ParallelFor.h"
+
+// Explicit stencil is stable while 6·r + k stays below 1; keep some margin
+static constexpr float TF_DIFFUSION_STABLE = 0.9f;
+static constexpr int32 TF_DIFFUSION_MAX_SPLIT = 16;
+
+void FThermoForgeDiffusionGrid::Init(const UThermoForgeFieldAsset* InField, int32 InGuardCells, TConstArrayView<float> SeedC)
+{
+    Field = InField;
+    Dim   = InField ? InField->Dim : FIntVector::ZeroValue;
+    Guard = FMath::Clamp(InGuardCells, 1, 3);
+    Accumulator = 0.0;
+    bSettlePending = true;
+
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    if (!InField || N <= 0 || InField->WallPermeability01.Num() != N)
+    {
+        Dim = PDim = FIntVector::ZeroValue;
+        T.Empty(); TNext.Empty(); Gx.Empty(); Gy.Empty(); Gz.Empty();
+        WindMask.Empty(); CellWind.Empty();
+        MaxWindCells = 0.f;
+        return;
+    }
+
+    CellSizeCm = FMath::Max(1.f, InField->CellSizeCm);
+    Frame      = InField->GetGridFrame();
+    InvFrame   = Frame.Inverse();
+    PDim       = Dim + FIntVector(2 * Guard);
+
+    const int32 PN = PDim.X * PDim.Y * PDim.Z;
+    T.SetNumZeroed(PN);
+    TNext.SetNumZeroed(PN);
+    RefreshConductance(InField);
+
+    const bool bSeed = SeedC.Num() == N;
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    for (int32 x=0; x<Dim.X; ++x)
+    {
+        const int32 p = Padded(x,y,z);
+        T[p] = TNext[p] = bSeed ? SeedC[(z * Dim.Y + y) * Dim.X + x] : 0.f;
+    }
+}
+
+bool FThermoForgeDiffusionGrid::IsValidFor(const UThermoForgeFieldAsset* InField) const
+{
+    return InField && Field.Get() == InField && InField->Dim == Dim && PDim.X > 0
+        && FMath::IsNearlyEqual(FMath::Max(1.f, InField->CellSizeCm), CellSizeCm)
+        && InField->GetGridFrame().Equals(Frame);
+}
+
+void FThermoForgeDiffusionGrid::RefreshConductance(const UThermoForgeFieldAsset* InField)
+{
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    if (!InField || N <= 0 || InField->WallPermeability01.Num() != N) return;
+
+    const int32 PN = PDim.X * PDim.Y * PDim.Z;
+    Gx.SetNumZeroed(PN);
+    Gy.SetNumZeroed(PN);
+    Gz.SetNumZeroed(PN);
+    WindMask.SetNumZeroed(PN);
+
+    RefreshConductance(InField, FIntVector::ZeroValue, Dim - FIntVector(1));
+}
+
+void FThermoForgeDiffusionGrid::RefreshConductance(const UThermoForgeFieldAsset* InField, const FIntVector& CellMin, const FIntVector& CellMax)
+{
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    if (!InField || N <= 0 || InField->WallPermeability01.Num() != N || Gx.Num() != PDim.X * PDim.Y * PDim.Z) return;
+
+    // The -X/-Y/-Z neighbours own the faces into the range
+    const FIntVector Lo(FMath::Max(0, CellMin.X - 1), FMath::Max(0, CellMin.Y - 1), FMath::Max(0, CellMin.Z - 1));
+    const FIntVector Hi(FMath::Min(Dim.X - 1, CellMax.X), FMath::Min(Dim.Y - 1, CellMax.Y), FMath::Min(Dim.Z - 1, CellMax.Z));
+
+    const FThermoPermOverrideLayer* Overrides = PermOverrides.Get();
+    auto Perm = [InField, Overrides, this](int32 x, int32 y, int32 z)
+    {
+        const int32 i = (z * Dim.Y + y) * Dim.X + x;
+        const float Baked = InField->WallPermeability01[i];
+        return FMath::Clamp(Overrides ? Overrides->GetWallPerm(i, Baked) : Baked, 0.f, 1.f);
+    };
+    auto Face = [](float A, float B){ return (A + B) > 0.f ? 2.f * A * B / (A + B) : 0.f; };
+
+    // Border faces stay 0: no flux through the grid boundary
+    for (int32 z=Lo.Z; z<=Hi.Z; ++z)
+    for (int32 y=Lo.Y; y<=Hi.Y; ++y)
+    for (int32 x=Lo.X; x<=Hi.X; ++x)
+    {
+        const int32 p = Padded(x,y,z);
+        const float P = Perm(x,y,z);
+        Gx[p] = (x+1 < Dim.X) ? Face(P, Perm(x+1,y,z)) : 0.f;
+        Gy[p] = (y+1 < Dim.Y) ? Face(P, Perm(x,y+1,z)) : 0.f;
+        Gz[p] = (z+1 < Dim.Z) ? Face(P, Perm(x,y,z+1)) : 0.f;
+    }
+
+    // Wind only moves air under open sky; without a sky channel nothing drifts
+    if (InField->SkyView01.Num() == N)
+    {
+        for (int32 z=Lo.Z; z<=Hi.Z; ++z)
+        for (int32 y=Lo.Y; y<=Hi.Y; ++y)
+        for (int32 x=Lo.X; x<=Hi.X; ++x)
+        {
+            WindMask[Padded(x,y,z)] = FMath::Clamp(InField->SkyView01[(z * Dim.Y + y) * Dim.X + x], 0.f, 1.f);
+        }
+    }
+    bWindDirty = true;
+}
+
+void FThermoForgeDiffusionGrid::SetWind(const FVector& InWindWS, const TSharedPtr<const FThermoWindField>& InWindField)
+{
+    if (InWindWS.Equals(WindWS) && InWindField == WindField) return;
+    WindWS     = InWindWS;
+    WindField  = InWindField;
+    bWindDirty = true;
+}
+
+// Cell-centred trilinear lookup in a coarse wind field; U01 is the position across the volume box (0..1 per axis)
+static FVector TF_SampleWindField(const FThermoWindField& F, const FVector& U01)
+{
+    auto Axis = [](double u, int32 n, int32& i0, int32& i1, float& a)
+    {
+        const double c = FMath::Clamp(u * n - 0.5, 0.0, double(n - 1));
+        i0 = FMath::FloorToInt(c);
+        i1 = FMath::Min(i0 + 1, n - 1);
+        a  = float(c - i0);
+    };
+    int32 x0, x1, y0, y1, z0, z1; float ax, ay, az;
+    Axis(U01.X, F.WindDim.X, x0, x1, ax);
+    Axis(U01.Y, F.WindDim.Y, y0, y1, ay);
+    Axis(U01.Z, F.WindDim.Z, z0, z1, az);
+
+    auto At = [&F](int32 x, int32 y, int32 z){ return F.WindCmPerSec[(z * F.WindDim.Y + y) * F.WindDim.X + x]; };
+    const FVector3f V = FMath::Lerp(
+        FMath::Lerp(FMath::Lerp(At(x0,y0,z0), At(x1,y0,z0), ax), FMath::Lerp(At(x0,y1,z0), At(x1,y1,z0), ax), ay),
+        FMath::Lerp(FMath::Lerp(At(x0,y0,z1), At(x1,y0,z1), ax), FMath::Lerp(At(x0,y1,z1), At(x1,y1,z1), ax), ay), az);
+    return FVector(V);
+}
+
+void FThermoForgeDiffusionGrid::RebuildCellWind()
+{
+    bWindDirty = false;
+    CellWind.Empty();
+    MaxWindCells = 0.f;
+    if (PDim.X <= 0) return;
+
+    // Grid axes, cells per second
+    WindLocal = FVector3f(InvFrame.TransformVector(WindWS) / CellSizeCm);
+    MaxWindCells = WindLocal.GetAbsMax();
+
+    if (!WindField.IsValid() || !WindField->IsValid()) return;
+
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    CellWind.SetNumUninitialized(N);
+    MaxWindCells = 0.f;
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    for (int32 x=0; x<Dim.X; ++x)
+    {
+        const FVector U01((x + 0.5) / Dim.X, (y + 0.5) / Dim.Y, (z + 0.5) / Dim.Z);
+        const FVector3f Local(InvFrame.TransformVector(TF_SampleWindField(*WindField, U01)) / CellSizeCm);
+        const FVector3f W = (WindLocal + Local) * WindMask[Padded(x,y,z)];
+
+        CellWind[(z * Dim.Y + y) * Dim.X + x] = W;
+        MaxWindCells = FMath::Max(MaxWindCells, W.GetAbsMax());
+    }
+}
+
+void FThermoForgeDiffusionGrid::FillGuards()
+{
+    float* Tp = T.GetData();
+    for (int32 z=-1; z<=Dim.Z; ++z)
+    for (int32 y=-1; y<=Dim.Y; ++y)
+    {
+        const int32 cz = FMath::Clamp(z, 0, Dim.Z - 1), cy = FMath::Clamp(y, 0, Dim.Y - 1);
+        if (z < 0 || z >= Dim.Z || y < 0 || y >= Dim.Y)
+        {
+            for (int32 x=-1; x<=Dim.X; ++x) Tp[Padded(x,y,z)] = Tp[Padded(FMath::Clamp(x, 0, Dim.X - 1), cy, cz)];
+        }
+        else
+        {
+            Tp[Padded(-1,y,z)]    = Tp[Padded(0,y,z)];
+            Tp[Padded(Dim.X,y,z)] = Tp[Padded(Dim.X - 1,y,z)];
+        }
+    }
+}
+
+// One row of the stencil, four cells per iteration. Neighbour reads stay inside the padded arrays.
+static void TF_DiffuseRow(const float* RESTRICT Tin, float* RESTRICT Tout,
+    const float* RESTRICT Gx, const float* RESTRICT Gy, const float* RESTRICT Gz,
+    const float* RESTRICT Target, int32 Count, int32 SY, int32 SZ, float R, float K)
+{
+    const VectorRegister4Float VR = VectorSetFloat1(R);
+    const VectorRegister4Float VK = VectorSetFloat1(K);
+
+    int32 x = 0;
+    for (; x + 4 <= Count; x += 4)
+    {
+        const float* Tc = Tin + x;
+        const VectorRegister4Float C = VectorLoad(Tc);
+
+        VectorRegister4Float F = VectorMultiply(VectorLoad(Gx + x), VectorSubtract(VectorLoad(Tc + 1), C));
+        F = VectorMultiplyAdd(VectorLoad(Gx + x - 1),  VectorSubtract(VectorLoad(Tc - 1),  C), F);
+        F = VectorMultiplyAdd(VectorLoad(Gy + x),      VectorSubtract(VectorLoad(Tc + SY), C), F);
+        F = VectorMultiplyAdd(VectorLoad(Gy + x - SY), VectorSubtract(VectorLoad(Tc - SY), C), F);
+        F = VectorMultiplyAdd(VectorLoad(Gz + x),      VectorSubtract(VectorLoad(Tc + SZ), C), F);
+        F = VectorMultiplyAdd(VectorLoad(Gz + x - SZ), VectorSubtract(VectorLoad(Tc - SZ), C), F);
+
+        VectorRegister4Float Out = VectorMultiplyAdd(VR, F, C);
+        Out = VectorMultiplyAdd(VK, VectorSubtract(VectorLoad(Target + x), C), Out);
+        VectorStore(Out, Tout + x);
+    }
+    for (; x < Count; ++x)
+    {
+        const float* Tc = Tin + x;
+        const float C = *Tc;
+        const float F = Gx[x]      * (Tc[1]   - C) + Gx[x - 1]  * (Tc[-1]  - C)
+                      + Gy[x]      * (Tc[SY]  - C) + Gy[x - SY] * (Tc[-SY] - C)
+                      + Gz[x]      * (Tc[SZ]  - C) + Gz[x - SZ] * (Tc[-SZ] - C);
+        Tout[x] = C + R * F + K * (Target[x] - C);
+    }
+}
+
+// One row of a uniform advection pass: the shared 8-tap upwind sample, blended in by the cell's wind mask
+static void TF_AdvectRow(const float* RESTRICT Tin, float* RESTRICT Tout, const float* RESTRICT Mask,
+    const int32* RESTRICT Off, const float* RESTRICT W, int32 Count)
+{
+    VectorRegister4Float VW[8];
+    for (int32 k=0; k<8; ++k) VW[k] = VectorSetFloat1(W[k]);
+
+    int32 x = 0;
+    for (; x + 4 <= Count; x += 4)
+    {
+        const float* Tc = Tin + x;
+        const VectorRegister4Float C = VectorLoad(Tc);
+
+        VectorRegister4Float A = VectorMultiply(VW[0], VectorLoad(Tc + Off[0]));
+        for (int32 k=1; k<8; ++k) A = VectorMultiplyAdd(VW[k], VectorLoad(Tc + Off[k]), A);
+
+        VectorStore(VectorMultiplyAdd(VectorLoad(Mask + x), VectorSubtract(A, C), C), Tout + x);
+    }
+    for (; x < Count; ++x)
+    {
+        const float* Tc = Tin + x;
+        float A = 0.f;
+        for (int32 k=0; k<8; ++k) A += W[k] * Tc[Off[k]];
+        Tout[x] = Tc[0] + Mask[x] * (A - Tc[0]);
+    }
+}
+
+void FThermoForgeDiffusionGrid::Advect(float Dt)
+{
+    FillGuards();
+
+    const int32 SY = PDim.X;
+    const int32 SZ = PDim.X * PDim.Y;
+    const float* Tin = T.GetData();
+    float* Tout = TNext.GetData();
+
+    if (CellWind.Num() == 0)
+    {
+        // Upwind point is the same offset everywhere; the CFL split keeps it within one cell, so inside the guard
+        const FVector3f Back = -WindLocal * Dt;
+        const int32 ox = FMath::FloorToInt(Back.X), oy = FMath::FloorToInt(Back.Y), oz = FMath::FloorToInt(Back.Z);
+        const float fx = Back.X - ox, fy = Back.Y - oy, fz = Back.Z - oz;
+
+        int32 Off[8]; float W[8];
+        for (int32 k=0; k<8; ++k)
+        {
+            const int32 i = k & 1, j = (k >> 1) & 1, l = (k >> 2) & 1;
+            Off[k] = (ox + i) + (oy + j) * SY + (oz + l) * SZ;
+            W[k]   = (i ? fx : 1.f - fx) * (j ? fy : 1.f - fy) * (l ? fz : 1.f - fz);
+        }
+
+        ParallelFor(Dim.Z, [&](int32 z)
+        {
+            for (int32 y=0; y<Dim.Y; ++y)
+            {
+                const int32 p = Padded(0, y, z);
+                TF_AdvectRow(Tin + p, Tout + p, WindMask.GetData() + p, Off, W, Dim.X);
+            }
+        });
+    }
+    else
+    {
+        // Per-cell upwind point, clamped to the grid so the +1 taps land at most in the first guard layer
+        ParallelFor(Dim.Z, [&](int32 z)
+        {
+            for (int32 y=0; y<Dim.Y; ++y)
+            for (int32 x=0; x<Dim.X; ++x)
+            {
+                const FVector3f D = CellWind[(z * Dim.Y + y) * Dim.X + x] * Dt;
+                const float bx = FMath::Clamp(x - D.X, 0.f, float(Dim.X - 1));
+                const float by = FMath::Clamp(y - D.Y, 0.f, float(Dim.Y - 1));
+                const float bz = FMath::Clamp(z - D.Z, 0.f, float(Dim.Z - 1));
+                const int32 x0 = FMath::FloorToInt(bx), y0 = FMath::FloorToInt(by), z0 = FMath::FloorToInt(bz);
+                const float ax = bx - x0, ay = by - y0, az = bz - z0;
+
+                const float* S = Tin + Padded(x0, y0, z0);
+                const float A0 = FMath::Lerp(FMath::Lerp(S[0],  S[1],      ax), FMath::Lerp(S[SY],      S[SY + 1],      ax), ay);
+                const float A1 = FMath::Lerp(FMath::Lerp(S[SZ], S[SZ + 1], ax), FMath::Lerp(S[SZ + SY], S[SZ + SY + 1], ax), ay);
+                Tout[Padded(x, y, z)] = FMath::Lerp(A0, A1, az);
+            }
+        });
+    }
+
+    Swap(T, TNext);
+}
+
+void FThermoForgeDiffusionGrid::Step(float R, float K, TConstArrayView<float> TargetC)
+{
+    const int32 SY = PDim.X;
+    const int32 SZ = PDim.X * PDim.Y;
+    const float* Tin = T.GetData();
+    float* Tout = TNext.GetData();
+
+    // One z slab per task; slabs write disjoint rows of TNext
+    ParallelFor(Dim.Z, [&](int32 z)
+    {
+        for (int32 y=0; y<Dim.Y; ++y)
+        {
+            const int32 p = Padded(0, y, z);
+            TF_DiffuseRow(Tin + p, Tout + p, Gx.GetData() + p, Gy.GetData() + p, Gz.GetData() + p,
+                TargetC.GetData() + (z * Dim.Y + y) * Dim.X, Dim.X, SY, SZ, R, K);
+        }
+    });
+
+    Swap(T, TNext);
+}
+
+int32 FThermoForgeDiffusionGrid::Advance(float DeltaSeconds, const FParams& Params, TConstArrayView<float> TargetC)
+{
+    if (PDim.X <= 0 || TargetC.Num() != Dim.X * Dim.Y * Dim.Z || DeltaSeconds <= 0.f) return 0;
+
+    const float Dt = FMath::Max(1e-3f, Params.StepSeconds);
+    const int32 MaxSteps = FMath::Max(1, Params.MaxStepsPerAdvance);
+
+    // Fixed steps; time beyond the cap is dropped rather than spiralling
+    Accumulator = FMath::Min(Accumulator + DeltaSeconds, double(Dt) * MaxSteps);
+    const int32 Steps = FMath::FloorToInt(Accumulator / Dt);
+    if (Steps <= 0) return 0;
+    Accumulator -= double(Steps) * Dt;
+
+    if (bWindDirty) RebuildCellWind();
+
+    // Split each step until the explicit update is stable and the wind moves less than a cell per pass
+    float R = FMath::Max(0.f, Params.DiffusivityCm2PerSec) * Dt / FMath::Square(CellSizeCm);
+    float K = Dt / FMath::Max(1e-3f, Params.ExchangeSeconds);
+    float WindScale = 1.f;
+    const int32 SplitD = FMath::Max(1, FMath::CeilToInt((6.f * R + K) / TF_DIFFUSION_STABLE));
+    const int32 SplitA = FMath::Max(1, FMath::CeilToInt(MaxWindCells * Dt / TF_DIFFUSION_STABLE));
+    int32 Split = FMath::Max(SplitD, SplitA);
+    if (Split > TF_DIFFUSION_MAX_SPLIT)
+    {
+        if (!bWarnedUnstable)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Diffusion: step too large for %.0f cm cells; clamping diffusivity and wind."), CellSizeCm);
+            bWarnedUnstable = true;
+        }
+        Split = TF_DIFFUSION_MAX_SPLIT;
+        if (SplitD > Split)
+        {
+            const float Scale = (TF_DIFFUSION_STABLE * Split) / (6.f * R + K);
+            R *= Scale;
+            K *= Scale;
+        }
+        if (SplitA > Split)
+        {
+            WindScale = (TF_DIFFUSION_STABLE * Split) / (MaxWindCells * Dt);
+        }
+    }
+    R /= Split;
+    K /= Split;
+    const float AdvectDt = Dt * WindScale / Split;
+
+    for (int32 s=0; s<Steps * Split; ++s)
+    {
+        Step(R, K, TargetC);
+        if (MaxWindCells > 0.f) Advect(AdvectDt);
+    }
+    return Steps;
+}
+
+int32 FThermoForgeDiffusionGrid::SolveEquilibrium(const FParams& Params, TConstArrayView<float> TargetC, const FThermoMultigridParams& Solver, float* OutResidualC)
+{
+    bSettlePending = false;
+
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    if (PDim.X <= 0 || TargetC.Num() != N) return 0;
+
+    // Steady state of the stencil: T + (D·tau/h²) Σ G (T - T_n) = Target
+    TArray<float> UGx, UGy, UGz;
+    UGx.SetNumUninitialized(N);
+    UGy.SetNumUninitialized(N);
+    UGz.SetNumUninitialized(N);
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    for (int32 x=0; x<Dim.X; ++x)
+    {
+        const int32 i = (z * Dim.Y + y) * Dim.X + x;
+        const int32 p = Padded(x,y,z);
+        UGx[i] = Gx[p];
+        UGy[i] = Gy[p];
+        UGz[i] = Gz[p];
+    }
+
+    const float Beta = FMath::Max(0.f, Params.DiffusivityCm2PerSec) * FMath::Max(1e-3f, Params.ExchangeSeconds) / FMath::Square(CellSizeCm);
+
+    FThermoForgeMultigrid MG;
+    MG.Build(Dim, UGx, UGy, UGz, Beta);
+
+    TArray<float> X;
+    CopyTemperatures(X);
+    float Residual = 0.f;
+    const int32 Cycles = MG.Solve(TargetC, X, Solver, &Residual);
+
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    {
+        const int32 p = Padded(0, y, z);
+        FMemory::Memcpy(T.GetData() + p, X.GetData() + (z * Dim.Y + y) * Dim.X, Dim.X * sizeof(float));
+        FMemory::Memcpy(TNext.GetData() + p, X.GetData() + (z * Dim.Y + y) * Dim.X, Dim.X * sizeof(float));
+    }
+    Accumulator = 0.0;
+
+    if (OutResidualC) *OutResidualC = Residual;
+    return Cycles;
+}
+
+bool FThermoForgeDiffusionGrid::SampleTemp(const FVector& P, float& OutTempC) const
+{
+    if (PDim.X <= 0) return false;
+
+    FIntVector Cells[8]; float W[8];
+    if (!FThermoForgeComposedGrid::TrilinearCells(InvFrame.TransformPosition(P), CellSizeCm, Dim, Cells, W)) return false;
+
+    float Sum = 0.f;
+    for (int32 k=0; k<8; ++k)
+    {
+        Sum += W[k] * T[Padded(Cells[k].X, Cells[k].Y, Cells[k].Z)];
+    }
+    OutTempC = Sum;
+    return true;
+}
+
+void FThermoForgeDiffusionGrid::CopyTemperatures(TArray<float>& OutTempC) const
+{
+    OutTempC.SetNumUninitialized(Dim.X * Dim.Y * Dim.Z);
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    {
+        FMemory::Memcpy(OutTempC.GetData() + (z * Dim.Y + y) * Dim.X, T.GetData() + Padded(0, y, z), Dim.X * sizeof(float));
+    }
+}
@@ -1,10 +1,382 @@
 ﻿#include "ThermoForgeFieldAsset.h"
 
+#include "ThermoForgeProjectSettings.h"
+
+#include "Algo/Sort.h"
+#include "Misc/Crc.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/CustomVersion.h"
+#include "UObject/ObjectSaveContext.h"
+
+struct FThermoForgeFieldVersion
+{
+    enum Type
+    {
+        BeforeCustomVersion = 0,
+        // Optional cooked payload after the tagged properties
+        CookedPayload,
+        // Cooked checksum covers the pyramid levels too
+        CookedPyramidChecksum,
+
+        VersionPlusOne,
+        LatestVersion = VersionPlusOne - 1
+    };
+
+    static const FGuid GUID;
+};
+
+const FGuid FThermoForgeFieldVersion::GUID(0x6E1F2A4B, 0x93C04D7E, 0xA1B25F08, 0x3D7C9E61);
+static FCustomVersionRegistration GRegisterThermoForgeFieldVersion(
+    FThermoForgeFieldVersion::GUID, FThermoForgeFieldVersion::LatestVersion, TEXT("ThermoForgeField"));
+
 UThermoForgeFieldAsset::UThermoForgeFieldAsset()
 {
     GridFrameWS = FTransform::Identity;
 }
 
+void UThermoForgeFieldAsset::Serialize(FArchive& Ar)
+{
+    Ar.UsingCustomVersion(FThermoForgeFieldVersion::GUID);
+
+#if WITH_EDITOR
+    if (Ar.IsSaving() && Ar.IsCooking() && !CookedField.bValid
+        && GetDefault<UThermoForgeProjectSettings>()->bOptimizeFieldsOnCook)
+    {
+        BuildCookedField();
+    }
+#endif
+
+    bool bCooked = Ar.IsSaving() && Ar.IsCooking() && CookedField.bValid;
+
+    if (bCooked)
+    {
+        // Channels travel in the packed payload instead of as float properties
+        TArray<float> Sky, Wall, Indoor;
+        Swap(Sky, SkyView01);
+        Swap(Wall, WallPermeability01);
+        Swap(Indoor, Indoorness01);
+        Super::Serialize(Ar);
+        Swap(Sky, SkyView01);
+        Swap(Wall, WallPermeability01);
+        Swap(Indoor, Indoorness01);
+    }
+    else
+    {
+        Super::Serialize(Ar);
+    }
+
+    if (Ar.CustomVer(FThermoForgeFieldVersion::GUID) < FThermoForgeFieldVersion::CookedPayload) return;
+
+    Ar << bCooked;
+    if (bCooked)
+    {
+        SerializeCookedField(Ar);
+        // A rejected payload leaves the channels empty, which every consumer treats as "not baked"
+        if (Ar.IsLoading() && !DecodeCookedField())
+        {
+            SkyView01.Empty();
+            WallPermeability01.Empty();
+            Indoorness01.Empty();
+            SkyViewHierarchy.Empty();
+        }
+    }
+}
+
+void UThermoForgeFieldAsset::PostLoad()
+{
+    Super::PostLoad();
+
+    // Cooked fields arrive with the pyramid already built
+    if (!HasSkyViewHierarchy()) BuildSkyViewHierarchy();
+}
+
+#if WITH_EDITOR
+void UThermoForgeFieldAsset::PreSave(FObjectPreSaveContext SaveContext)
+{
+    Super::PreSave(SaveContext);
+
+    CookedField = FThermoForgeCookedField();
+    if (SaveContext.IsCooking() && GetDefault<UThermoForgeProjectSettings>()->bOptimizeFieldsOnCook)
+    {
+        BuildCookedField();
+    }
+}
+
+void UThermoForgeFieldAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+    RebuildDerivedData();
+}
+#endif
+
+void UThermoForgeFieldAsset::RebuildDerivedData()
+{
+    CookedField = FThermoForgeCookedField();
+    BuildSkyViewHierarchy();
+
+    // Summed-volume tables come back on their channel's next query
+    FScopeLock Lock(&SummedVolumeLock);
+    for (TArray<int64>& T : SummedVolume) T.Empty();
+}
+
+// ---------- Patches ----------
+FThermoFieldPatchedDelegate UThermoForgeFieldAsset::OnFieldPatched;
+
+bool UThermoForgeFieldAsset::ApplyPatch(const FThermoForgeFieldPatch& Patch)
+{
+    if (!Patch.Matches(*this))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Patch for %s does not match grid of %s"),
+               *Patch.TargetAsset, *GetPathName());
+        return false;
+    }
+
+    // Patched cells need not follow the formula any more
+    MaterializeIndoorness();
+
+    for (const FThermoForgeFieldPatchTile& T : Patch.Tiles)
+    {
+        FIntVector Min, Max;
+        Patch.TileRange(T.Tile, Min, Max);
+
+        const int32 Count = FMath::Max(0, Max.X - Min.X) * FMath::Max(0, Max.Y - Min.Y) * FMath::Max(0, Max.Z - Min.Z);
+        if (Count == 0 || T.SkyView01.Num() != Count || T.WallPermeability01.Num() != Count || T.Indoorness01.Num() != Count)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Skipping malformed patch tile %s"), *T.Tile.ToString());
+            continue;
+        }
+
+        int32 k = 0;
+        for (int32 z=Min.Z; z<Max.Z; ++z)
+        for (int32 y=Min.Y; y<Max.Y; ++y)
+        for (int32 x=Min.X; x<Max.X; ++x, ++k)
+        {
+            const int32 i = Index(x,y,z);
+            SkyView01[i]          = T.SkyView01[k];
+            WallPermeability01[i] = T.WallPermeability01[k];
+            Indoorness01[i]       = T.Indoorness01[k];
+        }
+    }
+
+    RebuildDerivedData();
+    OnFieldPatched.Broadcast(this);
+    return true;
+}
+
+// ---------- Cooked payload ----------
+template<typename FuncType>
+void UThermoForgeFieldAsset::ForEachCellInBrickOrder(FuncType&& Func) const
+{
+    for (int32 bz=0; bz<Dim.Z; bz+=BrickSize)
+    for (int32 by=0; by<Dim.Y; by+=BrickSize)
+    for (int32 bx=0; bx<Dim.X; bx+=BrickSize)
+    {
+        const int32 ez = FMath::Min(bz + BrickSize, Dim.Z);
+        const int32 ey = FMath::Min(by + BrickSize, Dim.Y);
+        const int32 ex = FMath::Min(bx + BrickSize, Dim.X);
+        for (int32 z=bz; z<ez; ++z)
+        for (int32 y=by; y<ey; ++y)
+        for (int32 x=bx; x<ex; ++x)
+        {
+            Func(Index(x,y,z));
+        }
+    }
+}
+
+static FORCEINLINE uint16 TF_Quantize01(float V)
+{
+    return uint16(FMath::RoundToInt(FMath::Clamp(V, 0.f, 1.f) * 65535.f));
+}
+
+static FORCEINLINE float TF_Dequantize01(uint16 Q)
+{
+    return float(Q) / 65535.f;
+}
+
+#if WITH_EDITOR
+void UThermoForgeFieldAsset::BuildCookedField()
+{
+    CookedField = FThermoForgeCookedField();
+
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    if (N <= 0 || SkyView01.Num() != N || WallPermeability01.Num() != N) return;
+
+    // Indoorness is redundant when it is exactly the bake formula
+    bool bDropIndoor = true;
+    if (Indoorness01.Num() == N)
+    {
+        for (int32 i=0; i<N && bDropIndoor; ++i)
+        {
+            const float Expect = (1.f - SkyView01[i]) * (1.f - WallPermeability01[i]);
+            bDropIndoor = FMath::Abs(Indoorness01[i] - Expect) <= CookTolerance;
+        }
+    }
+
+    FThermoForgeCookedField C;
+    C.bHasIndoorness = !bDropIndoor;
+
+    const TArray<float>* Channels[3] = { &SkyView01, &WallPermeability01, &Indoorness01 };
+    const int32 NumChannels = C.bHasIndoorness ? 3 : 2;
+
+    C.Quantized.Reserve(N * NumChannels);
+    for (int32 c=0; c<NumChannels; ++c)
+    {
+        const TArray<float>& Src = *Channels[c];
+        ForEachCellInBrickOrder([&](int32 Lin){ C.Quantized.Add(TF_Quantize01(Src[Lin])); });
+    }
+
+    // Verify by decoding exactly as the runtime will and comparing to the editor floats
+    {
+        TArray<float> Sky, Wall;
+        Sky.SetNumUninitialized(N);
+        Wall.SetNumUninitialized(N);
+        int32 k = 0;
+        ForEachCellInBrickOrder([&](int32 Lin){ Sky[Lin]  = TF_Dequantize01(C.Quantized[k++]); });
+        ForEachCellInBrickOrder([&](int32 Lin){ Wall[Lin] = TF_Dequantize01(C.Quantized[k++]); });
+
+        float MaxErr = 0.f;
+        for (int32 i=0; i<N; ++i)
+        {
+            MaxErr = FMath::Max(MaxErr, FMath::Abs(Sky[i]  - SkyView01[i]));
+            MaxErr = FMath::Max(MaxErr, FMath::Abs(Wall[i] - WallPermeability01[i]));
+        }
+
+        if (Indoorness01.Num() == N)
+        {
+            if (C.bHasIndoorness)
+            {
+                ForEachCellInBrickOrder([&](int32 Lin)
+                {
+                    MaxErr = FMath::Max(MaxErr, FMath::Abs(TF_Dequantize01(C.Quantized[k++]) - Indoorness01[Lin]));
+                });
+            }
+            else
+            {
+                for (int32 i=0; i<N; ++i)
+                {
+                    MaxErr = FMath::Max(MaxErr, FMath::Abs((1.f - Sky[i]) * (1.f - Wall[i]) - Indoorness01[i]));
+                }
+            }
+        }
+        C.MaxError = MaxErr;
+
+        if (MaxErr > CookTolerance)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] %s: packed field error %.6f exceeds %.6f, cooking raw floats"),
+                   *GetName(), MaxErr, CookTolerance);
+            return;
+        }
+
+        // Pyramid from the decoded values so its bounds hold for what the runtime sees
+        BuildMinMaxPyramid(Sky, Dim, C.SkyViewHierarchy);
+    }
+
+    C.Checksum = ComputeCookedChecksum(C);
+
+    C.bValid = true;
+    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] %s: cooked %d cells, %d channels, max error %.6f, crc %08x"),
+           *GetName(), N, NumChannels, C.MaxError, C.Checksum);
+
+    CookedField = MoveTemp(C);
+}
+#endif
+
+void UThermoForgeFieldAsset::SerializeCookedField(FArchive& Ar)
+{
+    FThermoForgeCookedField& C = CookedField;
+
+    Ar << C.bHasIndoorness;
+    Ar << C.Checksum;
+    Ar << C.MaxError;
+    Ar << C.Quantized;
+
+    int32 NumLevels = C.SkyViewHierarchy.Num();
+    Ar << NumLevels;
+    if (Ar.IsLoading())
+    {
+        C.SkyViewHierarchy.Reset();
+        C.SkyViewHierarchy.SetNum(FMath::Max(0, NumLevels));
+    }
+    for (FThermoForgeMinMaxLevel& L : C.SkyViewHierarchy)
+    {
+        Ar << L.Dim << L.BrickCells << L.Min << L.Max;
+    }
+
+    if (Ar.IsLoading())
+    {
+        C.bChecksumCoversPyramid = Ar.CustomVer(FThermoForgeFieldVersion::GUID) >= FThermoForgeFieldVersion::CookedPyramidChecksum;
+    }
+    C.bValid = !Ar.IsError();
+}
+
+uint32 UThermoForgeFieldAsset::ComputeCookedChecksum(const FThermoForgeCookedField& Cooked)
+{
+    uint32 Crc = FCrc::MemCrc32(Cooked.Quantized.GetData(), Cooked.Quantized.Num() * sizeof(uint16));
+    if (!Cooked.bChecksumCoversPyramid) return Crc;
+
+    const int32 NumLevels = Cooked.SkyViewHierarchy.Num();
+    Crc = FCrc::MemCrc32(&NumLevels, sizeof(NumLevels), Crc);
+    for (const FThermoForgeMinMaxLevel& L : Cooked.SkyViewHierarchy)
+    {
+        const int32 Header[5] = { L.Dim.X, L.Dim.Y, L.Dim.Z, L.BrickCells, L.Min.Num() };
+        Crc = FCrc::MemCrc32(Header, sizeof(Header), Crc);
+        Crc = FCrc::MemCrc32(L.Min.GetData(), L.Min.Num() * sizeof(float), Crc);
+        Crc = FCrc::MemCrc32(L.Max.GetData(), L.Max.Num() * sizeof(float), Crc);
+    }
+    return Crc;
+}
+
+bool UThermoForgeFieldAsset::DecodeCookedField()
+{
+    FThermoForgeCookedField C = MoveTemp(CookedField);
+    CookedField = FThermoForgeCookedField();
+
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    const int32 NumChannels = C.bHasIndoorness ? 3 : 2;
+    if (!C.bValid || N <= 0 || C.Quantized.Num() != N * NumChannels)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[ThermoForge] %s: cooked field payload does not match grid %s"),
+               *GetName(), *Dim.ToString());
+        return false;
+    }
+
+    const uint32 Crc = ComputeCookedChecksum(C);
+    if (Crc != C.Checksum)
+    {
+        UE_LOG(LogTemp, Error, TEXT("[ThermoForge] %s: cooked field checksum mismatch (%08x != %08x); field left empty"),
+               *GetName(), Crc, C.Checksum);
+        return false;
+    }
+
+    SkyView01.SetNumUninitialized(N);
+    WallPermeability01.SetNumUninitialized(N);
+
+    int32 k = 0;
+    ForEachCellInBrickOrder([&](int32 Lin){ SkyView01[Lin] = TF_Dequantize01(C.Quantized[k++]); });
+    ForEachCellInBrickOrder([&](int32 Lin){ WallPermeability01[Lin] = TF_Dequantize01(C.Quantized[k++]); });
+
+    // A dropped Indoorness stays derived: 4 bytes per cell the accessors compute from the other two
+    Indoorness01.Empty();
+    if (C.bHasIndoorness)
+    {
+        Indoorness01.SetNumUninitialized(N);
+        ForEachCellInBrickOrder([&](int32 Lin){ Indoorness01[Lin] = TF_Dequantize01(C.Quantized[k++]); });
+    }
+
+    // The checksum vouches for the bytes, not for the layout the cook wrote
+    if (IsMinMaxPyramidValid(C.SkyViewHierarchy, Dim))
+    {
+        SkyViewHierarchy = MoveTemp(C.SkyViewHierarchy);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] %s: cooked pyramid does not match grid %s; rebuilt from the decoded field"),
+               *GetName(), *Dim.ToString());
+        BuildSkyViewHierarchy();
+    }
+    return true;
+}
+
 bool UThermoForgeFieldAsset::WorldToCellTrilinear(const FVector& P, int32& ix, int32& iy, int32& iz, FVector& Alpha) const
 {
     if (Dim.X <= 1 || Dim.Y <= 1 || Dim.Z <= 1 || CellSizeCm <= 0.f) return false;
@@ -28,22 +400,23 @@ bool UThermoForgeFieldAsset::WorldToCellTrilinear(const FVector& P, int32& ix, i
     return true;
 }
 
-static float TF_TrilinearFetch(
-    const TArray<float>& Arr, const FIntVector& Dim,
+template<typename FetchFn>
+static float TF_TrilinearFetchBy(
+    FetchFn&& Fetch, const FIntVector& Dim,
     int32 x0,int32 y0,int32 z0, const FVector& A)
 {
     auto I = [&](int32 x,int32 y,int32 z){ return (z*Dim.Y + y)*Dim.X + x; };
 
     const int32 x1=x0+1, y1=y0+1, z1=z0+1;
 
-    const float c000 = Arr.IsValidIndex(I(x0,y0,z0)) ? Arr[I(x0,y0,z0)] : 0.f;
-    const float c100 = Arr.IsValidIndex(I(x1,y0,z0)) ? Arr[I(x1,y0,z0)] : 0.f;
-    const float c010 = Arr.IsValidIndex(I(x0,y1,z0)) ? Arr[I(x0,y1,z0)] : 0.f;
-    const float c110 = Arr.IsValidIndex(I(x1,y1,z0)) ? Arr[I(x1,y1,z0)] : 0.f;
-    const float c001 = Arr.IsValidIndex(I(x0,y0,z1)) ? Arr[I(x0,y0,z1)] : 0.f;
-    const float c101 = Arr.IsValidIndex(I(x1,y0,z1)) ? Arr[I(x1,y0,z1)] : 0.f;
-    const float c011 = Arr.IsValidIndex(I(x0,y1,z1)) ? Arr[I(x0,y1,z1)] : 0.f;
-    const float c111 = Arr.IsValidIndex(I(x1,y1,z1)) ? Arr[I(x1,y1,z1)] : 0.f;
+    const float c000 = Fetch(I(x0,y0,z0));
+    const float c100 = Fetch(I(x1,y0,z0));
+    const float c010 = Fetch(I(x0,y1,z0));
+    const float c110 = Fetch(I(x1,y1,z0));
+    const float c001 = Fetch(I(x0,y0,z1));
+    const float c101 = Fetch(I(x1,y0,z1));
+    const float c011 = Fetch(I(x0,y1,z1));
+    const float c111 = Fetch(I(x1,y1,z1));
 
     const float cx00 = FMath::Lerp(c000, c100, A.X);
     const float cx10 = FMath::Lerp(c010, c110, A.X);
@@ -56,6 +429,13 @@ static float TF_TrilinearFetch(
     return FMath::Lerp(cxy0, cxy1, A.Z);
 }
 
+static float TF_TrilinearFetch(
+    const TArray<float>& Arr, const FIntVector& Dim,
+    int32 x0,int32 y0,int32 z0, const FVector& A)
+{
+    return TF_TrilinearFetchBy([&Arr](int32 i){ return Arr.IsValidIndex(i) ? Arr[i] : 0.f; }, Dim, x0,y0,z0, A);
+}
+
 float UThermoForgeFieldAsset::SampleSkyView01(const FVector& WorldPos) const
 {
     int32 ix,iy,iz; FVector A;
@@ -74,6 +454,10 @@ float UThermoForgeFieldAsset::SampleIndoorness01(const FVector& WorldPos) const
 {
     int32 ix,iy,iz; FVector A;
     if (!WorldToCellTrilinear(WorldPos, ix,iy,iz, A)) return 0.f;
+    if (IsIndoornessDerived())
+    {
+        return TF_TrilinearFetchBy([this](int32 i){ return GetIndoorByLinearIdx(i); }, Dim, ix,iy,iz, A);
+    }
     return TF_TrilinearFetch(Indoorness01, Dim, ix,iy,iz, A);
 }
 
@@ -95,5 +479,614 @@ float UThermoForgeFieldAsset::GetIndoorByLinearIdx(int32 Linear) const
 {
     const int32 Expect = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
     if (Linear < 0 || Linear >= Expect) return 0.f;
+    if (Indoorness01.Num() == 0 && SkyView01.IsValidIndex(Linear) && WallPermeability01.IsValidIndex(Linear))
+    {
+        return (1.f - SkyView01[Linear]) * (1.f - WallPermeability01[Linear]);
+    }
     return Indoorness01.IsValidIndex(Linear) ? Indoorness01[Linear] : 0.f;
 }
+
+bool UThermoForgeFieldAsset::IsIndoornessDerived() const
+{
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    return N > 0 && Indoorness01.Num() == 0 && SkyView01.Num() == N && WallPermeability01.Num() == N;
+}
+
+void UThermoForgeFieldAsset::MaterializeIndoorness()
+{
+    if (!IsIndoornessDerived()) return;
+
+    const int32 N = SkyView01.Num();
+    Indoorness01.SetNumUninitialized(N);
+    for (int32 i=0; i<N; ++i)
+    {
+        Indoorness01[i] = (1.f - SkyView01[i]) * (1.f - WallPermeability01[i]);
+    }
+}
+
+bool UThermoForgeFieldAsset::HasSunVisibility() const
+{
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    return N > 0 && SunVisibilitySH.Num() == N;
+}
+
+float UThermoForgeFieldAsset::GetSolarViewByLinearIdx(int32 Linear, const FVector& SunDirWS) const
+{
+    if (SunDirWS.IsZero() || !HasSunVisibility() || !SunVisibilitySH.IsValidIndex(Linear))
+    {
+        return FMath::Clamp(GetSkyViewByLinearIdx(Linear), 0.f, 1.f);
+    }
+    return ThermoEvalSunVisibility(SunVisibilitySH[Linear], SunDirWS);
+}
+
+const TArray<float>& UThermoForgeFieldAsset::GetChannel(EThermoFieldChannel Channel) const
+{
+    switch (Channel)
+    {
+        case EThermoFieldChannel::WallPermeability: return WallPermeability01;
+        case EThermoFieldChannel::Indoorness:       return Indoorness01;
+        case EThermoFieldChannel::SkyView:
+        default:                                    return SkyView01;
+    }
+}
+
+bool UThermoForgeFieldAsset::HasChannelValues(EThermoFieldChannel Channel) const
+{
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    if (N <= 0) return false;
+    if (Channel == EThermoFieldChannel::Indoorness && IsIndoornessDerived()) return true;
+    return GetChannel(Channel).Num() == N;
+}
+
+float UThermoForgeFieldAsset::ChannelAt(EThermoFieldChannel Channel, int32 Linear) const
+{
+    if (Channel == EThermoFieldChannel::Indoorness && Indoorness01.Num() == 0)
+    {
+        return (1.f - SkyView01[Linear]) * (1.f - WallPermeability01[Linear]);
+    }
+    return GetChannel(Channel)[Linear];
+}
+
+// ---------- Summed-volume tables ----------
+void UThermoForgeFieldAsset::BuildSummedVolumeTable(int32 Channel) const
+{
+    const EThermoFieldChannel Ch = static_cast<EThermoFieldChannel>(Channel);
+    if (!HasChannelValues(Ch)) return;
+
+    const int32 SX = Dim.X + 1, SY = Dim.Y + 1, SZ = Dim.Z + 1;
+    auto S = [SX, SY](int32 x, int32 y, int32 z){ return (z * SY + y) * SX + x; };
+    const double Scale = double(int64(1) << SummedVolumeFracBits);
+
+    TArray<int64>& T = SummedVolume[Channel];
+    T.SetNumZeroed(SX * SY * SZ);
+
+    // Inclusion–exclusion prefix sum in fixed point, so box sums cancel exactly; index 0 on each axis is the zero border
+    for (int32 z=1; z<SZ; ++z)
+    for (int32 y=1; y<SY; ++y)
+    for (int32 x=1; x<SX; ++x)
+    {
+        T[S(x,y,z)] = FMath::RoundToInt64(double(ChannelAt(Ch, Index(x-1, y-1, z-1))) * Scale)
+            + T[S(x-1,y,z)] + T[S(x,y-1,z)] + T[S(x,y,z-1)]
+            - T[S(x-1,y-1,z)] - T[S(x-1,y,z-1)] - T[S(x,y-1,z-1)]
+            + T[S(x-1,y-1,z-1)];
+    }
+}
+
+bool UThermoForgeFieldAsset::HasSummedVolumeTable(EThermoFieldChannel Channel) const
+{
+    const int32 Expect = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X+1)*(Dim.Y+1)*(Dim.Z+1) : 0;
+    FScopeLock Lock(&SummedVolumeLock);
+    return Expect > 0 && SummedVolume[static_cast<int32>(Channel)].Num() == Expect;
+}
+
+bool UThermoForgeFieldAsset::ClampCellBox(FIntVector& MinCell, FIntVector& MaxCell) const
+{
+    if (Dim.X<=0 || Dim.Y<=0 || Dim.Z<=0) return false;
+    MinCell = FIntVector(FMath::Max(MinCell.X, 0), FMath::Max(MinCell.Y, 0), FMath::Max(MinCell.Z, 0));
+    MaxCell = FIntVector(FMath::Min(MaxCell.X, Dim.X-1), FMath::Min(MaxCell.Y, Dim.Y-1), FMath::Min(MaxCell.Z, Dim.Z-1));
+    return MinCell.X <= MaxCell.X && MinCell.Y <= MaxCell.Y && MinCell.Z <= MaxCell.Z;
+}
+
+float UThermoForgeFieldAsset::SumChannelInBox(EThermoFieldChannel Channel, const FIntVector& MinCell, const FIntVector& MaxCell) const
+{
+    FIntVector A = MinCell, B = MaxCell;
+    if (!ClampCellBox(A, B)) return 0.f;
+
+    if (bBuildSummedVolumeTables)
+    {
+        FScopeLock Lock(&SummedVolumeLock);
+        const int32 Expect = (Dim.X+1) * (Dim.Y+1) * (Dim.Z+1);
+        TArray<int64>& T = SummedVolume[static_cast<int32>(Channel)];
+        if (T.Num() != Expect) BuildSummedVolumeTable(static_cast<int32>(Channel));
+        if (T.Num() == Expect)
+        {
+            const int32 SX = Dim.X + 1, SY = Dim.Y + 1;
+            auto S = [&](int32 x, int32 y, int32 z){ return T[(z * SY + y) * SX + x]; };
+
+            // Table index i holds the sum over cells [0, i-1]
+            const int32 x0 = A.X, y0 = A.Y, z0 = A.Z;
+            const int32 x1 = B.X + 1, y1 = B.Y + 1, z1 = B.Z + 1;
+            const int64 Sum = S(x1,y1,z1)
+                - S(x0,y1,z1) - S(x1,y0,z1) - S(x1,y1,z0)
+                + S(x0,y0,z1) + S(x0,y1,z0) + S(x1,y0,z0)
+                - S(x0,y0,z0);
+            return float(double(Sum) / double(int64(1) << SummedVolumeFracBits));
+        }
+    }
+
+    // No tables: direct loop
+    if (!HasChannelValues(Channel)) return 0.f;
+    double Sum = 0.0;
+    for (int32 z=A.Z; z<=B.Z; ++z)
+    for (int32 y=A.Y; y<=B.Y; ++y)
+    for (int32 x=A.X; x<=B.X; ++x)
+    {
+        Sum += ChannelAt(Channel, Index(x,y,z));
+    }
+    return float(Sum);
+}
+
+float UThermoForgeFieldAsset::AverageChannelInBox(EThermoFieldChannel Channel, const FIntVector& MinCell, const FIntVector& MaxCell) const
+{
+    FIntVector A = MinCell, B = MaxCell;
+    if (!ClampCellBox(A, B)) return 0.f;
+
+    const int64 Count = int64(B.X - A.X + 1) * int64(B.Y - A.Y + 1) * int64(B.Z - A.Z + 1);
+    return SumChannelInBox(Channel, A, B) / float(Count);
+}
+
+float UThermoForgeFieldAsset::AverageChannelInWorldBox(EThermoFieldChannel Channel, const FBox& WorldBox) const
+{
+    if (!WorldBox.IsValid || CellSizeCm <= 0.f) return 0.f;
+
+    // World box corners → grid-local, then cells whose centers lie inside that range
+    const FTransform InvFrame = GetGridFrame().Inverse();
+    FBox LocalBox(ForceInit);
+    for (int32 i=0; i<8; ++i)
+    {
+        const FVector C(
+            (i & 1) ? WorldBox.Max.X : WorldBox.Min.X,
+            (i & 2) ? WorldBox.Max.Y : WorldBox.Min.Y,
+            (i & 4) ? WorldBox.Max.Z : WorldBox.Min.Z);
+        LocalBox += InvFrame.TransformPosition(C);
+    }
+
+    const FVector Lo = LocalBox.Min / CellSizeCm - FVector(0.5f);
+    const FVector Hi = LocalBox.Max / CellSizeCm - FVector(0.5f);
+    const FIntVector MinCell(FMath::CeilToInt(Lo.X), FMath::CeilToInt(Lo.Y), FMath::CeilToInt(Lo.Z));
+    const FIntVector MaxCell(FMath::FloorToInt(Hi.X), FMath::FloorToInt(Hi.Y), FMath::FloorToInt(Hi.Z));
+    return AverageChannelInBox(Channel, MinCell, MaxCell);
+}
+
+// ---------- SkyView min/max pyramid ----------
+void UThermoForgeFieldAsset::BuildSkyViewHierarchy()
+{
+    BuildMinMaxPyramid(SkyView01, Dim, SkyViewHierarchy);
+}
+
+void UThermoForgeFieldAsset::BuildMinMaxPyramid(const TArray<float>& Sky, const FIntVector& InDim, TArray<FThermoForgeMinMaxLevel>& Out)
+{
+    Out.Reset();
+
+    const int32 N = (InDim.X>0 && InDim.Y>0 && InDim.Z>0) ? (InDim.X*InDim.Y*InDim.Z) : 0;
+    if (N <= 0 || Sky.Num() != N) return;
+
+    auto CellIndex = [&InDim](int32 x, int32 y, int32 z){ return (z * InDim.Y + y) * InDim.X + x; };
+
+    // Level 0: BrickSize³ cells per brick
+    {
+        FThermoForgeMinMaxLevel L0;
+        L0.BrickCells = BrickSize;
+        L0.Dim = FIntVector(
+            FMath::DivideAndRoundUp(InDim.X, BrickSize),
+            FMath::DivideAndRoundUp(InDim.Y, BrickSize),
+            FMath::DivideAndRoundUp(InDim.Z, BrickSize));
+
+        const int32 NB = L0.Dim.X * L0.Dim.Y * L0.Dim.Z;
+        L0.Min.Init(+FLT_MAX, NB);
+        L0.Max.Init(-FLT_MAX, NB);
+
+        for (int32 z=0; z<InDim.Z; ++z)
+        for (int32 y=0; y<InDim.Y; ++y)
+        for (int32 x=0; x<InDim.X; ++x)
+        {
+            const float V = FMath::Clamp(Sky[CellIndex(x,y,z)], 0.f, 1.f);
+            const int32 B = L0.Index(x / BrickSize, y / BrickSize, z / BrickSize);
+            L0.Min[B] = FMath::Min(L0.Min[B], V);
+            L0.Max[B] = FMath::Max(L0.Max[B], V);
+        }
+        Out.Add(MoveTemp(L0));
+    }
+
+    // Halve until a single brick covers the grid
+    for (;;)
+    {
+        const FThermoForgeMinMaxLevel& Prev = Out.Last();
+        if (Prev.Dim.X <= 1 && Prev.Dim.Y <= 1 && Prev.Dim.Z <= 1) break;
+
+        FThermoForgeMinMaxLevel Next;
+        Next.BrickCells = Prev.BrickCells * 2;
+        Next.Dim = FIntVector(
+            FMath::DivideAndRoundUp(Prev.Dim.X, 2),
+            FMath::DivideAndRoundUp(Prev.Dim.Y, 2),
+            FMath::DivideAndRoundUp(Prev.Dim.Z, 2));
+
+        const int32 NB = Next.Dim.X * Next.Dim.Y * Next.Dim.Z;
+        Next.Min.Init(+FLT_MAX, NB);
+        Next.Max.Init(-FLT_MAX, NB);
+
+        for (int32 z=0; z<Prev.Dim.Z; ++z)
+        for (int32 y=0; y<Prev.Dim.Y; ++y)
+        for (int32 x=0; x<Prev.Dim.X; ++x)
+        {
+            const int32 Src = Prev.Index(x,y,z);
+            const int32 Dst = Next.Index(x/2, y/2, z/2);
+            Next.Min[Dst] = FMath::Min(Next.Min[Dst], Prev.Min[Src]);
+            Next.Max[Dst] = FMath::Max(Next.Max[Dst], Prev.Max[Src]);
+        }
+        Out.Add(MoveTemp(Next));
+    }
+}
+
+bool UThermoForgeFieldAsset::IsMinMaxPyramidValid(const TArray<FThermoForgeMinMaxLevel>& Levels, const FIntVector& InDim)
+{
+    if (Levels.Num() == 0 || InDim.X <= 0 || InDim.Y <= 0 || InDim.Z <= 0) return false;
+
+    // Same sequence BuildMinMaxPyramid walks: BrickSize³ bricks, halved until a single brick remains
+    FIntVector Expect(
+        FMath::DivideAndRoundUp(InDim.X, BrickSize),
+        FMath::DivideAndRoundUp(InDim.Y, BrickSize),
+        FMath::DivideAndRoundUp(InDim.Z, BrickSize));
+    int32 Cells = BrickSize;
+
+    for (int32 l=0; l<Levels.Num(); ++l)
+    {
+        const FThermoForgeMinMaxLevel& L = Levels[l];
+        const int32 NB = Expect.X * Expect.Y * Expect.Z;
+        if (L.Dim != Expect || L.BrickCells != Cells || L.Min.Num() != NB || L.Max.Num() != NB) return false;
+
+        const bool bTop = Expect.X <= 1 && Expect.Y <= 1 && Expect.Z <= 1;
+        if (bTop != (l == Levels.Num() - 1)) return false;
+
+        Expect = FIntVector(FMath::DivideAndRoundUp(Expect.X, 2), FMath::DivideAndRoundUp(Expect.Y, 2), FMath::DivideAndRoundUp(Expect.Z, 2));
+        Cells *= 2;
+    }
+    return true;
+}
+
+bool UThermoForgeFieldAsset::HasSkyViewHierarchy() const
+{
+    return IsMinMaxPyramidValid(SkyViewHierarchy, Dim);
+}
+
+namespace
+{
+    /** Branch-and-bound walk over the SkyView pyramid for FindExtremeCell. */
+    struct FTF_ExtremeSearch
+    {
+        const FThermoFieldSearchView& Field;
+        const FThermoBakedExtremeQuery& Q;
+
+        // World Z of cell (x,y,z) center is linear in the indices
+        double Z0 = 0.0, Zx = 0.0, Zy = 0.0, Zz = 0.0;
+        int64  R2 = 0;
+        FIntVector Lo, Hi; // clipped search cube (inclusive)
+
+        bool       bFound = false;
+        float      BestT  = 0.f;
+        FIntVector BestCell = FIntVector::ZeroValue;
+
+        FTF_ExtremeSearch(const FThermoFieldSearchView& InField, const FThermoBakedExtremeQuery& InQ)
+            : Field(InField), Q(InQ)
+        {
+            const float Cell = FMath::Max(1.f, Field.CellSizeCm);
+            const FTransform& Frame = Field.Frame;
+            Z0 = Frame.TransformPosition(FVector(0.5f * Cell)).Z;
+            Zx = Frame.TransformVector(FVector(Cell, 0, 0)).Z;
+            Zy = Frame.TransformVector(FVector(0, Cell, 0)).Z;
+            Zz = Frame.TransformVector(FVector(0, 0, Cell)).Z;
+
+            const int32 R = FMath::Max(0, Q.RadiusCells);
+            R2 = int64(R) * int64(R);
+            const FIntVector D = Field.Dim;
+            Lo = FIntVector(FMath::Max(0, Q.CenterCell.X - R), FMath::Max(0, Q.CenterCell.Y - R), FMath::Max(0, Q.CenterCell.Z - R));
+            Hi = FIntVector(FMath::Min(D.X-1, Q.CenterCell.X + R), FMath::Min(D.Y-1, Q.CenterCell.Y + R), FMath::Min(D.Z-1, Q.CenterCell.Z + R));
+        }
+
+        FORCEINLINE double CellZ(int32 x, int32 y, int32 z) const { return Z0 + Zx * x + Zy * y + Zz * z; }
+
+        FORCEINLINE bool Beats(float T) const
+        {
+            return !bFound || (Q.bHottest ? (T > BestT) : (T < BestT));
+        }
+
+        /** A bound equal to the best may still hide a lower-index tie. */
+        FORCEINLINE bool CanReach(float Bound) const
+        {
+            return !bFound || (Q.bHottest ? (Bound >= BestT) : (Bound <= BestT));
+        }
+
+        FORCEINLINE bool Better(float T, const FIntVector& Cell) const
+        {
+            if (Beats(T)) return true;
+            return T == BestT && Field.Index(Cell.X, Cell.Y, Cell.Z) < Field.Index(BestCell.X, BestCell.Y, BestCell.Z);
+        }
+
+        /** Squared cell distance from the center to the nearest point of [Min,Max]. */
+        int64 DistSqToBox(const FIntVector& Min, const FIntVector& Max) const
+        {
+            auto Axis = [](int32 c, int32 lo, int32 hi)->int64
+            {
+                const int32 d = (c < lo) ? (lo - c) : (c > hi ? c - hi : 0);
+                return int64(d) * int64(d);
+            };
+            return Axis(Q.CenterCell.X, Min.X, Max.X) + Axis(Q.CenterCell.Y, Min.Y, Max.Y) + Axis(Q.CenterCell.Z, Min.Z, Max.Z);
+        }
+
+        /** Best temperature any cell in [Min,Max] could reach given its SkyView range. */
+        float Bound(const FIntVector& Min, const FIntVector& Max, float SkyMin, float SkyMax) const
+        {
+            auto Span = [](double a, int32 lo, int32 hi, double& OutLo, double& OutHi)
+            {
+                const double A = a * lo, B = a * hi;
+                OutLo += FMath::Min(A, B); OutHi += FMath::Max(A, B);
+            };
+            double ZLo = Z0, ZHi = Z0;
+            Span(Zx, Min.X, Max.X, ZLo, ZHi);
+            Span(Zy, Min.Y, Max.Y, ZLo, ZHi);
+            Span(Zz, Min.Z, Max.Z, ZLo, ZHi);
+
+            const float A0 = Q.Model.Evaluate(0.f, ZLo);
+            const float A1 = Q.Model.Evaluate(0.f, ZHi);
+            const float S0 = Q.Model.SolarC * SkyMin;
+            const float S1 = Q.Model.SolarC * SkyMax;
+
+            return Q.bHottest
+                ? FMath::Max(A0, A1) + FMath::Max(S0, S1)
+                : FMath::Min(A0, A1) + FMath::Min(S0, S1);
+        }
+
+        void ScanCells(const FIntVector& Min, const FIntVector& Max)
+        {
+            const FIntVector& C = Q.CenterCell;
+            for (int32 z = FMath::Max(Min.Z, Lo.Z); z <= FMath::Min(Max.Z, Hi.Z); ++z)
+            for (int32 y = FMath::Max(Min.Y, Lo.Y); y <= FMath::Min(Max.Y, Hi.Y); ++y)
+            for (int32 x = FMath::Max(Min.X, Lo.X); x <= FMath::Min(Max.X, Hi.X); ++x)
+            {
+                const int64 dx = x - C.X, dy = y - C.Y, dz = z - C.Z;
+                if (dx*dx + dy*dy + dz*dz > R2) continue;
+
+                const int32 Lin = Field.Index(x,y,z);
+                const float Sky = FMath::Clamp(Field.SkyView01.IsValidIndex(Lin) ? Field.SkyView01[Lin] : 0.f, 0.f, 1.f);
+                const float T   = Q.Model.Evaluate(Sky, CellZ(x,y,z));
+                if (Better(T, FIntVector(x,y,z)))
+                {
+                    bFound   = true;
+                    BestT    = T;
+                    BestCell = FIntVector(x,y,z);
+                }
+            }
+        }
+
+        void BrickRange(const FThermoForgeMinMaxLevel& L, const FIntVector& B, FIntVector& OutMin, FIntVector& OutMax) const
+        {
+            const FIntVector D = Field.Dim;
+            OutMin = B * L.BrickCells;
+            OutMax = FIntVector(
+                FMath::Min(OutMin.X + L.BrickCells, D.X) - 1,
+                FMath::Min(OutMin.Y + L.BrickCells, D.Y) - 1,
+                FMath::Min(OutMin.Z + L.BrickCells, D.Z) - 1);
+        }
+
+        void Visit(TConstArrayView<FThermoForgeMinMaxLevel> H, int32 Level, const FIntVector& Brick)
+        {
+            FIntVector Min, Max;
+            BrickRange(H[Level], Brick, Min, Max);
+
+            if (Level == 0)
+            {
+                ScanCells(Min, Max);
+                return;
+            }
+
+            // Gather in-range children with their bounds, then visit best-first
+            struct FChild { FIntVector Brick; float Bound; };
+            FChild Children[8];
+            int32 Num = 0;
+
+            const FThermoForgeMinMaxLevel& CL = H[Level - 1];
+            for (int32 dz=0; dz<2; ++dz)
+            for (int32 dy=0; dy<2; ++dy)
+            for (int32 dx=0; dx<2; ++dx)
+            {
+                const FIntVector CB(Brick.X*2 + dx, Brick.Y*2 + dy, Brick.Z*2 + dz);
+                if (CB.X >= CL.Dim.X || CB.Y >= CL.Dim.Y || CB.Z >= CL.Dim.Z) continue;
+
+                FIntVector CMin, CMax;
+                BrickRange(CL, CB, CMin, CMax);
+                if (DistSqToBox(CMin, CMax) > R2) continue;
+
+                const int32 CI = CL.Index(CB.X, CB.Y, CB.Z);
+                Children[Num++] = { CB, Bound(CMin, CMax, CL.Min[CI], CL.Max[CI]) };
+            }
+
+            const bool bHot = Q.bHottest;
+            Algo::Sort(MakeArrayView(Children, Num), [bHot](const FChild& A, const FChild& B)
+            {
+                return bHot ? (A.Bound > B.Bound) : (A.Bound < B.Bound);
+            });
+
+            for (int32 i=0; i<Num; ++i)
+            {
+                if (!CanReach(Children[i].Bound)) break; // sorted: nothing after can reach either
+                Visit(H, Level - 1, Children[i].Brick);
+            }
+        }
+    };
+}
+
+FThermoFieldSearchView UThermoForgeFieldAsset::MakeSearchView() const
+{
+    FThermoFieldSearchView View;
+    View.Dim        = Dim;
+    View.CellSizeCm = CellSizeCm;
+    View.Frame      = GetGridFrame();
+    View.SkyView01  = SkyView01;
+    if (HasSkyViewHierarchy())
+    {
+        View.SkyViewHierarchy = SkyViewHierarchy;
+    }
+    return View;
+}
+
+bool UThermoForgeFieldAsset::FindExtremeCell(const FThermoBakedExtremeQuery& Query, FIntVector& OutCell, float& OutTempC) const
+{
+    return FindExtremeCellInView(MakeSearchView(), Query, OutCell, OutTempC);
+}
+
+bool UThermoForgeFieldAsset::FindExtremeCellInView(const FThermoFieldSearchView& View, const FThermoBakedExtremeQuery& Query, FIntVector& OutCell, float& OutTempC)
+{
+    const FIntVector D = View.Dim;
+    if (D.X<=0 || D.Y<=0 || D.Z<=0) return false;
+
+    FThermoBakedExtremeQuery Q = Query;
+    Q.CenterCell = FIntVector(
+        FMath::Clamp(Q.CenterCell.X, 0, D.X-1),
+        FMath::Clamp(Q.CenterCell.Y, 0, D.Y-1),
+        FMath::Clamp(Q.CenterCell.Z, 0, D.Z-1));
+
+    FTF_ExtremeSearch Search(View, Q);
+
+    // Seed with the center cell so the first bound comparisons already prune
+    Search.ScanCells(Q.CenterCell, Q.CenterCell);
+
+    if (View.SkyViewHierarchy.Num() > 0)
+    {
+        const int32 Top = View.SkyViewHierarchy.Num() - 1;
+        Search.Visit(View.SkyViewHierarchy, Top, FIntVector::ZeroValue);
+    }
+    else
+    {
+        Search.ScanCells(Search.Lo, Search.Hi);
+    }
+
+    if (!Search.bFound) return false;
+    OutCell  = Search.BestCell;
+    OutTempC = Search.BestT;
+    return true;
+}
+
+bool UThermoForgeFieldAsset::FindTopKCellsInView(const FThermoFieldSearchView& View, const FThermoBakedExtremeQuery& Query,
+    int32 K, float MinSeparationCells, TArray<FThermoBakedExtremeCell>& OutCells)
+{
+    OutCells.Reset();
+    const FIntVector D = View.Dim;
+    if (D.X<=0 || D.Y<=0 || D.Z<=0 || K <= 0) return false;
+
+    FThermoBakedExtremeQuery Q = Query;
+    Q.CenterCell = FIntVector(
+        FMath::Clamp(Q.CenterCell.X, 0, D.X-1),
+        FMath::Clamp(Q.CenterCell.Y, 0, D.Y-1),
+        FMath::Clamp(Q.CenterCell.Z, 0, D.Z-1));
+
+    // Only the geometry helpers are used; ranking happens in the heap below
+    const FTF_ExtremeSearch Search(View, Q);
+    const TConstArrayView<FThermoForgeMinMaxLevel> H = View.SkyViewHierarchy;
+    const double Sep2 = FMath::Square(double(FMath::Max(0.f, MinSeparationCells)));
+
+    // Level < 0 marks a cell. Key is "higher is better" for both modes.
+    struct FItem { float Key; int32 Level; FIntVector Pos; int32 Linear; };
+    auto Pred = [](const FItem& A, const FItem& B)
+    {
+        if (A.Key != B.Key) return A.Key > B.Key;
+        if ((A.Level < 0) != (B.Level < 0)) return B.Level < 0; // a brick may still hide an equal cell
+        return A.Linear < B.Linear;                              // lowest index wins ties
+    };
+    const bool bHot = Q.bHottest;
+    auto KeyOf = [bHot](float T){ return bHot ? T : -T; };
+
+    TArray<FItem> Heap;
+
+    auto TooClose = [&](const FIntVector& C)
+    {
+        for (const FThermoBakedExtremeCell& A : OutCells)
+        {
+            if (FVector(C - A.Cell).SizeSquared() < Sep2) return true;
+        }
+        return false;
+    };
+
+    // Whole box inside some exclusion sphere: farthest corner is closer than the separation
+    auto Covered = [&](const FIntVector& Min, const FIntVector& Max)
+    {
+        if (Sep2 <= 0.0) return false;
+        for (const FThermoBakedExtremeCell& A : OutCells)
+        {
+            auto Far = [](int32 c, int32 lo, int32 hi){ const double d = FMath::Max(FMath::Abs(c - lo), FMath::Abs(c - hi)); return d * d; };
+            if (Far(A.Cell.X, Min.X, Max.X) + Far(A.Cell.Y, Min.Y, Max.Y) + Far(A.Cell.Z, Min.Z, Max.Z) < Sep2) return true;
+        }
+        return false;
+    };
+
+    auto PushCells = [&](const FIntVector& Min, const FIntVector& Max)
+    {
+        const FIntVector& C = Q.CenterCell;
+        for (int32 z = FMath::Max(Min.Z, Search.Lo.Z); z <= FMath::Min(Max.Z, Search.Hi.Z); ++z)
+        for (int32 y = FMath::Max(Min.Y, Search.Lo.Y); y <= FMath::Min(Max.Y, Search.Hi.Y); ++y)
+        for (int32 x = FMath::Max(Min.X, Search.Lo.X); x <= FMath::Min(Max.X, Search.Hi.X); ++x)
+        {
+            const int64 dx = x - C.X, dy = y - C.Y, dz = z - C.Z;
+            if (dx*dx + dy*dy + dz*dz > Search.R2) continue;
+
+            const int32 Lin = View.Index(x,y,z);
+            const float Sky = FMath::Clamp(View.SkyView01.IsValidIndex(Lin) ? View.SkyView01[Lin] : 0.f, 0.f, 1.f);
+            Heap.HeapPush({ KeyOf(Q.Model.Evaluate(Sky, Search.CellZ(x,y,z))), -1, FIntVector(x,y,z), Lin }, Pred);
+        }
+    };
+
+    auto PushBrick = [&](int32 Level, const FIntVector& B)
+    {
+        FIntVector Min, Max;
+        Search.BrickRange(H[Level], B, Min, Max);
+        if (Search.DistSqToBox(Min, Max) > Search.R2) return;
+
+        const int32 BI = H[Level].Index(B.X, B.Y, B.Z);
+        Heap.HeapPush({ KeyOf(Search.Bound(Min, Max, H[Level].Min[BI], H[Level].Max[BI])), Level, B, -1 }, Pred);
+    };
+
+    if (H.Num() > 0) PushBrick(H.Num() - 1, FIntVector::ZeroValue);
+    else             PushCells(Search.Lo, Search.Hi);
+
+    while (Heap.Num() > 0 && OutCells.Num() < K)
+    {
+        FItem It;
+        Heap.HeapPop(It, Pred, EAllowShrinking::No);
+
+        if (It.Level < 0)
+        {
+            if (!TooClose(It.Pos)) OutCells.Add({ It.Pos, bHot ? It.Key : -It.Key });
+            continue;
+        }
+
+        FIntVector Min, Max;
+        Search.BrickRange(H[It.Level], It.Pos, Min, Max);
+        if (Covered(Min, Max)) continue;
+
+        if (It.Level == 0)
+        {
+            PushCells(Min, Max);
+            continue;
+        }
+
+        const FThermoForgeMinMaxLevel& CL = H[It.Level - 1];
+        for (int32 dz=0; dz<2; ++dz)
+        for (int32 dy=0; dy<2; ++dy)
+        for (int32 dx=0; dx<2; ++dx)
+        {
+            const FIntVector CB(It.Pos.X*2 + dx, It.Pos.Y*2 + dy, It.Pos.Z*2 + dz);
+            if (CB.X < CL.Dim.X && CB.Y < CL.Dim.Y && CB.Z < CL.Dim.Z) PushBrick(It.Level - 1, CB);
+        }
+    }
+
+    return OutCells.Num() > 0;
+}
@@ -0,0 +1,303 @@
+﻿#include "ThermoForgeFieldExport.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/MemoryReader.h"
+
+static float TF_ChannelDefault(int32 Channel)
+{
+    // Matches the linear-index getters on the field asset
+    return Channel == static_cast<int32>(EThermoFieldChannel::WallPermeability) ? 1.f : 0.f;
+}
+
+// ---------- Header ----------
+void FThermoFieldFileHeader::Serialize(FArchive& Ar)
+{
+    const int64 Start = Ar.Tell();
+
+    uint8 FormatByte = static_cast<uint8>(Format);
+    uint8 Pad8 = 0;
+    uint32 Pad32 = 0;
+    double Ox = OriginWS.X, Oy = OriginWS.Y, Oz = OriginWS.Z;
+    double Rp = GridRotation.Pitch, Ry = GridRotation.Yaw, Rr = GridRotation.Roll;
+
+    Ar << Magic << Version;
+    Ar << Dim.X << Dim.Y << Dim.Z;
+    Ar << FormatByte << NumChannels << Pad8 << Pad8;
+    Ar << CellSizeCm << Pad32;
+    Ar << Ox << Oy << Oz;
+    Ar << Rp << Ry << Rr;
+    for (uint64& Off : SlabOffset) Ar << Off;
+
+    // Reserved tail up to SizeBytes
+    uint8 Zero = 0;
+    while (Ar.Tell() - Start < SizeBytes && !Ar.IsError())
+    {
+        Ar << Zero;
+    }
+
+    if (Ar.IsLoading())
+    {
+        // Unknown formats would be read with the wrong stride
+        if (FormatByte > static_cast<uint8>(EThermoFieldExportFormat::Quantized16))
+        {
+            Ar.SetError();
+            return;
+        }
+        Format       = static_cast<EThermoFieldExportFormat>(FormatByte);
+        OriginWS     = FVector(Ox, Oy, Oz);
+        GridRotation = FRotator(Rp, Ry, Rr);
+    }
+}
+
+// ---------- Writer ----------
+bool FThermoForgeFieldExport::Write(const FString& BasePath,
+    const FIntVector& Dim, float CellSizeCm, const FVector& OriginWS, const FRotator& GridRotation,
+    TConstArrayView<float> SkyView01, TConstArrayView<float> WallPerm01, TConstArrayView<float> Indoor01,
+    EThermoFieldExportFormat Format)
+{
+    FThermoFieldFileHeader H;
+    H.Dim          = Dim;
+    H.Format       = Format;
+    H.NumChannels  = FThermoFieldFileHeader::MaxChannels;
+    H.CellSizeCm   = CellSizeCm;
+    H.OriginWS     = OriginWS;
+    H.GridRotation = GridRotation;
+
+    const int64 N = H.NumCells();
+    if (N <= 0) return false;
+
+    // Slabs back to back, 16-byte aligned
+    const int64 SlabBytes = Align(N * H.BytesPerValue(), 16);
+    for (int32 c=0; c<FThermoFieldFileHeader::MaxChannels; ++c)
+    {
+        H.SlabOffset[c] = uint64(FThermoFieldFileHeader::SizeBytes + c * SlabBytes);
+    }
+
+    const FString BinPath  = BasePath + TEXT(".tfield");
+    const FString JsonPath = BasePath + TEXT(".json");
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(BinPath), true);
+
+    TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*BinPath));
+    if (!Ar)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Could not open %s for writing"), *BinPath);
+        return false;
+    }
+
+    H.Serialize(*Ar);
+
+    const TConstArrayView<float> Channels[FThermoFieldFileHeader::MaxChannels] = { SkyView01, WallPerm01, Indoor01 };
+
+    TArray<uint8> Scratch;
+    Scratch.SetNumUninitialized(ChunkCells * H.BytesPerValue());
+
+    for (int32 c=0; c<FThermoFieldFileHeader::MaxChannels && !Ar->IsError(); ++c)
+    {
+        Ar->Seek(int64(H.SlabOffset[c]));
+
+        const TConstArrayView<float> Src = Channels[c];
+        const float Def = TF_ChannelDefault(c);
+
+        for (int64 Begin = 0; Begin < N; Begin += ChunkCells)
+        {
+            const int32 Count = int32(FMath::Min<int64>(ChunkCells, N - Begin));
+
+            if (Format == EThermoFieldExportFormat::Quantized16)
+            {
+                uint16* Out = reinterpret_cast<uint16*>(Scratch.GetData());
+                for (int32 i=0; i<Count; ++i)
+                {
+                    const int64 Idx = Begin + i;
+                    const float V = Src.IsValidIndex(Idx) ? Src[Idx] : Def;
+                    Out[i] = uint16(FMath::RoundToInt(FMath::Clamp(V, 0.f, 1.f) * 65535.f));
+                }
+            }
+            else
+            {
+                float* Out = reinterpret_cast<float*>(Scratch.GetData());
+                for (int32 i=0; i<Count; ++i)
+                {
+                    const int64 Idx = Begin + i;
+                    Out[i] = Src.IsValidIndex(Idx) ? Src[Idx] : Def;
+                }
+            }
+
+            Ar->Serialize(Scratch.GetData(), int64(Count) * H.BytesPerValue());
+        }
+    }
+
+    const bool bOk = !Ar->IsError() && Ar->Close();
+    Ar.Reset();
+
+    if (!bOk)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Failed writing %s"), *BinPath);
+        return false;
+    }
+
+    // Companion header for external tools
+    static const TCHAR* ChannelNames[FThermoFieldFileHeader::MaxChannels] = { TEXT("SkyView01"), TEXT("WallPermeability01"), TEXT("Indoorness01") };
+
+    FString Json;
+    TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> JW = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+    JW->WriteObjectStart();
+    JW->WriteValue(TEXT("file"), FPaths::GetCleanFilename(BinPath));
+    JW->WriteValue(TEXT("version"), int64(H.Version));
+    JW->WriteArrayStart(TEXT("dim"));
+    JW->WriteValue(Dim.X); JW->WriteValue(Dim.Y); JW->WriteValue(Dim.Z);
+    JW->WriteArrayEnd();
+    JW->WriteValue(TEXT("cellSizeCm"), CellSizeCm);
+    JW->WriteArrayStart(TEXT("originWS"));
+    JW->WriteValue(OriginWS.X); JW->WriteValue(OriginWS.Y); JW->WriteValue(OriginWS.Z);
+    JW->WriteArrayEnd();
+    JW->WriteArrayStart(TEXT("gridRotationPYR"));
+    JW->WriteValue(GridRotation.Pitch); JW->WriteValue(GridRotation.Yaw); JW->WriteValue(GridRotation.Roll);
+    JW->WriteArrayEnd();
+    JW->WriteValue(TEXT("format"), (Format == EThermoFieldExportFormat::Quantized16) ? TEXT("uint16_unorm") : TEXT("float32"));
+    JW->WriteValue(TEXT("order"), TEXT("x-fastest, then y, then z"));
+    JW->WriteArrayStart(TEXT("channels"));
+    for (int32 c=0; c<FThermoFieldFileHeader::MaxChannels; ++c)
+    {
+        JW->WriteObjectStart();
+        JW->WriteValue(TEXT("name"), ChannelNames[c]);
+        JW->WriteValue(TEXT("offset"), int64(H.SlabOffset[c]));
+        JW->WriteObjectEnd();
+    }
+    JW->WriteArrayEnd();
+    JW->WriteObjectEnd();
+    JW->Close();
+
+    FFileHelper::SaveStringToFile(Json, *JsonPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+
+    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] Exported %lld cells to %s"), N, *BinPath);
+    return true;
+}
+
+bool FThermoForgeFieldExport::Write(const FString& BasePath, const UThermoForgeFieldAsset& Field, EThermoFieldExportFormat Format)
+{
+    // Cooked fields may leave Indoorness to be derived on read
+    TArray<float> Indoor;
+    if (Field.IsIndoornessDerived())
+    {
+        Indoor.SetNumUninitialized(Field.SkyView01.Num());
+        for (int32 i=0; i<Indoor.Num(); ++i) Indoor[i] = Field.GetIndoorByLinearIdx(i);
+    }
+
+    return Write(BasePath, Field.Dim, Field.CellSizeCm, Field.OriginWS, Field.GridRotation,
+        Field.SkyView01, Field.WallPermeability01, Indoor.Num() ? TConstArrayView<float>(Indoor) : TConstArrayView<float>(Field.Indoorness01), Format);
+}
+
+// ---------- Mapped reader ----------
+FThermoForgeMappedField::FThermoForgeMappedField() = default;
+
+FThermoForgeMappedField::~FThermoForgeMappedField()
+{
+    Close();
+}
+
+bool FThermoForgeMappedField::Open(const FString& Filename)
+{
+    Close();
+
+    IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
+    FOpenMappedResult Result = PF.OpenMappedEx(*Filename);
+    if (Result.HasError())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Could not map %s"), *Filename);
+        return false;
+    }
+    Handle = Result.StealValue();
+
+    const int64 Size = Handle->GetFileSize();
+    if (Size < FThermoFieldFileHeader::SizeBytes) { Close(); return false; }
+
+    Region.Reset(Handle->MapRegion(0, Size));
+    if (!Region) { Close(); return false; }
+
+    Data     = Region->GetMappedPtr();
+    DataSize = Region->GetMappedSize();
+
+    TArrayView<const uint8> HeaderBytes(Data, FThermoFieldFileHeader::SizeBytes);
+    FMemoryReaderView Reader(HeaderBytes);
+    Header.Serialize(Reader);
+
+    const bool bHeaderOk =
+        !Reader.IsError() &&
+        Header.Magic == FThermoFieldFileHeader::MagicValue &&
+        Header.Version <= FThermoFieldFileHeader::CurrentVersion &&
+        Header.NumChannels <= FThermoFieldFileHeader::MaxChannels &&
+        Header.NumCells() > 0;
+
+    if (!bHeaderOk)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] %s is not a valid .tfield file"), *Filename);
+        Close();
+        return false;
+    }
+
+    // Every declared slab must fit inside the mapping
+    const int64 SlabBytes = Header.NumCells() * Header.BytesPerValue();
+    for (int32 c=0; c<Header.NumChannels; ++c)
+    {
+        if (int64(Header.SlabOffset[c]) + SlabBytes > DataSize)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] %s is truncated"), *Filename);
+            Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void FThermoForgeMappedField::Close()
+{
+    Region.Reset();
+    Handle.Reset();
+    Data = nullptr;
+    DataSize = 0;
+    Header = FThermoFieldFileHeader();
+}
+
+const uint8* FThermoForgeMappedField::SlabPtr(EThermoFieldChannel Channel) const
+{
+    const int32 c = static_cast<int32>(Channel);
+    if (!Data || c >= Header.NumChannels) return nullptr;
+    return Data + Header.SlabOffset[c];
+}
+
+float FThermoForgeMappedField::GetValue(EThermoFieldChannel Channel, int64 Linear) const
+{
+    const uint8* Slab = SlabPtr(Channel);
+    if (!Slab || Linear < 0 || Linear >= Header.NumCells()) return TF_ChannelDefault(static_cast<int32>(Channel));
+
+    if (Header.Format == EThermoFieldExportFormat::Quantized16)
+    {
+        uint16 Q;
+        FMemory::Memcpy(&Q, Slab + Linear * sizeof(uint16), sizeof(uint16));
+        return float(Q) / 65535.f;
+    }
+
+    float V;
+    FMemory::Memcpy(&V, Slab + Linear * sizeof(float), sizeof(float));
+    return V;
+}
+
+TConstArrayView<float> FThermoForgeMappedField::GetFloatSlab(EThermoFieldChannel Channel) const
+{
+    const uint8* Slab = SlabPtr(Channel);
+    if (!Slab || Header.Format != EThermoFieldExportFormat::Float32) return {};
+    return TConstArrayView<float>(reinterpret_cast<const float*>(Slab), Header.NumCells());
+}
+
+TConstArrayView<uint16> FThermoForgeMappedField::GetQuantizedSlab(EThermoFieldChannel Channel) const
+{
+    const uint8* Slab = SlabPtr(Channel);
+    if (!Slab || Header.Format != EThermoFieldExportFormat::Quantized16) return {};
+    return TConstArrayView<uint16>(reinterpret_cast<const uint16*>(Slab), Header.NumCells());
+}
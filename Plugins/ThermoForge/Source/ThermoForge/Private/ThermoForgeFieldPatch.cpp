@@ -0,0 +1,155 @@
+﻿#include "ThermoForgeFieldPatch.h"
+#include "ThermoForgeFieldAsset.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+int64 FThermoForgeFieldPatch::NumCells() const
+{
+    int64 N = 0;
+    for (const FThermoForgeFieldPatchTile& T : Tiles) N += T.SkyView01.Num();
+    return N;
+}
+
+bool FThermoForgeFieldPatch::Matches(const UThermoForgeFieldAsset& Field) const
+{
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    return N > 0
+        && Field.Dim == Dim
+        && FMath::IsNearlyEqual(Field.CellSizeCm, CellSizeCm, 1e-3f)
+        && Field.OriginWS.Equals(OriginWS, 1e-2)
+        && Field.GridRotation.Equals(GridRotation, 1e-3f)
+        && Field.SkyView01.Num() == N
+        && Field.WallPermeability01.Num() == N
+        && (Field.Indoorness01.Num() == N || Field.IsIndoornessDerived());
+}
+
+void FThermoForgeFieldPatch::TileRange(const FIntVector& Tile, FIntVector& OutMin, FIntVector& OutMax) const
+{
+    OutMin = Tile * TileSize;
+    OutMax = FIntVector(
+        FMath::Min(OutMin.X + TileSize, Dim.X),
+        FMath::Min(OutMin.Y + TileSize, Dim.Y),
+        FMath::Min(OutMin.Z + TileSize, Dim.Z));
+}
+
+bool FThermoForgeFieldPatch::Diff(const UThermoForgeFieldAsset& Base,
+    const FIntVector& NewDim, float NewCellSizeCm, const FVector& NewOriginWS, const FRotator& NewGridRotation,
+    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01,
+    float Tolerance, FThermoForgeFieldPatch& Out)
+{
+    Out = FThermoForgeFieldPatch();
+    Out.TargetAsset  = Base.GetPathName();
+    Out.Dim          = NewDim;
+    Out.CellSizeCm   = NewCellSizeCm;
+    Out.OriginWS     = NewOriginWS;
+    Out.GridRotation = NewGridRotation;
+
+    const int32 N = (NewDim.X>0 && NewDim.Y>0 && NewDim.Z>0) ? (NewDim.X*NewDim.Y*NewDim.Z) : 0;
+    if (!Out.Matches(Base) || SkyView01.Num() != N || WallPerm01.Num() != N || Indoor01.Num() != N)
+    {
+        Out.Tiles.Reset();
+        return false;
+    }
+
+    const FIntVector NumTiles(
+        FMath::DivideAndRoundUp(NewDim.X, TileSize),
+        FMath::DivideAndRoundUp(NewDim.Y, TileSize),
+        FMath::DivideAndRoundUp(NewDim.Z, TileSize));
+
+    auto Changed = [Tolerance](float A, float B){ return FMath::Abs(A - B) > Tolerance; };
+
+    for (int32 tz=0; tz<NumTiles.Z; ++tz)
+    for (int32 ty=0; ty<NumTiles.Y; ++ty)
+    for (int32 tx=0; tx<NumTiles.X; ++tx)
+    {
+        const FIntVector Tile(tx, ty, tz);
+        FIntVector Min, Max;
+        Out.TileRange(Tile, Min, Max);
+
+        bool bDirty = false;
+        for (int32 z=Min.Z; z<Max.Z && !bDirty; ++z)
+        for (int32 y=Min.Y; y<Max.Y && !bDirty; ++y)
+        for (int32 x=Min.X; x<Max.X && !bDirty; ++x)
+        {
+            const int32 i = Base.Index(x,y,z);
+            bDirty = Changed(SkyView01[i], Base.SkyView01[i])
+                  || Changed(WallPerm01[i], Base.WallPermeability01[i])
+                  || Changed(Indoor01[i], Base.GetIndoorByLinearIdx(i));
+        }
+        if (!bDirty) continue;
+
+        FThermoForgeFieldPatchTile& T = Out.Tiles.AddDefaulted_GetRef();
+        T.Tile = Tile;
+        const int32 Count = (Max.X - Min.X) * (Max.Y - Min.Y) * (Max.Z - Min.Z);
+        T.SkyView01.Reserve(Count);
+        T.WallPermeability01.Reserve(Count);
+        T.Indoorness01.Reserve(Count);
+
+        for (int32 z=Min.Z; z<Max.Z; ++z)
+        for (int32 y=Min.Y; y<Max.Y; ++y)
+        for (int32 x=Min.X; x<Max.X; ++x)
+        {
+            const int32 i = Base.Index(x,y,z);
+            T.SkyView01.Add(SkyView01[i]);
+            T.WallPermeability01.Add(WallPerm01[i]);
+            T.Indoorness01.Add(Indoor01[i]);
+        }
+    }
+    return true;
+}
+
+void FThermoForgeFieldPatch::Serialize(FArchive& Ar)
+{
+    uint32 Magic = MagicValue;
+    uint32 Version = CurrentVersion;
+    Ar << Magic << Version;
+    if (Ar.IsLoading() && (Magic != MagicValue || Version > CurrentVersion))
+    {
+        Ar.SetError();
+        return;
+    }
+
+    Ar << TargetAsset;
+    Ar << Dim << CellSizeCm << OriginWS << GridRotation;
+
+    int32 NumTiles = Tiles.Num();
+    Ar << NumTiles;
+    if (Ar.IsLoading())
+    {
+        Tiles.Reset();
+        Tiles.SetNum(FMath::Max(0, NumTiles));
+    }
+    for (FThermoForgeFieldPatchTile& T : Tiles)
+    {
+        Ar << T.Tile << T.SkyView01 << T.WallPermeability01 << T.Indoorness01;
+    }
+}
+
+bool FThermoForgeFieldPatch::SaveToFile(const FString& Filename) const
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    const_cast<FThermoForgeFieldPatch*>(this)->Serialize(Writer);
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Filename), true);
+    return !Writer.IsError() && FFileHelper::SaveArrayToFile(Bytes, *Filename);
+}
+
+bool FThermoForgeFieldPatch::LoadFromFile(const FString& Filename)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Filename)) return false;
+
+    FMemoryReader Reader(Bytes);
+    Serialize(Reader);
+    if (Reader.IsError())
+    {
+        *this = FThermoForgeFieldPatch();
+        return false;
+    }
+    return true;
+}
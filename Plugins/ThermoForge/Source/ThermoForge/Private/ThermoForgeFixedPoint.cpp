@@ -0,0 +1,423 @@
+﻿#include "ThermoForgeFixedPoint.h"
+#include "ThermoForgeBlockers.h"
+#include "ThermoForgeClimate.h"
+#include "ThermoForgeComposedGrid.h"
+#include "ThermoForgeFieldAsset.h"
+#include "ThermoForgeProjectSettings.h"
+#include "ThermoForgeSourceComponent.h"
+
+#include "Async/ParallelFor.h"
+#include "Misc/Crc.h"
+
+using namespace ThermoFixed;
+
+// Same stability margin and split cap as the float stencil
+static constexpr double TF_FIXED_STABLE = 0.9;
+static constexpr int32  TF_FIXED_MAX_SPLIT = 16;
+static constexpr int64  TF_Z_SCALE = 256;
+
+// Products are Q32.32 in int64; >> is arithmetic (C++20) so negatives round towards -inf consistently
+FORCEINLINE static int32 TF_MulQ(int64 A, int64 B) { return int32((A * B) >> Shift); }
+
+static int64 TF_ISqrt64(uint64 V)
+{
+    uint64 Root = 0;
+    uint64 Bit = uint64(1) << 62;
+    while (Bit > V) Bit >>= 2;
+    while (Bit != 0)
+    {
+        if (V >= Root + Bit)
+        {
+            V   -= Root + Bit;
+            Root = (Root >> 1) + Bit;
+        }
+        else
+        {
+            Root >>= 1;
+        }
+        Bit >>= 2;
+    }
+    return int64(Root);
+}
+
+static int32 TF_FalloffQ(uint8 Falloff, int64 DistQ, int32 RadiusQ)
+{
+    if (RadiusQ <= 0 || DistQ >= RadiusQ) return 0;
+    const int64 X = (DistQ << Shift) / RadiusQ;
+    switch (EThermoSourceFalloff(Falloff))
+    {
+        case EThermoSourceFalloff::None:   return One;
+        case EThermoSourceFalloff::Linear: return int32(One - X);
+        case EThermoSourceFalloff::InverseSquare:
+        default:
+            return int32((int64(One) << Shift) / (One + ((X * X) >> Shift)));
+    }
+}
+
+FThermoFixedClimate FThermoFixedClimate::FromClimate(const FThermoClimateState& Climate)
+{
+    FThermoFixedClimate Out;
+    Out.AmbientSeaLevelQ = FromFloat(Climate.AmbientSeaLevelC);
+    Out.LapsePerMetreQ   = FromFloat(Climate.LapseCPerCm * 100.f);
+    Out.SeaLevelZ8       = int64(FMath::RoundToDouble(double(Climate.SeaLevelZcm) * TF_Z_SCALE));
+    Out.SolarQ           = FromFloat(Climate.SolarC);
+    return Out;
+}
+
+// cos(k·π/128) in Q16.16, k = 0..64: one quarter turn, mirrored for the rest
+static const int32 TF_CosQuarterQ[65] =
+{
+    65536, 65516, 65457, 65358, 65220, 65043, 64827, 64571,
+    64277, 63944, 63572, 63162, 62714, 62228, 61705, 61145,
+    60547, 59914, 59244, 58538, 57798, 57022, 56212, 55368,
+    54491, 53581, 52639, 51665, 50660, 49624, 48559, 47464,
+    46341, 45190, 44011, 42806, 41576, 40320, 39040, 37736,
+    36410, 35062, 33692, 32303, 30893, 29466, 28020, 26558,
+    25080, 23586, 22078, 20557, 19024, 17479, 15924, 14359,
+    12785, 11204, 9616, 8022, 6424, 4821, 3216, 1608,
+    0
+};
+
+// Quarter-turn table lookup; W in 1/65536 turn, 0..16384
+static int32 TF_CosQuarter(int32 W)
+{
+    const int32 k = W >> 8;
+    if (k >= 64) return TF_CosQuarterQ[64];
+    const int32 Frac = W & 0xFF;
+    return TF_CosQuarterQ[k] + (((TF_CosQuarterQ[k + 1] - TF_CosQuarterQ[k]) * Frac) >> 8);
+}
+
+// cos of Phase (1/65536 turn) in Q16.16
+static int32 TF_CosTurnQ(uint32 Phase)
+{
+    const int32 W = int32(Phase & 0x3FFF);
+    switch ((Phase >> 14) & 3)
+    {
+        case 0:  return  TF_CosQuarter(W);
+        case 1:  return -TF_CosQuarter(0x4000 - W);
+        case 2:  return -TF_CosQuarter(W);
+        default: return  TF_CosQuarter(0x4000 - W);
+    }
+}
+
+FThermoFixedClimateModel FThermoFixedClimateModel::FromSettings(const UThermoForgeProjectSettings& S)
+{
+    FThermoFixedClimateModel M;
+    M.WinterAvgQ     = FromFloat(S.WinterAverageC);
+    M.SummerAvgQ     = FromFloat(S.SummerAverageC);
+    M.WinterDeltaQ   = FromFloat(S.WinterDayNightDeltaC);
+    M.SummerDeltaQ   = FromFloat(S.SummerDayNightDeltaC);
+    M.PeakTicks      = int64(FMath::RoundToDouble(double(FMath::Clamp(S.DiurnalPeakHour, 0.f, 24.f)) * ETimespan::TicksPerHour));
+    M.LapsePerMetreQ = (S.bEnableAltitudeLapse && S.LapseRateCPerKm > 0.f) ? FromFloat(S.LapseRateCPerKm / 1000.f) : 0;
+    M.SeaLevelZ8     = int64(FMath::RoundToDouble(double(S.SeaLevelZcm) * TF_Z_SCALE));
+    M.SolarScaleQ    = FromFloat(S.SolarGainScaleC);
+    return M;
+}
+
+FThermoFixedClimate FThermoFixedClimateModel::At(int64 ClockTicks, int32 WeatherAlphaQ) const
+{
+    // Same curves as the float model: season 0.5·(1 - cos) from Dec 21, diurnal cosine peaking at PeakTicks
+    const int64 Day = ETimespan::TicksPerDay;
+    const int32 DayOfYear = FDateTime(FMath::Max<int64>(0, ClockTicks)).GetDayOfYear();
+    const int64 SeasonDay = ((DayOfYear - 355) % 365 + 365) % 365;
+    const int32 SeasonQ = (One - TF_CosTurnQ(uint32((SeasonDay << 16) / 365))) >> 1;
+
+    const int64 TickOfDay = ((ClockTicks - PeakTicks) % Day + Day) % Day;
+    const int32 DiurnalQ = TF_CosTurnQ(uint32((TickOfDay << 16) / Day));
+
+    const int32 AvgQ   = WinterAvgQ   + TF_MulQ(SummerAvgQ - WinterAvgQ, SeasonQ);
+    const int32 DeltaQ = WinterDeltaQ + TF_MulQ(SummerDeltaQ - WinterDeltaQ, SeasonQ);
+
+    FThermoFixedClimate Out;
+    Out.AmbientSeaLevelQ = AvgQ + (TF_MulQ(DeltaQ, DiurnalQ) >> 1);
+    Out.LapsePerMetreQ   = LapsePerMetreQ;
+    Out.SeaLevelZ8       = SeaLevelZ8;
+    Out.SolarQ           = TF_MulQ(SolarScaleQ, One - FMath::Clamp(WeatherAlphaQ, 0, One));
+    return Out;
+}
+
+FThermoForgeFixedGrid::FParams FThermoForgeFixedGrid::FParams::Make(float DiffusivityCm2PerSec, float ExchangeSeconds, float StepSeconds, float InCellSizeCm)
+{
+    const double Dt = FMath::Max(1e-3, double(StepSeconds));
+    double R = FMath::Max(0.0, double(DiffusivityCm2PerSec)) * Dt / FMath::Square(FMath::Max(1.0, double(InCellSizeCm)));
+    double K = Dt / FMath::Max(1e-3, double(ExchangeSeconds));
+
+    FParams Out;
+    Out.Split = FMath::Clamp(FMath::CeilToInt((6.0 * R + K) / TF_FIXED_STABLE), 1, TF_FIXED_MAX_SPLIT);
+    const double Scale = FMath::Min(1.0, (TF_FIXED_STABLE * Out.Split) / FMath::Max(1e-9, 6.0 * R + K));
+    Out.RQ = FromFloat(float(R * Scale / Out.Split));
+    Out.KQ = FromFloat(float(K * Scale / Out.Split));
+    return Out;
+}
+
+void FThermoForgeFixedGrid::Init(const UThermoForgeFieldAsset* InField, int32 InGuardCells, const FThermoPermOverrideLayer* PermOverrides)
+{
+    Field = InField;
+    Dim   = InField ? InField->Dim : FIntVector::ZeroValue;
+    Guard = FMath::Clamp(InGuardCells, 1, 3);
+    Checksum = 0;
+
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    if (!InField || N <= 0 || InField->WallPermeability01.Num() != N || InField->SkyView01.Num() != N)
+    {
+        Dim = PDim = FIntVector::ZeroValue;
+        Sky.Empty(); Perm.Empty(); Target.Empty();
+        T.Empty(); TNext.Empty(); Gx.Empty(); Gy.Empty(); Gz.Empty();
+        return;
+    }
+
+    CellSizeCm = FMath::Max(1.f, InField->CellSizeCm);
+    Frame      = InField->GetGridFrame();
+    InvFrame   = Frame.Inverse();
+    PDim       = Dim + FIntVector(2 * Guard);
+
+    // Cell-centre Z is affine in the indices; quantise the four coefficients once
+    auto CentreZ = [this](double x, double y, double z)
+    {
+        return Frame.TransformPosition(FVector((x + 0.5) * CellSizeCm, (y + 0.5) * CellSizeCm, (z + 0.5) * CellSizeCm)).Z;
+    };
+    const double WZ0 = CentreZ(0, 0, 0);
+    Z0 = int64(FMath::RoundToDouble(WZ0 * TF_Z_SCALE));
+    Zx = int64(FMath::RoundToDouble((CentreZ(1, 0, 0) - WZ0) * TF_Z_SCALE));
+    Zy = int64(FMath::RoundToDouble((CentreZ(0, 1, 0) - WZ0) * TF_Z_SCALE));
+    Zz = int64(FMath::RoundToDouble((CentreZ(0, 0, 1) - WZ0) * TF_Z_SCALE));
+
+    Sky.SetNumUninitialized(N);
+    Perm.SetNumUninitialized(N);
+    Target.SetNumZeroed(N);
+    for (int32 i=0; i<N; ++i)
+    {
+        Sky[i]  = FromFloat(FMath::Clamp(InField->SkyView01[i], 0.f, 1.f));
+        const float Baked = InField->WallPermeability01[i];
+        Perm[i] = FromFloat(FMath::Clamp(PermOverrides ? PermOverrides->GetWallPerm(i, Baked) : Baked, 0.f, 1.f));
+    }
+
+    const int32 PN = PDim.X * PDim.Y * PDim.Z;
+    T.SetNumZeroed(PN);
+    TNext.SetNumZeroed(PN);
+    Gx.SetNumZeroed(PN);
+    Gy.SetNumZeroed(PN);
+    Gz.SetNumZeroed(PN);
+
+    // Harmonic mean of the quantised permeabilities; border faces stay 0
+    auto Face = [](int64 A, int64 B){ return (A + B) > 0 ? int32((2 * A * B) / (A + B)) : 0; };
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    for (int32 x=0; x<Dim.X; ++x)
+    {
+        const int32 i = Index(x,y,z);
+        const int32 p = Padded(x,y,z);
+        Gx[p] = (x+1 < Dim.X) ? Face(Perm[i], Perm[Index(x+1,y,z)]) : 0;
+        Gy[p] = (y+1 < Dim.Y) ? Face(Perm[i], Perm[Index(x,y+1,z)]) : 0;
+        Gz[p] = (z+1 < Dim.Z) ? Face(Perm[i], Perm[Index(x,y,z+1)]) : 0;
+    }
+
+    UpdateChecksum();
+}
+
+bool FThermoForgeFixedGrid::IsValidFor(const UThermoForgeFieldAsset* InField) const
+{
+    return InField && Field.Get() == InField && InField->Dim == Dim && PDim.X > 0
+        && FMath::IsNearlyEqual(FMath::Max(1.f, InField->CellSizeCm), CellSizeCm)
+        && InField->GetGridFrame().Equals(Frame);
+}
+
+bool FThermoForgeFixedGrid::MakeSource(const FThermoSourceShape& Shape, FThermoFixedSource& Out) const
+{
+    if (PDim.X <= 0) return false;
+
+    // World → cell-centre coordinates of this grid
+    auto ToCell = [this](const FVector& W){ return InvFrame.TransformPosition(W) / CellSizeCm - FVector(0.5f); };
+
+    Out = FThermoFixedSource();
+    Out.Falloff    = uint8(Shape.Falloff);
+    Out.IntensityQ = FromFloat(Shape.IntensityCelsius);
+
+    FBox CellBox(ForceInit);
+    if (Shape.Shape == EThermoSourceShape::Point)
+    {
+        if (Shape.RadiusCm <= KINDA_SMALL_NUMBER) return false;
+
+        const FVector C = ToCell(Shape.Transform.GetLocation());
+        const double  R = Shape.RadiusCm / CellSizeCm;
+        Out.CX = int64(FMath::RoundToDouble(C.X * One));
+        Out.CY = int64(FMath::RoundToDouble(C.Y * One));
+        Out.CZ = int64(FMath::RoundToDouble(C.Z * One));
+        Out.RadiusQ = FromFloat(float(R));
+        CellBox = FBox(C - FVector(R), C + FVector(R));
+    }
+    else
+    {
+        const FVector E = Shape.BoxExtent;
+        if (E.X <= KINDA_SMALL_NUMBER || E.Y <= KINDA_SMALL_NUMBER || E.Z <= KINDA_SMALL_NUMBER) return false;
+
+        // Affine map from cell coordinates to the box's ±1 space: u = A·c + B
+        auto ToUnit = [this, &Shape, &E](double x, double y, double z)
+        {
+            const FVector W = Frame.TransformPosition(FVector((x + 0.5) * CellSizeCm, (y + 0.5) * CellSizeCm, (z + 0.5) * CellSizeCm));
+            return Shape.Transform.InverseTransformPosition(W) / E;
+        };
+        const FVector U0 = ToUnit(0, 0, 0);
+        const FVector Col[3] = { ToUnit(1, 0, 0) - U0, ToUnit(0, 1, 0) - U0, ToUnit(0, 0, 1) - U0 };
+
+        Out.bBox = true;
+        for (int32 r=0; r<3; ++r)
+        {
+            Out.B[r] = FromFloat(float(U0[r]));
+            for (int32 c=0; c<3; ++c) Out.A[r * 3 + c] = FromFloat(float(Col[c][r]));
+        }
+
+        for (int32 k=0; k<8; ++k)
+        {
+            const FVector Corner((k & 1) ? E.X : -E.X, (k & 2) ? E.Y : -E.Y, (k & 4) ? E.Z : -E.Z);
+            CellBox += ToCell(Shape.Transform.TransformPosition(Corner));
+        }
+    }
+
+    Out.MinCell = FIntVector(
+        FMath::Max(0, FMath::FloorToInt(CellBox.Min.X)),
+        FMath::Max(0, FMath::FloorToInt(CellBox.Min.Y)),
+        FMath::Max(0, FMath::FloorToInt(CellBox.Min.Z)));
+    Out.MaxCell = FIntVector(
+        FMath::Min(Dim.X - 1, FMath::CeilToInt(CellBox.Max.X)),
+        FMath::Min(Dim.Y - 1, FMath::CeilToInt(CellBox.Max.Y)),
+        FMath::Min(Dim.Z - 1, FMath::CeilToInt(CellBox.Max.Z)));
+
+    return Out.MinCell.X <= Out.MaxCell.X && Out.MinCell.Y <= Out.MaxCell.Y && Out.MinCell.Z <= Out.MaxCell.Z;
+}
+
+void FThermoForgeFixedGrid::ComposeTarget(const FThermoFixedClimate& Climate, TConstArrayView<FThermoFixedSource> Sources)
+{
+    // Each z slab is written by one task and every term is an integer sum, so the result is independent of scheduling
+    ParallelFor(Dim.Z, [&](int32 z)
+    {
+        for (int32 y=0; y<Dim.Y; ++y)
+        {
+            int32* Row = Target.GetData() + Index(0, y, z);
+            const int32* SkyRow = Sky.GetData() + Index(0, y, z);
+            for (int32 x=0; x<Dim.X; ++x)
+            {
+                const int64 DZ8 = Z0 + Zx * x + Zy * y + Zz * z - Climate.SeaLevelZ8;
+                const int64 Lapse = (int64(Climate.LapsePerMetreQ) * DZ8) / (TF_Z_SCALE * 100);
+                Row[x] = int32(Climate.AmbientSeaLevelQ - Lapse) + TF_MulQ(Climate.SolarQ, SkyRow[x]);
+            }
+        }
+
+        for (const FThermoFixedSource& S : Sources)
+        {
+            if (z < S.MinCell.Z || z > S.MaxCell.Z || S.IntensityQ == 0) continue;
+
+            for (int32 y=S.MinCell.Y; y<=S.MaxCell.Y; ++y)
+            for (int32 x=S.MinCell.X; x<=S.MaxCell.X; ++x)
+            {
+                int32 W = 0;
+                if (S.bBox)
+                {
+                    bool bInside = true;
+                    for (int32 r=0; r<3 && bInside; ++r)
+                    {
+                        const int64 U = int64(S.B[r]) + int64(S.A[r * 3 + 0]) * x + int64(S.A[r * 3 + 1]) * y + int64(S.A[r * 3 + 2]) * z;
+                        bInside = U >= -One && U <= One;
+                    }
+                    W = bInside ? One : 0;
+                }
+                else
+                {
+                    const int64 DX = (int64(x) << Shift) - S.CX;
+                    const int64 DY = (int64(y) << Shift) - S.CY;
+                    const int64 DZ = (int64(z) << Shift) - S.CZ;
+                    const int64 DistQ = TF_ISqrt64(uint64(DX * DX + DY * DY + DZ * DZ));
+                    W = TF_FalloffQ(S.Falloff, DistQ, S.RadiusQ);
+                }
+                if (W == 0) continue;
+
+                const int32 i = Index(x,y,z);
+                Target[i] += TF_MulQ(TF_MulQ(S.IntensityQ, W), Perm[i]);
+            }
+        }
+    });
+}
+
+void FThermoForgeFixedGrid::Diffuse(int32 RQ, int32 KQ)
+{
+    const int32 SY = PDim.X;
+    const int32 SZ = PDim.X * PDim.Y;
+    const int32* Tin = T.GetData();
+    int32* Tout = TNext.GetData();
+
+    // Jacobi: reads T only, so slabs can run in any order
+    ParallelFor(Dim.Z, [&](int32 z)
+    {
+        for (int32 y=0; y<Dim.Y; ++y)
+        {
+            const int32 p0 = Padded(0, y, z);
+            const int32* Tc0 = Tin + p0;
+            const int32* Gx0 = Gx.GetData() + p0;
+            const int32* Gy0 = Gy.GetData() + p0;
+            const int32* Gz0 = Gz.GetData() + p0;
+            const int32* Tg  = Target.GetData() + Index(0, y, z);
+            int32* Out = Tout + p0;
+
+            for (int32 x=0; x<Dim.X; ++x)
+            {
+                const int32* Tc = Tc0 + x;
+                const int64 C = *Tc;
+                const int64 F = int64(Gx0[x])      * (Tc[1]   - C) + int64(Gx0[x - 1])  * (Tc[-1]  - C)
+                              + int64(Gy0[x])      * (Tc[SY]  - C) + int64(Gy0[x - SY]) * (Tc[-SY] - C)
+                              + int64(Gz0[x])      * (Tc[SZ]  - C) + int64(Gz0[x - SZ]) * (Tc[-SZ] - C);
+                Out[x] = int32(C + TF_MulQ(RQ, F >> Shift) + TF_MulQ(KQ, Tg[x] - C));
+            }
+        }
+    });
+
+    Swap(T, TNext);
+}
+
+void FThermoForgeFixedGrid::Step(const FThermoFixedClimate& Climate, TConstArrayView<FThermoFixedSource> Sources, const FParams& Params)
+{
+    if (PDim.X <= 0) return;
+
+    ComposeTarget(Climate, Sources);
+    for (int32 s=0; s<FMath::Max(1, Params.Split); ++s)
+    {
+        Diffuse(Params.RQ, Params.KQ);
+    }
+    UpdateChecksum();
+}
+
+void FThermoForgeFixedGrid::Snap(const FThermoFixedClimate& Climate, TConstArrayView<FThermoFixedSource> Sources)
+{
+    if (PDim.X <= 0) return;
+
+    ComposeTarget(Climate, Sources);
+    for (int32 z=0; z<Dim.Z; ++z)
+    for (int32 y=0; y<Dim.Y; ++y)
+    {
+        const int32 p = Padded(0, y, z);
+        FMemory::Memcpy(T.GetData() + p, Target.GetData() + Index(0, y, z), Dim.X * sizeof(int32));
+        FMemory::Memcpy(TNext.GetData() + p, Target.GetData() + Index(0, y, z), Dim.X * sizeof(int32));
+    }
+    UpdateChecksum();
+}
+
+void FThermoForgeFixedGrid::UpdateChecksum()
+{
+    // Guard cells are always 0, so the padded buffer hashes the same on every peer
+    Checksum = FCrc::MemCrc32(T.GetData(), T.Num() * sizeof(int32));
+}
+
+bool FThermoForgeFixedGrid::SampleTemp(const FVector& P, float& OutTempC) const
+{
+    if (PDim.X <= 0) return false;
+
+    FIntVector Cells[8]; float W[8];
+    if (!FThermoForgeComposedGrid::TrilinearCells(InvFrame.TransformPosition(P), CellSizeCm, Dim, Cells, W)) return false;
+
+    float Sum = 0.f;
+    for (int32 k=0; k<8; ++k)
+    {
+        Sum += W[k] * ToFloat(T[Padded(Cells[k].X, Cells[k].Y, Cells[k].Z)]);
+    }
+    OutTempC = Sum;
+    return true;
+}
@@ -14,6 +14,7 @@ static constexpr float TF_EPS_DIR   = 1e-3f;
 static constexpr float TF_EPS_TEMP  = 1e-2f;
 static constexpr float TF_EPS_DIST  = 0.5f;
 static constexpr float TF_EPS_STR   = 1e-3f;
+static constexpr float TF_EPS_GRAD  = 1e-5f; // °C per cm
 
 static float TF_SqrDistToAABB(const FVector& P, const FBox& B, FVector* OutClamped = nullptr)
 {
@@ -102,14 +103,13 @@ UPrimitiveComponent* UThermoForgeHeatFXComponent::ResolveOverridePrimitive() con
 	return nullptr;
 }
 
-float UThermoForgeHeatFXComponent::SampleTempAt(const FVector& P) const
+float UThermoForgeHeatFXComponent::SampleTempAt(const FVector& P, FThermoQueryCursor* Cursor) const
 {
 	if (const UWorld* W = GetWorld())
 	{
 		if (const auto* TF = W->GetSubsystem<UThermoForgeSubsystem>())
 		{
-			// Wire your season/time/weather later as needed
-			return TF->ComputeCurrentTemperatureAt(P, /*bWinter=*/false, /*TimeHours=*/12.f, /*WeatherAlpha01=*/0.3f);
+			return Cursor ? TF->ComputeTemperatureNow(P, *Cursor) : TF->ComputeTemperatureNow(P);
 		}
 	}
 	return 0.f;
@@ -152,21 +152,37 @@ bool UThermoForgeHeatFXComponent::ResolveOrigin_Probe(const FVector& CenterWS, b
 	if (UWorld* W = GetWorld())
 		if (const auto* TF = W->GetSubsystem<UThermoForgeSubsystem>())
 		{
-			// UTC is now since other calculations are post process
 			FThermoForgeGridHit Hit;
-			if (TF->FindBakedExtremeNear(CenterWS, ProbeRadiusCm, bFindHottest, Hit, FDateTime::Now()))
+			if (TF->FindBakedExtremeNearNow(CenterWS, ProbeRadiusCm, bFindHottest, Hit))
 			{
 				OutOriginWS = Hit.CellCenterWS;
 
 				// Strength matches your previous semantics: |ΔT| vs center — but using baked-only temps.
-				const float TCenter = TF->ComputeBakedOnlyTemperatureAt(CenterWS, /*bWinter=*/false, /*TimeHours=*/12.f, /*WeatherAlpha01=*/0.3f);
+				const float TCenter = TF->ComputeBakedOnlyTemperatureNow(CenterWS);
 				OutStrength = FMath::Abs(Hit.CurrentTempC - TCenter);
 				return true;
 			}
 		}
 
-	// Fallback to old runtime ring probe if no baked field
 	const float R   = FMath::Max(ProbeRadiusCm, 10.f);
+
+	// No baked field: follow the horizontal temperature gradient (one analytic query)
+	if (const UWorld* W = GetWorld())
+		if (const auto* TF = W->GetSubsystem<UThermoForgeSubsystem>())
+		{
+			FVector Grad;
+			TF->ComputeTemperatureGradientAt(CenterWS, Grad);
+			const FVector Flat(Grad.X, Grad.Y, 0.f);
+			if (Flat.SizeSquared() > FMath::Square(TF_EPS_GRAD))
+			{
+				const FVector Dir = (bFindHottest ? Flat : -Flat).GetSafeNormal();
+				OutOriginWS = CenterWS + Dir * R;
+				OutStrength = Flat.Size() * R; // first-order |ΔT| across the probe radius
+				return true;
+			}
+		}
+
+	// Flat field: old runtime ring probe
 	const int32 N   = FMath::Clamp(ProbeSamples, 4, 64);
 	float BestTemp  = bFindHottest ? -FLT_MAX : +FLT_MAX;
 	FVector BestPos = CenterWS;
@@ -194,7 +210,7 @@ void UThermoForgeHeatFXComponent::TickHeat()
 	const FVector Center = GetOwner()->GetActorLocation();
 
 	// 1) Temperature at owner
-	const float TNow = SampleTempAt(Center);
+	const float TNow = SampleTempAt(Center, &OwnerCursor);
 
 	// 2) Resolve origin based on mode
 	FVector OriginWS = FVector::ZeroVector;
@@ -358,14 +374,8 @@ void UThermoForgeHeatFXComponent::WriteCustomPrimitiveData()
 
 				// Compose baked-only temp
 				const UThermoForgeSubsystem* TF = W->GetSubsystem<UThermoForgeSubsystem>();
-				const UThermoForgeProjectSettings* S = TF ? TF->GetSettings() : GetDefault<UThermoForgeProjectSettings>();
-				const bool  bWinter     = false;
-				const float TimeHours   = 12.f;
-				const float WeatherAlfa = S ? S->DefaultWeatherAlpha01 : 0.3f;
-
-				const float AmbientOwnerC = S ? S->GetAmbientCelsiusAt(bWinter, TimeHours, OwnerPos.Z) : 0.f;
-				const float SolarOwnerC   = (S ? S->SolarGainScaleC : 6.f) * SkyOwner * (1.f - WeatherAlfa);
-				BakedOwnerTempC           = AmbientOwnerC + SolarOwnerC;
+				const FThermoBakedTempModel Model = TF ? TF->GetClimateState().ToBakedModel() : FThermoBakedTempModel();
+				BakedOwnerTempC = Model.Evaluate(SkyOwner, OwnerPos.Z);
 
 				// ----- nearest baked cell center -----
 				// Map to nearest CENTER: round((x/cell) - 0.5)
@@ -381,9 +391,7 @@ void UThermoForgeHeatFXComponent::WriteCustomPrimitiveData()
 				BakedSky01       = FMath::Clamp(Field->GetSkyViewByLinearIdx(Lin), 0.f, 1.f);
 
 				// Baked-only temp at that cell's center
-				const float AmbientCellC = S ? S->GetAmbientCelsiusAt(bWinter, TimeHours, BakedCellCenterWS.Z) : 0.f;
-				const float SolarCellC   = (S ? S->SolarGainScaleC : 6.f) * BakedSky01 * (1.f - WeatherAlfa);
-				BakedCellTempC           = AmbientCellC + SolarCellC;
+				BakedCellTempC = Model.Evaluate(BakedSky01, BakedCellCenterWS.Z);
 			}
 		}
 	}
@@ -0,0 +1,98 @@
+﻿#include "ThermoForgeInertia.h"
+#include "ThermoForgeComposedGrid.h"
+#include "ThermoForgeFieldAsset.h"
+
+void FThermoForgeInertiaGrid::Init(const UThermoForgeFieldAsset* InField, const FParams& Params, TConstArrayView<float> SeedC, double NowSeconds)
+{
+    Field = InField;
+    Dim   = InField ? InField->Dim : FIntVector::ZeroValue;
+    NextChunk = 0;
+    bSeeding  = true;
+
+    const int32 N = (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? (Dim.X*Dim.Y*Dim.Z) : 0;
+    if (!InField || N <= 0)
+    {
+        Dim = FIntVector::ZeroValue;
+        T.Empty(); InvTau.Empty(); ChunkTime.Empty();
+        return;
+    }
+
+    CellSizeCm = FMath::Max(1.f, InField->CellSizeCm);
+    InvFrame   = InField->GetGridFrame().Inverse();
+
+    BuiltOutdoorSeconds = Params.OutdoorSeconds;
+    BuiltIndoorSeconds  = Params.IndoorSeconds;
+
+    InvTau.SetNumUninitialized(N);
+    for (int32 i=0; i<N; ++i)
+    {
+        const float Indoor = FMath::Clamp(InField->GetIndoorByLinearIdx(i), 0.f, 1.f);
+        InvTau[i] = 1.f / FMath::Max(0.01f, FMath::Lerp(Params.OutdoorSeconds, Params.IndoorSeconds, Indoor));
+    }
+
+    if (SeedC.Num() == N) T = TArray<float>(SeedC.GetData(), N);
+    else                  T.SetNumZeroed(N);
+
+    ChunkTime.Init(NowSeconds, FMath::DivideAndRoundUp(N, ChunkCells));
+}
+
+bool FThermoForgeInertiaGrid::IsValidFor(const UThermoForgeFieldAsset* InField, const FParams& Params) const
+{
+    return InField && Field.Get() == InField && InField->Dim == Dim && T.Num() > 0
+        && BuiltOutdoorSeconds == Params.OutdoorSeconds && BuiltIndoorSeconds == Params.IndoorSeconds;
+}
+
+int32 FThermoForgeInertiaGrid::Update(double NowSeconds, const FParams& Params, TConstArrayView<float> TargetC)
+{
+    const int32 N = T.Num();
+    const int32 NumChunks = ChunkTime.Num();
+    if (N == 0 || TargetC.Num() != N) return 0;
+
+    // Whole chunks until the budget is spent (at least one)
+    const int32 Budget = FMath::Max(1, Params.CellsPerFrame);
+    int32 Visited = 0;
+    for (int32 c=0; c<NumChunks && Visited < Budget; ++c)
+    {
+        const int32 Chunk = NextChunk;
+        NextChunk = (NextChunk + 1) % NumChunks;
+
+        const float Dt = float(NowSeconds - ChunkTime[Chunk]);
+        ChunkTime[Chunk] = NowSeconds;
+
+        const int32 Begin = Chunk * ChunkCells;
+        const int32 End   = FMath::Min(Begin + ChunkCells, N);
+        Visited += End - Begin;
+        if (Dt <= 0.f) continue;
+
+        for (int32 i=Begin; i<End; ++i)
+        {
+            const float Alpha = 1.f - FMath::Exp(-Dt * InvTau[i]);
+            T[i] += (TargetC[i] - T[i]) * Alpha;
+        }
+    }
+    return Visited;
+}
+
+void FThermoForgeInertiaGrid::Snap(TConstArrayView<float> TargetC, double NowSeconds)
+{
+    if (TargetC.Num() != T.Num()) return;
+
+    FMemory::Memcpy(T.GetData(), TargetC.GetData(), T.Num() * sizeof(float));
+    for (double& Time : ChunkTime) Time = NowSeconds;
+}
+
+bool FThermoForgeInertiaGrid::SampleTemp(const FVector& P, float& OutTempC) const
+{
+    if (T.Num() == 0) return false;
+
+    FIntVector Cells[8]; float W[8];
+    if (!FThermoForgeComposedGrid::TrilinearCells(InvFrame.TransformPosition(P), CellSizeCm, Dim, Cells, W)) return false;
+
+    float Sum = 0.f;
+    for (int32 k=0; k<8; ++k)
+    {
+        Sum += W[k] * T[(Cells[k].Z * Dim.Y + Cells[k].Y) * Dim.X + Cells[k].X];
+    }
+    OutTempC = Sum;
+    return true;
+}
@@ -0,0 +1,217 @@
+﻿#include "ThermoForgeMultigrid.h"
+
+#include "Async/ParallelFor.h"
+
+// Stop coarsening once a level is this small in any axis or in total
+static constexpr int32 TF_MG_MIN_AXIS = 4;
+static constexpr int32 TF_MG_MIN_CELLS = 512;
+static constexpr int32 TF_MG_MAX_LEVELS = 12;
+
+void FThermoForgeMultigrid::Build(const FIntVector& Dim, TConstArrayView<float> Gx, TConstArrayView<float> Gy, TConstArrayView<float> Gz, float Beta)
+{
+    Levels.Reset();
+
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    if (Dim.X <= 0 || Dim.Y <= 0 || Dim.Z <= 0 || Gx.Num() != N || Gy.Num() != N || Gz.Num() != N) return;
+
+    FLevel& L0 = Levels.AddDefaulted_GetRef();
+    L0.Dim  = Dim;
+    L0.Beta = FMath::Max(0.f, Beta);
+    L0.Gx   = TArray<float>(Gx.GetData(), N);
+    L0.Gy   = TArray<float>(Gy.GetData(), N);
+    L0.Gz   = TArray<float>(Gz.GetData(), N);
+
+    while (Levels.Num() < TF_MG_MAX_LEVELS)
+    {
+        const FLevel& F = Levels.Last();
+        if (FMath::Min3(F.Dim.X, F.Dim.Y, F.Dim.Z) < TF_MG_MIN_AXIS || F.Num() <= TF_MG_MIN_CELLS) break;
+
+        FLevel C;
+        C.Dim  = FIntVector(FMath::DivideAndRoundUp(F.Dim.X, 2), FMath::DivideAndRoundUp(F.Dim.Y, 2), FMath::DivideAndRoundUp(F.Dim.Z, 2));
+        C.Beta = F.Beta * 0.25f; // h doubles
+        C.Gx.SetNumZeroed(C.Num());
+        C.Gy.SetNumZeroed(C.Num());
+        C.Gz.SetNumZeroed(C.Num());
+
+        // Coarse face = mean of the fine faces it covers
+        ParallelFor(C.Dim.Z, [&F, &C](int32 cz)
+        {
+            for (int32 cy=0; cy<C.Dim.Y; ++cy)
+            for (int32 cx=0; cx<C.Dim.X; ++cx)
+            {
+                const int32 ci = C.Index(cx,cy,cz);
+                float SX = 0.f, SY = 0.f, SZ = 0.f;
+                int32 NX = 0, NY = 0, NZ = 0;
+                for (int32 a=0; a<2; ++a)
+                for (int32 b=0; b<2; ++b)
+                {
+                    // +X face: fine x = 2cx+1, children over (y,z)
+                    {
+                        const int32 y = 2*cy + a, z = 2*cz + b;
+                        if (cx+1 < C.Dim.X && y < F.Dim.Y && z < F.Dim.Z) { SX += F.Gx[F.Index(2*cx+1, y, z)]; ++NX; }
+                    }
+                    {
+                        const int32 x = 2*cx + a, z = 2*cz + b;
+                        if (cy+1 < C.Dim.Y && x < F.Dim.X && z < F.Dim.Z) { SY += F.Gy[F.Index(x, 2*cy+1, z)]; ++NY; }
+                    }
+                    {
+                        const int32 x = 2*cx + a, y = 2*cy + b;
+                        if (cz+1 < C.Dim.Z && x < F.Dim.X && y < F.Dim.Y) { SZ += F.Gz[F.Index(x, y, 2*cz+1)]; ++NZ; }
+                    }
+                }
+                C.Gx[ci] = NX ? SX / NX : 0.f;
+                C.Gy[ci] = NY ? SY / NY : 0.f;
+                C.Gz[ci] = NZ ? SZ / NZ : 0.f;
+            }
+        });
+
+        Levels.Add(MoveTemp(C));
+    }
+
+    for (FLevel& L : Levels)
+    {
+        L.X.SetNumZeroed(L.Num());
+        L.B.SetNumZeroed(L.Num());
+        L.R.SetNumZeroed(L.Num());
+    }
+}
+
+void FThermoForgeMultigrid::Smooth(FLevel& L, int32 Iterations) const
+{
+    const int32 SY = L.Dim.X, SZ = L.Dim.X * L.Dim.Y;
+    const float Beta = L.Beta;
+
+    for (int32 It=0; It<Iterations; ++It)
+    for (int32 Color=0; Color<2; ++Color)
+    {
+        // Red-black: cells of one colour only read the other, so planes update independently
+        ParallelFor(L.Dim.Z, [&L, SY, SZ, Beta, Color](int32 z)
+        {
+            for (int32 y=0; y<L.Dim.Y; ++y)
+            for (int32 x=(Color + y + z) & 1; x<L.Dim.X; x+=2)
+            {
+                const int32 i = L.Index(x,y,z);
+                float Diag = 0.f, Off = 0.f;
+                auto Face = [&](float G, int32 j){ Diag += G; Off += G * L.X[j]; };
+                if (x+1 < L.Dim.X) Face(L.Gx[i],      i + 1);
+                if (x > 0)         Face(L.Gx[i - 1],  i - 1);
+                if (y+1 < L.Dim.Y) Face(L.Gy[i],      i + SY);
+                if (y > 0)         Face(L.Gy[i - SY], i - SY);
+                if (z+1 < L.Dim.Z) Face(L.Gz[i],      i + SZ);
+                if (z > 0)         Face(L.Gz[i - SZ], i - SZ);
+
+                L.X[i] = (L.B[i] + Beta * Off) / (1.f + Beta * Diag);
+            }
+        });
+    }
+}
+
+float FThermoForgeMultigrid::Residual(FLevel& L) const
+{
+    const int32 SY = L.Dim.X, SZ = L.Dim.X * L.Dim.Y;
+    const float Beta = L.Beta;
+
+    TArray<float> PlaneMax;
+    PlaneMax.SetNumZeroed(L.Dim.Z);
+
+    ParallelFor(L.Dim.Z, [&L, &PlaneMax, SY, SZ, Beta](int32 z)
+    {
+        float M = 0.f;
+        for (int32 y=0; y<L.Dim.Y; ++y)
+        for (int32 x=0; x<L.Dim.X; ++x)
+        {
+            const int32 i = L.Index(x,y,z);
+            const float Xi = L.X[i];
+            float Flux = 0.f;
+            if (x+1 < L.Dim.X) Flux += L.Gx[i]      * (Xi - L.X[i + 1]);
+            if (x > 0)         Flux += L.Gx[i - 1]  * (Xi - L.X[i - 1]);
+            if (y+1 < L.Dim.Y) Flux += L.Gy[i]      * (Xi - L.X[i + SY]);
+            if (y > 0)         Flux += L.Gy[i - SY] * (Xi - L.X[i - SY]);
+            if (z+1 < L.Dim.Z) Flux += L.Gz[i]      * (Xi - L.X[i + SZ]);
+            if (z > 0)         Flux += L.Gz[i - SZ] * (Xi - L.X[i - SZ]);
+
+            const float Ri = L.B[i] - (Xi + Beta * Flux);
+            L.R[i] = Ri;
+            M = FMath::Max(M, FMath::Abs(Ri));
+        }
+        PlaneMax[z] = M;
+    });
+
+    float Max = 0.f;
+    for (float M : PlaneMax) Max = FMath::Max(Max, M);
+    return Max;
+}
+
+void FThermoForgeMultigrid::Restrict(const FLevel& Fine, FLevel& Coarse) const
+{
+    ParallelFor(Coarse.Dim.Z, [&Fine, &Coarse](int32 cz)
+    {
+        for (int32 cy=0; cy<Coarse.Dim.Y; ++cy)
+        for (int32 cx=0; cx<Coarse.Dim.X; ++cx)
+        {
+            float Sum = 0.f; int32 Count = 0;
+            for (int32 dz=0; dz<2; ++dz)
+            for (int32 dy=0; dy<2; ++dy)
+            for (int32 dx=0; dx<2; ++dx)
+            {
+                const int32 x = 2*cx+dx, y = 2*cy+dy, z = 2*cz+dz;
+                if (x < Fine.Dim.X && y < Fine.Dim.Y && z < Fine.Dim.Z) { Sum += Fine.R[Fine.Index(x,y,z)]; ++Count; }
+            }
+            const int32 ci = Coarse.Index(cx,cy,cz);
+            Coarse.B[ci] = Count ? Sum / Count : 0.f;
+            Coarse.X[ci] = 0.f;
+        }
+    });
+}
+
+void FThermoForgeMultigrid::ProlongAdd(const FLevel& Coarse, FLevel& Fine) const
+{
+    ParallelFor(Fine.Dim.Z, [&Fine, &Coarse](int32 z)
+    {
+        for (int32 y=0; y<Fine.Dim.Y; ++y)
+        for (int32 x=0; x<Fine.Dim.X; ++x)
+        {
+            Fine.X[Fine.Index(x,y,z)] += Coarse.X[Coarse.Index(x/2, y/2, z/2)];
+        }
+    });
+}
+
+void FThermoForgeMultigrid::VCycle(int32 Level, const FThermoMultigridParams& Params)
+{
+    FLevel& L = Levels[Level];
+    if (Level == Levels.Num() - 1)
+    {
+        Smooth(L, Params.CoarsestIterations);
+        return;
+    }
+
+    Smooth(L, Params.PreSmooth);
+    Residual(L);
+    Restrict(L, Levels[Level + 1]);
+    VCycle(Level + 1, Params);
+    ProlongAdd(Levels[Level + 1], L);
+    Smooth(L, Params.PostSmooth);
+}
+
+int32 FThermoForgeMultigrid::Solve(TConstArrayView<float> B, TArray<float>& InOutX, const FThermoMultigridParams& Params, float* OutResidualC)
+{
+    if (Levels.Num() == 0 || B.Num() != Levels[0].Num()) return 0;
+
+    FLevel& L0 = Levels[0];
+    FMemory::Memcpy(L0.B.GetData(), B.GetData(), B.Num() * sizeof(float));
+    if (InOutX.Num() == L0.Num()) L0.X = InOutX;
+    else                          L0.X = L0.B;
+
+    int32 Cycles = 0;
+    float Res = Residual(L0);
+    while (Res > Params.ToleranceC && Cycles < Params.MaxCycles)
+    {
+        VCycle(0, Params);
+        Res = Residual(L0);
+        ++Cycles;
+    }
+
+    InOutX = L0.X;
+    if (OutResidualC) *OutResidualC = Res;
+    return Cycles;
+}
@@ -5,11 +5,11 @@ UThermoForgeProjectSettings::UThermoForgeProjectSettings()
 {
 }
 
-static FORCEINLINE float TF_Diurnal(float Avg, float Delta, float TimeOfDayHours)
+static FORCEINLINE float TF_Diurnal(float Avg, float Delta, float TimeOfDayHours, float PeakHour)
 {
-    // Cosine curve: warmest ~15:00, coolest ~03:00
+    // Cosine curve: warmest at PeakHour (default ~15:00), coolest 12h later
     const float ClampedH = FMath::Clamp(TimeOfDayHours, 0.0f, 24.0f);
-    const float Phase    = (ClampedH - 15.0f) / 24.0f;   // shift so peak at 15:00
+    const float Phase    = (ClampedH - PeakHour) / 24.0f;
     const float Osc      = FMath::Cos(2.0f * PI * Phase);// -1..+1
     return Avg + 0.5f * Delta * Osc;
 }
@@ -18,7 +18,7 @@ float UThermoForgeProjectSettings::GetAmbientCelsius(bool bWinter, float TimeOfD
 {
     const float Avg   = bWinter ? WinterAverageC       : SummerAverageC;
     const float Delta = bWinter ? WinterDayNightDeltaC : SummerDayNightDeltaC;
-    return TF_Diurnal(Avg, Delta, TimeOfDayHours);
+    return TF_Diurnal(Avg, Delta, TimeOfDayHours, DiurnalPeakHour);
 }
 
 float UThermoForgeProjectSettings::AdjustForAltitude(float BaseCelsius, float WorldZcm) const
@@ -37,6 +37,43 @@ float UThermoForgeProjectSettings::GetAmbientCelsiusAt(bool bWinter, float TimeO
     return AdjustForAltitude(GetAmbientCelsius(bWinter, TimeOfDayHours), WorldZcm);
 }
 
+float UThermoForgeProjectSettings::GetAmbientCelsiusAtSeason(float SeasonAlpha01, float TimeOfDayHours, float WorldZcm) const
+{
+    // Blend the season parameters, then evaluate a single diurnal curve
+    const float A     = FMath::Clamp(SeasonAlpha01, 0.0f, 1.0f);
+    const float Avg   = FMath::Lerp(WinterAverageC,       SummerAverageC,       A);
+    const float Delta = FMath::Lerp(WinterDayNightDeltaC, SummerDayNightDeltaC, A);
+    return AdjustForAltitude(TF_Diurnal(Avg, Delta, TimeOfDayHours, DiurnalPeakHour), WorldZcm);
+}
+
+FVector UThermoForgeProjectSettings::GetSunDirectionAtSeason(float SeasonAlpha01, float TimeOfDayHours) const
+{
+    // Declination swings ±23.44° between the solstices; the hour angle turns 15° per hour from solar noon
+    const float Decl = FMath::DegreesToRadians(23.44f * (2.0f * FMath::Clamp(SeasonAlpha01, 0.0f, 1.0f) - 1.0f));
+    const float Hour = FMath::DegreesToRadians(15.0f * (FMath::Clamp(TimeOfDayHours, 0.0f, 24.0f) - 12.0f));
+    const float Lat  = FMath::DegreesToRadians(FMath::Clamp(LatitudeDeg, -90.0f, 90.0f));
+
+    // Local east / north / up
+    const float E = -FMath::Cos(Decl) * FMath::Sin(Hour);
+    const float N =  FMath::Sin(Decl) * FMath::Cos(Lat) - FMath::Cos(Decl) * FMath::Sin(Lat) * FMath::Cos(Hour);
+    const float U =  FMath::Sin(Decl) * FMath::Sin(Lat) + FMath::Cos(Decl) * FMath::Cos(Lat) * FMath::Cos(Hour);
+
+    const float Yaw = FMath::DegreesToRadians(NorthYawDeg);
+    const FVector North(FMath::Cos(Yaw), FMath::Sin(Yaw), 0.0);
+    const FVector East(-FMath::Sin(Yaw), FMath::Cos(Yaw), 0.0);
+
+    const FVector Dir = North * N + East * E + FVector::UpVector * FMath::Max(0.0f, U);
+    return Dir.GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+}
+
+float UThermoForgeProjectSettings::GetSeasonAlphaForDate(const FDateTime& Date)
+{
+    // Northern hemisphere: Dec 21 (~day 355) -> 0, Jun 21 (~day 172) -> 1, smooth cosine over the year
+    const float YearPos = (float(Date.GetDayOfYear()) - 355.0f) / 365.0f;
+    const float Wrapped = YearPos - FMath::FloorToFloat(YearPos);
+    return 0.5f * (1.0f - FMath::Cos(2.0f * PI * Wrapped));
+}
+
 float UThermoForgeProjectSettings::DensityToPermeability(float DensityKgM3, float ThicknessFraction) const
 {
     // Normalize density to [0..1] within [air .. max solid]
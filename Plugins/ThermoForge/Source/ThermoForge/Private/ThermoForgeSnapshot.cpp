@@ -0,0 +1,208 @@
+﻿#include "ThermoForgeSnapshot.h"
+#include "ThermoForgeComposedGrid.h"
+#include "ThermoForgeVolumeIndex.h"
+
+bool FThermoSnapshotVolume::Contains(const FVector& WorldPos) const
+{
+    if (bUnbounded) return true;
+
+    const FVector L = ActorTransform.InverseTransformPosition(WorldPos);
+    return (L.X >= -BoxExtent.X && L.X <= BoxExtent.X)
+        && (L.Y >= -BoxExtent.Y && L.Y <= BoxExtent.Y)
+        && (L.Z >= -BoxExtent.Z && L.Z <= BoxExtent.Z);
+}
+
+float FThermoSnapshotVolume::InnerWeight(const FVector& WorldPos) const
+{
+    return ThermoVolumeInnerWeight(ActorTransform, BoxExtent, bUnbounded, BlendBorderCm, WorldPos);
+}
+
+bool FThermoForgeSnapshot::NearestInVolume(const FThermoSnapshotVolume& V, const FVector& WorldPos,
+    int32& OutLinear, FVector& OutCenter, double& OutDistSq) const
+{
+    const FThermoSnapshotField* F = V.Field.Get();
+    if (!F || F->Dim.X <= 0 || F->Dim.Y <= 0 || F->Dim.Z <= 0 || F->CellSizeCm <= 0.f) return false;
+
+    const float Cell = F->CellSizeCm;
+    const FVector LocalGrid = F->InvFrame.TransformPosition(WorldPos) / Cell;
+
+    const int32 ix = FMath::Clamp(FMath::FloorToInt(LocalGrid.X + 0.5f), 0, F->Dim.X - 1);
+    const int32 iy = FMath::Clamp(FMath::FloorToInt(LocalGrid.Y + 0.5f), 0, F->Dim.Y - 1);
+    const int32 iz = FMath::Clamp(FMath::FloorToInt(LocalGrid.Z + 0.5f), 0, F->Dim.Z - 1);
+
+    OutLinear = F->Index(ix, iy, iz);
+    OutCenter = F->Frame.TransformPosition(FVector((ix + 0.5f) * Cell, (iy + 0.5f) * Cell, (iz + 0.5f) * Cell));
+    OutDistSq = FVector::DistSquared(OutCenter, WorldPos);
+    return true;
+}
+
+bool FThermoForgeSnapshot::FindNearestCell(const FVector& WorldPos, int32& OutVolume, int32& OutLinearIndex, FVector& OutCellCenterWS) const
+{
+    OutVolume = INDEX_NONE;
+    double BestDistSq = TNumericLimits<double>::Max();
+
+    // Finest containing volume (resolve order), else the nearest cell anywhere
+    for (int32 v=0; v<Volumes.Num(); ++v)
+    {
+        int32 Linear; FVector Center; double DistSq;
+        if (Volumes[v].Contains(WorldPos) && NearestInVolume(Volumes[v], WorldPos, Linear, Center, DistSq))
+        {
+            OutVolume       = v;
+            OutLinearIndex  = Linear;
+            OutCellCenterWS = Center;
+            return true;
+        }
+    }
+
+    for (int32 v=0; v<Volumes.Num(); ++v)
+    {
+        int32 Linear; FVector Center; double DistSq;
+        if (NearestInVolume(Volumes[v], WorldPos, Linear, Center, DistSq) && DistSq < BestDistSq)
+        {
+            BestDistSq      = DistSq;
+            OutVolume       = v;
+            OutLinearIndex  = Linear;
+            OutCellCenterWS = Center;
+        }
+    }
+    return OutVolume != INDEX_NONE;
+}
+
+bool FThermoForgeSnapshot::SampleComposed(const FThermoSnapshotVolume& V, const FVector& WorldPos, float& OutSourceC, float& OutSky01) const
+{
+    const FThermoSnapshotField* F = V.Field.Get();
+    const FThermoSnapshotComposed* C = V.Composed.Get();
+    if (!F || !C) return false;
+
+    constexpr int32 B = FThermoForgeComposedGrid::BrickSize;
+    const FIntVector ExpectBricks(FMath::DivideAndRoundUp(F->Dim.X, B), FMath::DivideAndRoundUp(F->Dim.Y, B), FMath::DivideAndRoundUp(F->Dim.Z, B));
+    if (C->BrickDim != ExpectBricks || C->Bricks.Num() != ExpectBricks.X * ExpectBricks.Y * ExpectBricks.Z) return false;
+
+    FIntVector Cells[8]; float W[8];
+    if (!FThermoForgeComposedGrid::TrilinearCells(F->InvFrame.TransformPosition(WorldPos), F->CellSizeCm, F->Dim, Cells, W)) return false;
+
+    float Src = 0.f, Sky = 0.f;
+    for (int32 k=0; k<8; ++k)
+    {
+        const FIntVector& c = Cells[k];
+        float CellSourceC = 0.f;
+        if (!C->SourceAt(c, CellSourceC)) return false;
+
+        Src += W[k] * CellSourceC;
+        Sky += W[k] * F->SolarAt(F->Index(c.X, c.Y, c.Z), Climate.SunDirWS);
+    }
+    OutSourceC = Src;
+    OutSky01   = Sky;
+    return true;
+}
+
+float FThermoForgeSnapshot::WeatherOffsetAt(const FVector& WorldPos) const
+{
+    if (!Weather) return 0.f;
+
+    float Sky = 0.f;
+    int32 v, Linear; FVector Center;
+    if (FindNearestCell(WorldPos, v, Linear, Center)) Sky = Volumes[v].Field->SolarAt(Linear, Climate.SunDirWS);
+    return Weather->TemperatureOffsetC(WorldPos, Sky, Climate.WeatherAlpha01);
+}
+
+float FThermoForgeSnapshot::ComputeTemperatureAt(const FVector& WorldPos) const
+{
+    const float AmbientC = Climate.AmbientAtZ(WorldPos.Z) + WeatherOffsetAt(WorldPos);
+
+    // Sources without line-of-sight attenuation
+    auto ComposeAtCell = [&](const FThermoSnapshotField& F, int32 Linear)
+    {
+        const float WallPerm = F.WallAt(Linear);
+        float SourceSum = 0.f;
+        for (const FThermoSnapshotSource& S : Sources)
+        {
+            if (!S.BoundsWS.IsInsideOrOn(WorldPos)) continue;
+            SourceSum += S.Shape.SampleAt(WorldPos) * WallPerm;
+        }
+        return AmbientC + Climate.SolarC * F.SolarAt(Linear, Climate.SunDirWS) + SourceSum;
+    };
+
+    // Containing volumes finest first, each fading into the next across its border band
+    float Sum = 0.f, Remaining = 1.f, Last = 0.f;
+    int32 Depth = 0;
+    for (int32 v=0; v<Volumes.Num() && Depth < FThermoForgeVolumeIndex::MaxBlendDepth; ++v)
+    {
+        const FThermoSnapshotVolume& V = Volumes[v];
+        if (!V.Contains(WorldPos)) continue;
+
+        float T = 0.f, SourceC, Sky;
+        int32 Linear; FVector Center; double DistSq;
+        if (V.Composed && SampleComposed(V, WorldPos, SourceC, Sky))       T = AmbientC + Climate.SolarC * Sky + SourceC;
+        else if (NearestInVolume(V, WorldPos, Linear, Center, DistSq))     T = ComposeAtCell(*V.Field, Linear);
+        else continue;
+        ++Depth;
+
+        const float W = FMath::Clamp(V.InnerWeight(WorldPos), 0.f, 1.f);
+        Sum       += Remaining * W * T;
+        Remaining *= 1.f - W;
+        Last       = T;
+        if (Remaining <= KINDA_SMALL_NUMBER) break;
+    }
+    if (Depth > 0) return Sum + Remaining * Last;
+
+    int32 v, Linear; FVector Center;
+    if (FindNearestCell(WorldPos, v, Linear, Center)) return ComposeAtCell(*Volumes[v].Field, Linear);
+
+    float SourceSum = 0.f;
+    for (const FThermoSnapshotSource& S : Sources)
+    {
+        if (S.BoundsWS.IsInsideOrOn(WorldPos)) SourceSum += S.Shape.SampleAt(WorldPos);
+    }
+    return AmbientC + SourceSum;
+}
+
+float FThermoForgeSnapshot::ComputeBakedOnlyTemperatureAt(const FVector& WorldPos) const
+{
+    float Sky = 0.f;
+    int32 v, Linear; FVector Center;
+    if (FindNearestCell(WorldPos, v, Linear, Center))
+    {
+        Sky = Volumes[v].Field->SkyAt(Linear);
+    }
+    return Climate.ToBakedModel().Evaluate(Sky, WorldPos.Z);
+}
+
+bool FThermoForgeSnapshot::FindBakedExtremeNear(const FVector& CenterWS, float RadiusCm, bool bHottest, FThermoSnapshotCellHit& OutHit) const
+{
+    OutHit = FThermoSnapshotCellHit();
+
+    int32 v, Linear; FVector Seed;
+    if (!FindNearestCell(CenterWS, v, Linear, Seed)) return false;
+
+    const FThermoSnapshotField& F = *Volumes[v].Field;
+    const float Cell = FMath::Max(1.f, F.CellSizeCm);
+    const FVector CenterCell = F.InvFrame.TransformPosition(CenterWS) / Cell;
+
+    FThermoBakedExtremeQuery Q;
+    Q.CenterCell = FIntVector(
+        FMath::Clamp(FMath::FloorToInt(CenterCell.X + 0.5f), 0, F.Dim.X-1),
+        FMath::Clamp(FMath::FloorToInt(CenterCell.Y + 0.5f), 0, F.Dim.Y-1),
+        FMath::Clamp(FMath::FloorToInt(CenterCell.Z + 0.5f), 0, F.Dim.Z-1));
+    Q.RadiusCells = FMath::Clamp(FMath::CeilToInt(RadiusCm / Cell), 0, 1024);
+    Q.bHottest    = bHottest;
+    Q.Model       = Climate.ToBakedModel();
+
+    FIntVector BestIdx;
+    float BestTemp = 0.f;
+    if (!UThermoForgeFieldAsset::FindExtremeCellInView(F.MakeSearchView(), Q, BestIdx, BestTemp)) return false;
+
+    const FVector BestPos = F.Frame.TransformPosition(
+        FVector((BestIdx.X+0.5f)*Cell, (BestIdx.Y+0.5f)*Cell, (BestIdx.Z+0.5f)*Cell));
+
+    OutHit.bFound       = true;
+    OutHit.Volume       = Volumes[v].Volume;
+    OutHit.GridIndex    = BestIdx;
+    OutHit.LinearIndex  = F.Index(BestIdx.X, BestIdx.Y, BestIdx.Z);
+    OutHit.CellCenterWS = BestPos;
+    OutHit.DistanceSq   = FVector::DistSquared(BestPos, CenterWS);
+    OutHit.CellSizeCm   = F.CellSizeCm;
+    OutHit.TempC        = BestTemp;
+    OutHit.TimeUTC      = Climate.TimeUTC;
+    return true;
+}
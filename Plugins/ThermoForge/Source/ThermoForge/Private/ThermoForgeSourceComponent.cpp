@@ -57,26 +57,32 @@ FBox UThermoForgeSourceComponent::GetBoundsWS() const
     }
 }
 
-float UThermoForgeSourceComponent::SampleAt(const FVector& P) const
+FThermoSourceShape UThermoForgeSourceComponent::GetShapeWS() const
 {
-    if (!bEnabled) return 0.f;
-
-    const FTransform T = GetOwnerTransformSafe();
-    const FVector    L = T.GetLocation();
-    const float      scale = bAffectByOwnerScale ? T.GetMaximumAxisScale() : 1.f;
+    FThermoSourceShape Out;
+    Out.Transform        = GetOwnerTransformSafe();
+    Out.Shape            = Shape;
+    Out.Falloff          = Falloff;
+    Out.IntensityCelsius = IntensityCelsius;
+
+    const float scale = bAffectByOwnerScale ? Out.Transform.GetMaximumAxisScale() : 1.f;
+    Out.RadiusCm  = RadiusCm * scale;
+    Out.BoxExtent = bAffectByOwnerScale ? (BoxExtent * scale) : BoxExtent;
+    return Out;
+}
 
+float FThermoSourceShape::SampleAt(const FVector& P) const
+{
     if (Shape == EThermoSourceShape::Point)
     {
-        const float R = RadiusCm * scale;
-        const float d = FVector::Distance(P, L);
-        const float w = PointFalloffWeight(Falloff, d, R);
+        const float d = FVector::Distance(P, Transform.GetLocation());
+        const float w = PointFalloffWeight(Falloff, d, RadiusCm);
         return IntensityCelsius * w;
     }
     else
     {
-        const FVector Ext = bAffectByOwnerScale ? (BoxExtent * scale) : BoxExtent;
-        const FVector LocalP = T.InverseTransformPosition(P);
-        const FVector Min = -Ext, Max = Ext;
+        const FVector LocalP = Transform.InverseTransformPosition(P);
+        const FVector Min = -BoxExtent, Max = BoxExtent;
 
         const bool bInside =
             (LocalP.X >= Min.X && LocalP.X <= Max.X) &&
@@ -87,6 +93,45 @@ float UThermoForgeSourceComponent::SampleAt(const FVector& P) const
     }
 }
 
+float FThermoSourceShape::SampleWithGradient(const FVector& P, FVector& OutGradient) const
+{
+    OutGradient = FVector::ZeroVector;
+    if (Shape != EThermoSourceShape::Point) return SampleAt(P);
+
+    const FVector D = P - Transform.GetLocation();
+    const float   d = D.Size();
+    const float   R = RadiusCm;
+    if (R <= KINDA_SMALL_NUMBER || d >= R) return 0.f;
+
+    // dw/dd along the radial direction
+    float dw = 0.f;
+    switch (Falloff)
+    {
+        case EThermoSourceFalloff::None:   dw = 0.f; break;
+        case EThermoSourceFalloff::Linear: dw = -1.f / R; break;
+        case EThermoSourceFalloff::InverseSquare:
+        default:
+        {
+            const float x = d / R;
+            const float q = 1.f + x * x;
+            dw = -2.f * x / (R * q * q);
+            break;
+        }
+    }
+
+    if (d > KINDA_SMALL_NUMBER)
+    {
+        OutGradient = (IntensityCelsius * dw / d) * D;
+    }
+    return IntensityCelsius * PointFalloffWeight(Falloff, d, R);
+}
+
+float UThermoForgeSourceComponent::SampleAt(const FVector& P) const
+{
+    if (!bEnabled) return 0.f;
+    return GetShapeWS().SampleAt(P);
+}
+
 void UThermoForgeSourceComponent::OnRegister()
 {
     Super::OnRegister();
@@ -1,19 +1,26 @@
 ﻿#include "ThermoForgeSubsystem.h"
 #include "ThermoForgeProjectSettings.h"
 #include "ThermoForgeFieldAsset.h"
+#include "ThermoForgeFieldExport.h"
+#include "ThermoForgeFieldPatch.h"
 #include "ThermoForgeVolume.h"
 #include "ThermoForgeSourceComponent.h"
 
 #include "EngineUtils.h"
 #include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
 #include "CollisionQueryParams.h"
 #include "DrawDebugHelpers.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "Components/PrimitiveComponent.h"
 
 #include "UObject/SavePackage.h"
 #include "Misc/PackageName.h"
 #include "Misc/Paths.h"
 #include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeRWLock.h"
+#include "Async/Async.h"
 #include "PhysicsEngine/BodySetup.h"
 
 #if WITH_EDITOR
@@ -31,14 +38,550 @@ const UThermoForgeProjectSettings* UThermoForgeSubsystem::GetSettings() const
 void UThermoForgeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
     Super::Initialize(Collection);
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    WeatherAlpha01 = S->DefaultWeatherAlpha01;
+    GameTimeScale  = S->GameTimeScale;
+    SetGameClock(S->GameStartDayOfYear, S->GameStartTimeOfDayHours);
+
+    FieldPatchedHandle = UThermoForgeFieldAsset::OnFieldPatched.AddUObject(this, &UThermoForgeSubsystem::HandleFieldPatched);
 }
 
 void UThermoForgeSubsystem::Deinitialize()
 {
+    UThermoForgeFieldAsset::OnFieldPatched.Remove(FieldPatchedHandle);
+    PermOverrides.Empty();
+    Blockers.Empty();
+    ComposedGrids.Empty();
+    SourceStamps.Empty();
+    DiffusionGrids.Empty();
+    WindFields.Empty();
+    InertiaGrids.Empty();
+    FixedGrids.Empty();
+    Clipmaps.Empty();
+    ZoneLayers.Empty();
+    VolumeIndex.Reset();
+    bVolumeIndexDirty = true;
+    WeatherMap.Reset();
+    PublishedWeather.Reset();
+    SnapshotCache.Empty();
+    {
+        FWriteScopeLock Lock(SnapshotLock);
+        Snapshot.Reset();
+    }
     SourceSet.Empty();
     Super::Deinitialize();
 }
 
+// ---- climate clock ----
+void UThermoForgeSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    // Only advances while the world ticks (pauses with the game)
+    GameClockSeconds += double(DeltaTime) * GameTimeScale;
+    RebuildClimateState();
+    UpdateWeatherMap(DeltaTime);
+    UpdateBlockers();
+
+    UpdateComposedGrids();
+    UpdateClipmaps();
+    UpdateDiffusion(DeltaTime);
+    UpdateInertia();
+    UpdateDeterministic();
+    UpdateZoneLayers();
+    PublishSnapshot();
+}
+
+TStatId UThermoForgeSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UThermoForgeSubsystem, STATGROUP_Tickables);
+}
+
+void UThermoForgeSubsystem::SetWeatherAlpha(float InWeatherAlpha01)
+{
+    WeatherAlpha01 = FMath::Clamp(InWeatherAlpha01, 0.f, 1.f);
+    RebuildClimateState();
+}
+
+void UThermoForgeSubsystem::SetGameClock(int32 DayOfYear, float TimeOfDayHours)
+{
+    // Fixed non-leap reference year; only day-of-year and time of day matter
+    const int32 Day   = FMath::Clamp(DayOfYear, 1, 365);
+    const float Hours = FMath::Clamp(TimeOfDayHours, 0.f, 24.f);
+    GameClockStart   = FDateTime(2025, 1, 1) + FTimespan::FromDays(Day - 1) + FTimespan::FromHours(Hours);
+    GameClockSeconds = 0.0;
+    RebuildClimateState();
+}
+
+void UThermoForgeSubsystem::SetGameTimeScale(float InScale)
+{
+    GameTimeScale = FMath::Max(0.f, InScale);
+}
+
+// Sun the solar term is weighted towards; zero keeps the isotropic SkyView01
+static FVector TF_SunDirFor(const UThermoForgeProjectSettings* S, float SeasonAlpha01, float TimeHours)
+{
+    return (S && S->bDirectionalSolarGain) ? S->GetSunDirectionAtSeason(SeasonAlpha01, TimeHours) : FVector::ZeroVector;
+}
+
+void UThermoForgeSubsystem::RebuildClimateState()
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+
+    // The deterministic grid owns the clock while it runs: whole fixed steps, never UtcNow or frame deltas
+    FDateTime Now;
+    if (S->bDeterministicSimulation && UseComposedGrids()) Now = GameClockStart + FTimespan(FixedClockTicks);
+    else if (S->ClockMode == EThermoClockMode::GameTime)   Now = GameClockStart + FTimespan::FromSeconds(GameClockSeconds);
+    else                                                    Now = FDateTime::UtcNow();
+
+    FThermoClimateState C = MakeClimateState(Now);
+    C.Revision = ClimateState.Revision + 1;
+
+    ClimateState = C;
+}
+
+FThermoClimateState UThermoForgeSubsystem::MakeClimateState(const FDateTime& TimeUTC) const
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+
+    FThermoClimateState C;
+    C.TimeUTC        = TimeUTC;
+    C.TimeOfDayHours = float(C.TimeUTC.GetTimeOfDay().GetTotalHours());
+    C.DayOfYear      = C.TimeUTC.GetDayOfYear();
+    C.SeasonAlpha01  = UThermoForgeProjectSettings::GetSeasonAlphaForDate(C.TimeUTC);
+    C.WeatherAlpha01 = WeatherAlpha01;
+
+    // Evaluated at sea level so no lapse is folded in; AmbientAtZ applies it per query
+    C.SeaLevelZcm      = S->SeaLevelZcm;
+    C.AmbientSeaLevelC = S->GetAmbientCelsiusAtSeason(C.SeasonAlpha01, C.TimeOfDayHours, S->SeaLevelZcm);
+    C.LapseCPerCm      = (S->bEnableAltitudeLapse && S->LapseRateCPerKm > 0.f) ? S->LapseRateCPerKm / 100000.f : 0.f;
+    C.SolarC           = S->SolarGainScaleC * (1.f - C.WeatherAlpha01);
+    C.SunDirWS         = TF_SunDirFor(S, C.SeasonAlpha01, C.TimeOfDayHours);
+    return C;
+}
+
+// ---- weather map ----
+static FThermoForgeWeatherMap::FParams TF_WeatherParams(const UThermoForgeProjectSettings* S)
+{
+    FThermoForgeWeatherMap::FParams P;
+    P.Resolution = S->WeatherMapResolution;
+    P.CellSizeCm = S->WeatherMapCellSizeCm;
+    P.CenterWS   = S->WeatherMapCenterWS;
+    return P;
+}
+
+void UThermoForgeSubsystem::UpdateWeatherMap(float DeltaTime)
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S->bUseWeatherMap)
+    {
+        WeatherMap.Reset();
+        return;
+    }
+
+    const FThermoForgeWeatherMap::FParams P = TF_WeatherParams(S);
+    if (!WeatherMap.IsValid())
+    {
+        WeatherMap = MakeShared<FThermoForgeWeatherMap>();
+    }
+    if (!WeatherMap->IsValidFor(P))
+    {
+        WeatherMap->Init(P, WeatherAlpha01);
+        WeatherStepAccum = 0.f;
+    }
+    WeatherMap->SetResponse(S->SolarGainScaleC, S->PrecipitationCoolingC);
+
+    // Fixed steps keep the drift independent of frame rate; a long hitch drops steps rather than stalling
+    const float Step = FMath::Max(0.02f, S->WeatherStepSeconds);
+    WeatherStepAccum += DeltaTime * GameTimeScale;
+    const int32 Steps = FMath::Min(FMath::FloorToInt(WeatherStepAccum / Step), 4);
+    WeatherStepAccum = FMath::Min(WeatherStepAccum - Steps * Step, Step);
+
+    const FVector2D Wind = GetWeatherWind();
+    for (int32 i=0; i<Steps; ++i)
+    {
+        WeatherMap->Advect(Step, Wind, S->WeatherRelaxSeconds, WeatherAlpha01);
+    }
+}
+
+FVector2D UThermoForgeSubsystem::GetWeatherWind() const
+{
+    return bHasWeatherWind ? WeatherWind : GetSettings()->WeatherWindCmPerSec;
+}
+
+void UThermoForgeSubsystem::AddWeatherSystem(const FVector& CenterWS, float RadiusCm, float Cloud01, float Precip01, float WindChillC)
+{
+    if (!WeatherMap.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] AddWeatherSystem: weather map is off (bUseWeatherMap)."));
+        return;
+    }
+
+    FThermoForgeWeatherMap::FSample Peak;
+    Peak.Cloud01    = Cloud01;
+    Peak.Precip01   = Precip01;
+    Peak.WindChillC = WindChillC;
+    WeatherMap->AddSystem(CenterWS, RadiusCm, Peak);
+}
+
+void UThermoForgeSubsystem::SetWeatherWind(const FVector2D& WindCmPerSec)
+{
+    WeatherWind     = WindCmPerSec;
+    bHasWeatherWind = true;
+}
+
+bool UThermoForgeSubsystem::GetWeatherAt(const FVector& WorldPos, float& OutCloud01, float& OutPrecip01, float& OutWindChillC) const
+{
+    FThermoForgeWeatherMap::FSample W;
+    W.Cloud01 = WeatherAlpha01;
+    const bool bInMap = WeatherMap.IsValid() && WeatherMap->Sample(WorldPos, W);
+
+    OutCloud01    = W.Cloud01;
+    OutPrecip01   = W.Precip01;
+    OutWindChillC = W.WindChillC;
+    return bInMap;
+}
+
+float UThermoForgeSubsystem::WeatherOffsetAtHit(const FVector& WorldPos, const FThermoForgeGridHit& Hit) const
+{
+    if (!WeatherMap.IsValid()) return 0.f;
+
+    const UThermoForgeFieldAsset* Field = (Hit.bFound && Hit.Volume) ? Hit.Volume->BakedField : nullptr;
+    const float Sky = Field ? Field->GetSolarViewByLinearIdx(Hit.LinearIndex, ClimateState.SunDirWS) : 0.f;
+    return WeatherMap->TemperatureOffsetC(WorldPos, Sky, ClimateState.WeatherAlpha01);
+}
+
+float UThermoForgeSubsystem::WeatherOffsetAt(const FVector& WorldPos) const
+{
+    if (!WeatherMap.IsValid()) return 0.f;
+
+    FThermoForgeGridHit Hit;
+    FindNearestCellPreferContaining(WorldPos, Hit);
+    return WeatherOffsetAtHit(WorldPos, Hit);
+}
+
+// ---- dynamic blockers ----
+int32 UThermoForgeSubsystem::AddDynamicBlocker(UPrimitiveComponent* Blocker, float Open01)
+{
+    if (!Blocker)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] AddDynamicBlocker: no component."));
+        return 0;
+    }
+    if (!CanAddBlocker(TEXT("AddDynamicBlocker"))) return 0;
+
+    FThermoDynamicBlocker B;
+    B.Component = Blocker;
+    B.BoundsWS  = Blocker->Bounds.GetBox();
+    B.Open01    = FMath::Clamp(Open01, 0.f, 1.f);
+    RasteriseBlocker(B);
+
+    const int32 Id = NextBlockerId++;
+    Blockers.Add(Id, MoveTemp(B));
+    return Id;
+}
+
+int32 UThermoForgeSubsystem::AddDynamicBlockerBox(const FBox& BoundsWS, float Open01)
+{
+    if (!BoundsWS.IsValid)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] AddDynamicBlockerBox: invalid bounds."));
+        return 0;
+    }
+    if (!CanAddBlocker(TEXT("AddDynamicBlockerBox"))) return 0;
+
+    FThermoDynamicBlocker B;
+    B.BoundsWS = BoundsWS;
+    B.Open01   = FMath::Clamp(Open01, 0.f, 1.f);
+    RasteriseBlocker(B);
+
+    const int32 Id = NextBlockerId++;
+    Blockers.Add(Id, MoveTemp(B));
+    return Id;
+}
+
+void UThermoForgeSubsystem::SetDynamicBlockerOpen(int32 BlockerId, float Open01)
+{
+    FThermoDynamicBlocker* B = Blockers.Find(BlockerId);
+    if (!B) return;
+
+    // Still tracing: the new fraction goes in once the cells are done
+    B->Open01 = FMath::Clamp(Open01, 0.f, 1.f);
+    if (B->bApplied) ApplyBlocker(*B, /*bRemove=*/false);
+}
+
+void UThermoForgeSubsystem::RemoveDynamicBlocker(int32 BlockerId)
+{
+    FThermoDynamicBlocker* B = Blockers.Find(BlockerId);
+    if (!B) return;
+
+    if (B->bApplied) ApplyBlocker(*B, /*bRemove=*/true);
+    Blockers.Remove(BlockerId);
+}
+
+void UThermoForgeSubsystem::RasteriseBlocker(FThermoDynamicBlocker& Blocker) const
+{
+    Blocker.Cells.Reset();
+    Blocker.NumTraced     = 0;
+    Blocker.AppliedOpen01 = 0.f;
+    Blocker.bApplied      = false;
+
+    UWorld* W = GetWorld();
+    if (!W || !Blocker.BoundsWS.IsValid) return;
+
+    TSet<const UThermoForgeFieldAsset*> Seen;
+    for (TActorIterator<AThermoForgeVolume> It(W); It; ++It)
+    {
+        const UThermoForgeFieldAsset* Field = It->BakedField;
+        if (!Field || Seen.Contains(Field)) continue;
+        Seen.Add(Field);
+
+        const FIntVector Dim = Field->Dim;
+        const float Cell = Field->CellSizeCm;
+        if (Dim.X <= 0 || Dim.Y <= 0 || Dim.Z <= 0 || Cell <= 0.f || Field->WallPermeability01.Num() != Dim.X * Dim.Y * Dim.Z) continue;
+
+        // A cell of margin: the faces into the blocker belong to its neighbours too
+        const FBox Reach = Blocker.BoundsWS.ExpandBy(Cell);
+        const FTransform Frame = Field->GetGridFrame();
+        const FBox Local = Reach.InverseTransformBy(Frame);
+
+        const FIntVector Lo(
+            FMath::Max(0, FMath::CeilToInt(Local.Min.X / Cell - 0.5)),
+            FMath::Max(0, FMath::CeilToInt(Local.Min.Y / Cell - 0.5)),
+            FMath::Max(0, FMath::CeilToInt(Local.Min.Z / Cell - 0.5)));
+        const FIntVector Hi(
+            FMath::Min(Dim.X - 1, FMath::FloorToInt(Local.Max.X / Cell - 0.5)),
+            FMath::Min(Dim.Y - 1, FMath::FloorToInt(Local.Max.Y / Cell - 0.5)),
+            FMath::Min(Dim.Z - 1, FMath::FloorToInt(Local.Max.Z / Cell - 0.5)));
+
+        for (int32 z=Lo.Z; z<=Hi.Z; ++z)
+        for (int32 y=Lo.Y; y<=Hi.Y; ++y)
+        for (int32 x=Lo.X; x<=Hi.X; ++x)
+        {
+            const FVector CenterWS = Frame.TransformPosition(FVector((x + 0.5f) * Cell, (y + 0.5f) * Cell, (z + 0.5f) * Cell));
+            if (!Reach.IsInsideOrOn(CenterWS)) continue; // rotated grids
+
+            FThermoBlockerCell& C = Blocker.Cells.AddDefaulted_GetRef();
+            C.Field       = Field;
+            C.Cell        = FIntVector(x, y, z);
+            C.LinearIndex = Field->Index(x, y, z);
+            C.CenterWS    = CenterWS;
+            C.CellSizeCm  = Cell;
+        }
+    }
+}
+
+void UThermoForgeSubsystem::UpdateBlockers()
+{
+    if (Blockers.Num() == 0) return;
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    const double Deadline = FPlatformTime::Seconds() + double(S->BlockerTraceBudgetMs) / 1000.0;
+
+    static const FVector Axes[6] = { FVector::ForwardVector, FVector::BackwardVector, FVector::RightVector,
+                                     FVector::LeftVector, FVector::UpVector, FVector::DownVector };
+
+    for (TPair<int32, FThermoDynamicBlocker>& Pair : Blockers)
+    {
+        FThermoDynamicBlocker& B = Pair.Value;
+        const UPrimitiveComponent* Ignore = B.Component.Get();
+
+        // Same face estimator as the bake, with the blocker out of the way
+        while (!B.IsTraced())
+        {
+            FThermoBlockerCell& C = B.Cells[B.NumTraced++];
+            float Perm = 0.f;
+            for (const FVector& A : Axes)
+            {
+                Perm += FMath::Clamp(OcclusionBetweenIgnoring(C.CenterWS, C.CenterWS + A * C.CellSizeCm, C.CellSizeCm, Ignore), 0.f, 1.f);
+            }
+            C.OpenPerm01 = Perm / 6.f;
+
+            if (FPlatformTime::Seconds() >= Deadline && !B.IsTraced()) return;
+        }
+        if (!B.bApplied) ApplyBlocker(B, /*bRemove=*/false);
+    }
+}
+
+bool UThermoForgeSubsystem::CanAddBlocker(const TCHAR* Caller) const
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (S && S->bDeterministicSimulation)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] %s: blockers are re-traced with physics queries, which bDeterministicSimulation can't reproduce; ignored."), Caller);
+        return false;
+    }
+    return true;
+}
+
+TSharedPtr<const FThermoPermOverrideLayer> UThermoForgeSubsystem::FindPermOverrides(const UThermoForgeFieldAsset* Field) const
+{
+    if (const TSharedPtr<FThermoPermOverrideLayer>* Layer = Field ? PermOverrides.Find(Field) : nullptr)
+    {
+        return *Layer;
+    }
+    return nullptr;
+}
+
+float UThermoForgeSubsystem::GetWallPermAt(const UThermoForgeFieldAsset* Field, int32 Linear) const
+{
+    if (!Field) return 1.f;
+    const float Baked = Field->GetWallPermByLinearIdx(Linear);
+    const TSharedPtr<FThermoPermOverrideLayer>* Layer = PermOverrides.Num() > 0 ? PermOverrides.Find(Field) : nullptr;
+    return Layer ? (*Layer)->GetWallPerm(Linear, Baked) : Baked;
+}
+
+void UThermoForgeSubsystem::ApplyBlocker(FThermoDynamicBlocker& Blocker, bool bRemove)
+{
+    const float From = Blocker.bApplied ? Blocker.AppliedOpen01 : 0.f;
+    const float To   = bRemove ? 0.f : Blocker.Open01;
+    if (bRemove && !Blocker.bApplied) return;
+    if (!bRemove && Blocker.bApplied && From == To) return;
+
+    const bool bAdding = !Blocker.bApplied;
+    Blocker.AppliedOpen01 = To;
+    Blocker.bApplied      = !bRemove;
+
+    struct FTouched { FIntVector Min = FIntVector(MAX_int32); FIntVector Max = FIntVector(MIN_int32); };
+    TMap<const UThermoForgeFieldAsset*, FTouched> Touched;
+    float MaxCell = 0.f;
+
+    for (const FThermoBlockerCell& C : Blocker.Cells)
+    {
+        const UThermoForgeFieldAsset* F = C.Field.Get();
+        if (!F || !F->WallPermeability01.IsValidIndex(C.LinearIndex)) continue;
+
+        TSharedPtr<FThermoPermOverrideLayer>* Layer = PermOverrides.Find(F);
+        if (!Layer && bAdding) Layer = &PermOverrides.Add(F, MakeShared<FThermoPermOverrideLayer>());
+        if (!Layer) continue; // dropped by a field patch
+
+        TMap<int32, FThermoPermOverrideCell>& Cells = (*Layer)->Cells;
+        FThermoPermOverrideCell* O = Cells.Find(C.LinearIndex);
+        if (!O && bAdding)
+        {
+            O = &Cells.Add(C.LinearIndex);
+            O->BakedPerm01 = F->WallPermeability01[C.LinearIndex];
+        }
+        if (!O) continue;
+
+        if (bAdding) ++O->NumBlockers;
+        O->Delta += (To - From) * (C.OpenPerm01 - O->BakedPerm01);
+        if (bRemove && --O->NumBlockers <= 0) Cells.Remove(C.LinearIndex);
+
+        FTouched& T = Touched.FindOrAdd(F);
+        T.Min = FIntVector(FMath::Min(T.Min.X, C.Cell.X), FMath::Min(T.Min.Y, C.Cell.Y), FMath::Min(T.Min.Z, C.Cell.Z));
+        T.Max = FIntVector(FMath::Max(T.Max.X, C.Cell.X), FMath::Max(T.Max.Y, C.Cell.Y), FMath::Max(T.Max.Z, C.Cell.Z));
+        MaxCell = FMath::Max(MaxCell, C.CellSizeCm);
+    }
+    for (auto It = PermOverrides.CreateIterator(); It; ++It)
+    {
+        if (!It->Key.IsValid() || It->Value->Cells.Num() == 0) It.RemoveCurrent();
+    }
+    if (Touched.Num() == 0) return;
+
+    // Composed sources: the cells' own WallPerm, plus occlusion of every source whose footprint reaches the blocker
+    const FBox Reach = Blocker.BoundsWS.ExpandBy(MaxCell);
+    TArray<FBox, TInlineAllocator<8>> Dirty;
+    Dirty.Add(Reach);
+    for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
+    {
+        const UThermoForgeSourceComponent* Src = W.Get();
+        if (Src && Src->bEnabled && Src->GetBoundsWS().Intersect(Reach)) Dirty.Add(Src->GetBoundsWS());
+    }
+    for (TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>>& G : ComposedGrids)
+    {
+        G.Value->SetPermOverrides(FindPermOverrides(G.Value->GetField()));
+        for (const FBox& Box : Dirty) G.Value->MarkWorldBoxDirty(Box);
+    }
+
+    // Diffusion faces of the touched fields only; fixed grids re-quantise and snapshots re-copy next tick
+    for (TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeDiffusionGrid>>& D : DiffusionGrids)
+    {
+        const UThermoForgeFieldAsset* F = D.Value->GetField();
+        if (const FTouched* T = Touched.Find(F))
+        {
+            D.Value->SetPermOverrides(FindPermOverrides(F));
+            D.Value->RefreshConductance(F, T->Min, T->Max);
+        }
+    }
+    for (auto It = FixedGrids.CreateIterator(); It; ++It)
+    {
+        if (Touched.Contains(It->Value->GetField())) It.RemoveCurrent();
+    }
+    for (TPair<TWeakObjectPtr<AThermoForgeVolume>, FSnapshotVolumeCache>& C : SnapshotCache)
+    {
+        if (Touched.Contains(C.Value.FieldAsset.Get())) C.Value.Field.Reset();
+    }
+}
+
+// ---- field patches ----
+void UThermoForgeSubsystem::HandleFieldPatched(UThermoForgeFieldAsset* Field)
+{
+    UWorld* W = GetWorld();
+    if (!W || !Field) return;
+
+    // Overrides were made against the old bake: drop them and re-trace the blockers that touch this field
+    if (PermOverrides.Remove(Field) > 0)
+    {
+        for (TPair<int32, FThermoDynamicBlocker>& B : Blockers)
+        {
+            if (!B.Value.Cells.ContainsByPredicate([Field](const FThermoBlockerCell& C){ return C.Field.Get() == Field; })) continue;
+            if (B.Value.bApplied) ApplyBlocker(B.Value, /*bRemove=*/true);
+            RasteriseBlocker(B.Value);
+        }
+    }
+
+    for (TActorIterator<AThermoForgeVolume> It(W); It; ++It)
+    {
+        AThermoForgeVolume* V = *It;
+        if (!V || V->BakedField != Field) continue;
+
+        // The bake path rebuilds its own volume's preview
+        if (V != BakeVolume.Get())
+        {
+            V->BuildHeatPreviewFromField();
+        }
+        if (const TSharedPtr<FThermoForgeComposedGrid>* Grid = ComposedGrids.Find(V))
+        {
+            (*Grid)->SetPermOverrides(nullptr);
+            (*Grid)->Init(Field);
+        }
+        if (const TSharedPtr<FThermoForgeDiffusionGrid>* Diff = DiffusionGrids.Find(V))
+        {
+            (*Diff)->SetPermOverrides(nullptr);
+            (*Diff)->RefreshConductance(Field);
+        }
+        InertiaGrids.Remove(V); // rates follow Indoorness01; reseeded next tick
+        FixedGrids.Remove(V);   // re-quantised and snapped next tick
+        Clipmaps.Remove(V);     // cells sampled from the old bake; refilled next tick
+        SnapshotCache.Remove(V);
+        OnFieldPatched.Broadcast(V);
+    }
+}
+
+bool UThermoForgeSubsystem::ApplyFieldPatchFromFile(const FString& Filename)
+{
+    FThermoForgeFieldPatch Patch;
+    if (!Patch.LoadFromFile(Filename))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Could not read field patch %s"), *Filename);
+        return false;
+    }
+
+    UThermoForgeFieldAsset* Field = FindObject<UThermoForgeFieldAsset>(nullptr, *Patch.TargetAsset);
+    if (!Field)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Patch target %s is not loaded"), *Patch.TargetAsset);
+        return false;
+    }
+
+    const bool bOk = Field->ApplyPatch(Patch);
+    UE_LOG(LogTemp, Log, TEXT("[ThermoForge] Patch %s -> %s : %d tiles, %lld cells %s"),
+           *Filename, *Patch.TargetAsset, Patch.Tiles.Num(), Patch.NumCells(), bOk ? TEXT("applied") : TEXT("REJECTED"));
+    return bOk;
+}
+
 void UThermoForgeSubsystem::RegisterSource(UThermoForgeSourceComponent* Source)
 {
     if (!IsValid(Source)) return;
@@ -55,8 +598,19 @@ void UThermoForgeSubsystem::UnregisterSource(UThermoForgeSourceComponent* Source
     OnSourcesChanged.Broadcast();
 }
 
-void UThermoForgeSubsystem::MarkSourceDirty(UThermoForgeSourceComponent* /*Source*/)
+void UThermoForgeSubsystem::MarkSourceDirty(UThermoForgeSourceComponent* Source)
 {
+    if (Source)
+    {
+        // Old and new footprint; the next tick refreshes the stamp
+        const FBox NewBounds = Source->GetBoundsWS();
+        const FSourceStamp* Stamp = SourceStamps.Find(Source);
+        for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>>& It : ComposedGrids)
+        {
+            if (Stamp) It.Value->MarkWorldBoxDirty(Stamp->BoundsWS);
+            It.Value->MarkWorldBoxDirty(NewBounds);
+        }
+    }
     OnSourcesChanged.Broadcast();
 }
 
@@ -162,6 +716,7 @@ void UThermoForgeSubsystem::StartNextBake()
     BakeSky.SetNumZeroed(N);
     BakeWall.SetNumZeroed(N);
     BakeIndoor.SetNumZeroed(N);
+    BakeSunSH.SetNumZeroed(N);
 
     GetWorld()->GetTimerManager().SetTimer(BakeTimerHandle, this,
         &UThermoForgeSubsystem::TickBake, 0.01f, true);
@@ -236,17 +791,12 @@ void UThermoForgeSubsystem::UpdateThermalProbesAndUpload(const FVector& CenterWS
         ProbePixels.SetNum(NumProbes);
     }
 
-    // For Default expose these if you want control over it in blueprints or gameplay
-    const bool  bWinter     = false;
-    const float TimeHours   = 12.f;         // “reference” time
-    const float WeatherAlfa = 0.2f;         // clearer = lower alpha
-
     for (int32 i=0; i<NumProbes; ++i)
     {
         const FVector P = CenterWS + ProbeOffsetsLS[i];
 
-        // Use your existing runtime composition (includes ambient + solar + sources + occlusion):
-        const float TempC = ComputeCurrentTemperatureAt(P, bWinter, TimeHours, WeatherAlfa);
+        // Runtime composition (ambient + solar + sources + occlusion) at the climate clock's instant
+        const float TempC = ComputeTemperatureNow(P);
 
         // Pack as RGBA16F = (RelX, RelY, RelZ, TempC)
         const FVector Rel = ProbeOffsetsLS[i]; // already relative to CenterWS
@@ -350,6 +900,11 @@ float UThermoForgeSubsystem::TraceAmbientRay01(const FVector& P, const FVector&
 }
 
 float UThermoForgeSubsystem::OcclusionBetween(const FVector& A, const FVector& B, float CellSizeCm) const
+{
+    return OcclusionBetweenIgnoring(A, B, CellSizeCm, nullptr);
+}
+
+float UThermoForgeSubsystem::OcclusionBetweenIgnoring(const FVector& A, const FVector& B, float CellSizeCm, const UPrimitiveComponent* Ignore) const
 {
     const UWorld* W = GetWorld();
     const UThermoForgeProjectSettings* S = GetSettings();
@@ -358,6 +913,7 @@ float UThermoForgeSubsystem::OcclusionBetween(const FVector& A, const FVector& B
     FHitResult Hit;
     FCollisionQueryParams Q(SCENE_QUERY_STAT(ThermoSource), S->bTraceComplex);
     Q.bReturnPhysicalMaterial = true;
+    if (Ignore) Q.AddIgnoredComponent(Ignore);
 
     const bool bHit = W->LineTraceSingleByChannel(
         Hit, A, B,
@@ -374,6 +930,41 @@ float UThermoForgeSubsystem::OcclusionBetween(const FVector& A, const FVector& B
     return S->DensityToPermeability(rho, Lfrac);
 }
 
+// Sky openness directions shared by the bake and runtime cells
+static void TF_BuildHemiDirs(TArray<FVector>& Out)
+{
+    const FVector base[12] = {
+        { 0, 0, 1}, { 0.5, 0, 0.866f}, {-0.5, 0, 0.866f}, {0, 0.5, 0.866f}, {0, -0.5, 0.866f},
+        { 0.707f, 0.707f, 0}, {-0.707f, 0.707f, 0}, {0.707f,-0.707f, 0}, {-0.707f,-0.707f, 0},
+        { 0.923f, 0, 0.382f}, {-0.923f, 0, 0.382f}, {0, 0.923f, 0.382f}
+    };
+    Out.Reset();
+    Out.Append(base, UE_ARRAY_COUNT(base));
+    for (FVector& d : Out) d.Normalize();
+}
+
+// Least-squares L1 fit over the hemisphere rays: SH = Σ open_i · Fit_i with Fit_i = (XᵀX)⁻¹ (d_i, 1)
+static void TF_BuildSunVisibilityFit(const TArray<FVector>& Dirs, TArray<FVector4f>& Out)
+{
+    FMatrix XtX(ForceInit);
+    for (const FVector& d : Dirs)
+    {
+        const double b[4] = { d.X, d.Y, d.Z, 1.0 };
+        for (int32 r=0; r<4; ++r)
+        for (int32 c=0; c<4; ++c) XtX.M[r][c] += b[r] * b[c];
+    }
+    const FMatrix Inv = XtX.Inverse();
+
+    Out.Reset(Dirs.Num());
+    for (const FVector& d : Dirs)
+    {
+        const double b[4] = { d.X, d.Y, d.Z, 1.0 };
+        double f[4];
+        for (int32 r=0; r<4; ++r) f[r] = Inv.M[r][0] * b[0] + Inv.M[r][1] * b[1] + Inv.M[r][2] * b[2] + Inv.M[r][3] * b[3];
+        Out.Add(FVector4f(float(f[0]), float(f[1]), float(f[2]), float(f[3])));
+    }
+}
+
 // ---- main bake start: collect volumes and que first ----
 // Per volume creates a que, then starts process per volume and tickbake() to calculate actual cell grid.
 void UThermoForgeSubsystem::KickstartSamplingFromVolumes()
@@ -383,16 +974,8 @@ void UThermoForgeSubsystem::KickstartSamplingFromVolumes()
     if (!W || !S) return;
 
     // hemisphere dirs
-    BakeHemiDirs.Reset();
-    {
-        const FVector base[12] = {
-            { 0, 0, 1}, { 0.5, 0, 0.866f}, {-0.5, 0, 0.866f}, {0, 0.5, 0.866f}, {0, -0.5, 0.866f},
-            { 0.707f, 0.707f, 0}, {-0.707f, 0.707f, 0}, {0.707f,-0.707f, 0}, {-0.707f,-0.707f, 0},
-            { 0.923f, 0, 0.382f}, {-0.923f, 0, 0.382f}, {0, 0.923f, 0.382f}
-        };
-        BakeHemiDirs.Append(base, UE_ARRAY_COUNT(base));
-        for (FVector& d : BakeHemiDirs) d.Normalize();
-    }
+    TF_BuildHemiDirs(BakeHemiDirs);
+    TF_BuildSunVisibilityFit(BakeHemiDirs, BakeSunFit);
 
     // collect all volumes
     BakeQueue.Empty();
@@ -467,11 +1050,46 @@ bool UThermoForgeSubsystem::ComputeNearestInVolume(const AThermoForgeVolume* Vol
 
 
 FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPoint(const FVector& WorldLocation, const FDateTime& QueryTimeUTC) const
+{
+    FThermoForgeGridHit Best;
+    if (!FindNearestCellPreferContaining(WorldLocation, Best)) return Best;
+
+    // Same climate model as the clock, evaluated at the requested instant
+    const FThermoClimateState C = MakeClimateState(QueryTimeUTC);
+    Best.QueryTimeUTC = QueryTimeUTC;
+    Best.CurrentTempC = ComposeTemperatureAtHit(Best, Best.CellCenterWS, C.AmbientAtZ(Best.CellCenterWS.Z), C.WeatherAlpha01, C.SunDirWS)
+                      + WeatherOffsetAtHit(Best.CellCenterWS, Best);
+    return Best;
+}
+
+FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPointNow(const FVector& WorldLocation) const
+{
+    FThermoForgeGridHit Best;
+    if (!FindNearestCellPreferContaining(WorldLocation, Best)) return Best;
+
+    const FThermoClimateState& C = ClimateState;
+    Best.QueryTimeUTC = C.TimeUTC;
+    Best.CurrentTempC = ComposeTemperatureAtHit(Best, Best.CellCenterWS, C.AmbientAtZ(Best.CellCenterWS.Z), C.WeatherAlpha01, C.SunDirWS)
+                      + WeatherOffsetAtHit(Best.CellCenterWS, Best);
+    return Best;
+}
+
+bool UThermoForgeSubsystem::FindNearestCellPreferContaining(const FVector& WorldLocation, FThermoForgeGridHit& OutHit) const
 {
     FThermoForgeGridHit Best;
 
     UWorld* World = GetWorld();
-    if (!World) return Best;
+    if (!World) { OutHit = Best; return false; }
+
+    // Finest containing volume; coarser ones it overlaps are not consulted
+    if (VolumeIndex.Num() > 0)
+    {
+        for (int32 n = VolumeIndex.NextContaining(WorldLocation); n != INDEX_NONE; n = VolumeIndex.NextContaining(WorldLocation, n))
+        {
+            if (ComputeNearestInVolume(VolumeIndex[n].Volume.Get(), WorldLocation, OutHit)) return true;
+        }
+        return FindNearestCell(WorldLocation, OutHit);
+    }
 
     bool FoundInContaining = false;
 
@@ -486,7 +1104,6 @@ FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPoint(const FVec
         FThermoForgeGridHit Hit;
         if (ComputeNearestInVolume(Vol, WorldLocation, Hit))
         {
-            Hit.QueryTimeUTC = QueryTimeUTC;
             if (!FoundInContaining || Hit.DistanceSq < Best.DistanceSq)
             {
                 Best = Hit;
@@ -497,155 +1114,1472 @@ FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPoint(const FVec
 
     if (!FoundInContaining)
     {
-        for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
-        {
-            const AThermoForgeVolume* Vol = *It;
-            if (!Vol || !Vol->BakedField) continue;
-
-            FThermoForgeGridHit Hit;
-            if (ComputeNearestInVolume(Vol, WorldLocation, Hit))
-            {
-                Hit.QueryTimeUTC = QueryTimeUTC;
-                if (!Best.bFound || Hit.DistanceSq < Best.DistanceSq)
-                {
-                    Best = Hit;
-                }
-            }
-        }
+        FindNearestCell(WorldLocation, Best);
     }
 
-   // Fill composed temperature (derived from QueryTimeUTC) with post-process ambient fix
-if (Best.bFound)
-{
-    const UThermoForgeProjectSettings* S = GetSettings();
-
-    // Weather alpha: keep using the preview knob @To do - Live Preview Time Taps here
-    const float WeatherAlfa = S ? S->PreviewWeatherAlpha : 0.3f;
+    OutHit = Best;
+    return Best.bFound;
+}
 
-    // --- Time of day from UTC (continuous hours) ---
-    const double SecUTC   = Best.QueryTimeUTC.GetTimeOfDay().GetTotalSeconds();
-    auto Wrap24 = [](float h){ float r = FMath::Fmod(h, 24.f); return (r < 0.f) ? r + 24.f : r; };
-    const float TimeHours = ([](float h){ float r = FMath::Fmod(h, 24.f); return (r < 0.f) ? r + 24.f : r; })
-                            (static_cast<float>(SecUTC / 3600.0f));
+// --------- Runtime composition ---------
+bool UThermoForgeSubsystem::FindNearestCell(const FVector& WorldPos, FThermoForgeGridHit& OutHit) const
+{
+    UWorld* World = GetWorld();
+    if (!World) return false;
+
+    FThermoForgeGridHit Best;
+    for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
+    {
+        const AThermoForgeVolume* Vol = *It;
+        if (!Vol || !Vol->BakedField) continue;
+
+        FThermoForgeGridHit Hit;
+        if (!ComputeNearestInVolume(Vol, WorldPos, Hit)) continue;
+
+        if (!Best.bFound || Hit.DistanceSq < Best.DistanceSq)
+            Best = Hit;
+    }
+
+    OutHit = Best;
+    return Best.bFound;
+}
+
+float UThermoForgeSubsystem::ComposeTemperatureAtHit(const FThermoForgeGridHit& Hit, const FVector& WorldPos, float AmbientC, float WeatherAlpha01, const FVector& SunDirWS) const
+{
+    // Baked scalars at the resolved cell (open sky / fully permeable when nothing was found)
+    float Sky = 0.f;
+    float WallPerm = 1.f;
+    if (Hit.bFound && Hit.Volume && Hit.Volume->BakedField)
+    {
+        Sky      = Hit.Volume->BakedField->GetSolarViewByLinearIdx(Hit.LinearIndex, SunDirWS);
+        WallPerm = FMath::Clamp(GetWallPermAt(Hit.Volume->BakedField, Hit.LinearIndex), 0.f, 1.f);
+    }
+    return ComposeTemperatureFromChannels(WorldPos, AmbientC, WeatherAlpha01, Sky, WallPerm);
+}
+
+float UThermoForgeSubsystem::ComposeTemperatureFromChannels(const FVector& WorldPos, float AmbientC, float WeatherAlpha01, float Sky, float WallPerm) const
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S) return AmbientC;
+
+    // Solar gain (reduced by weather)
+    const float Solar = S->SolarGainScaleC * Sky * (1.f - FMath::Clamp(WeatherAlpha01, 0.f, 1.f));
+
+    // Dynamic sources (attenuated by LOS * local wall permeability)
+    float SourceSum = 0.f;
+    {
+        for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
+        {
+            const UThermoForgeSourceComponent* Sc = W.Get();
+            if (!Sc || !Sc->bEnabled) continue;
+
+            const float Intensity = Sc->SampleAt(WorldPos); // °C delta
+            if (Intensity == 0.f) continue;
+
+            const float CellSize = S->DefaultCellSizeCm;
+            const float Occ = OcclusionBetween(WorldPos, Sc->GetOwnerLocationSafe(), CellSize);
+            // WallPerm scales local transmissivity
+            SourceSum += Intensity * Occ * WallPerm;
+        }
+    }
+
+    return AmbientC + Solar + SourceSum;
+}
+
+float UThermoForgeSubsystem::ComputeCurrentTemperatureAt(const FVector& WorldPos, bool bWinter, float TimeHours, float WeatherAlpha01) const
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S) return 0.f;
+
+    // Ambient + altitude
+    const float AmbientC = S->GetAmbientCelsiusAt(bWinter, TimeHours, WorldPos.Z);
+    return ComposeNestedAt(WorldPos, AmbientC, WeatherAlpha01, TF_SunDirFor(S, bWinter ? 0.f : 1.f, TimeHours));
+}
+
+float UThermoForgeSubsystem::ComposeNestedAt(const FVector& WorldPos, float AmbientC, float WeatherAlpha01, const FVector& SunDirWS) const
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S) return AmbientC;
+
+    auto SampleNode = [&](const FThermoVolumeNode& N, float& OutC)
+    {
+        const AThermoForgeVolume* Vol = N.Volume.Get();
+        if (!Vol || !Vol->BakedField) return false;
+
+        float SourceC = 0.f, Sky = 0.f;
+        const TSharedPtr<FThermoForgeComposedGrid>* Grid = ComposedGrids.Find(N.Volume);
+        if (Grid && (*Grid)->GetField() == Vol->BakedField && (*Grid)->SampleSourceAndSky(WorldPos, SunDirWS, SourceC, Sky))
+        {
+            OutC = AmbientC + S->SolarGainScaleC * Sky * (1.f - FMath::Clamp(WeatherAlpha01, 0.f, 1.f)) + SourceC;
+            return true;
+        }
+
+        FThermoForgeGridHit Hit;
+        if (!ComputeNearestInVolume(Vol, WorldPos, Hit)) return false;
+        OutC = ComposeTemperatureAtHit(Hit, WorldPos, AmbientC, WeatherAlpha01, SunDirWS);
+        return true;
+    };
+
+    float NestedC = 0.f;
+    if (VolumeIndex.Blend(WorldPos, SampleNode, NestedC)) return NestedC;
+
+    FThermoForgeGridHit Best;
+    FindNearestCell(WorldPos, Best);
+    return ComposeTemperatureAtHit(Best, WorldPos, AmbientC, WeatherAlpha01, SunDirWS);
+}
+
+bool UThermoForgeSubsystem::SampleVolumeNow(const AThermoForgeVolume* Vol, const FVector& WorldPos, float& OutTempC) const
+{
+    return SampleRuntimeTemp(Vol, WorldPos, OutTempC) || ComposeBakedNow(Vol, WorldPos, OutTempC);
+}
+
+bool UThermoForgeSubsystem::ComposeBakedNow(const AThermoForgeVolume* Vol, const FVector& WorldPos, float& OutTempC) const
+{
+    FThermoForgeGridHit Hit;
+    if (Vol)
+    {
+        if (!ComputeNearestInVolume(Vol, WorldPos, Hit)) return false;
+    }
+    else
+    {
+        FindNearestCell(WorldPos, Hit); // open sky when nothing is baked
+    }
+
+    const FThermoClimateState& C = ClimateState;
+    OutTempC = ComposeTemperatureAtHit(Hit, WorldPos, C.AmbientAtZ(WorldPos.Z), C.WeatherAlpha01, C.SunDirWS);
+    return true;
+}
+
+float UThermoForgeSubsystem::SampleTemperatureNow(const FVector& WorldPos, FComposeBakedFn ComposeBaked) const
+{
+    // Regional weather rides on top of whatever the grids composed under the global climate
+    const float WeatherC = WeatherOffsetAt(WorldPos);
+
+    // Finest containing volume, faded into its parents across their border bands
+    float NestedC = 0.f;
+    if (VolumeIndex.Blend(WorldPos, [&](const FThermoVolumeNode& N, float& OutC)
+        {
+            const AThermoForgeVolume* Vol = N.Volume.Get();
+            return SampleRuntimeTemp(Vol, WorldPos, OutC) || ComposeBaked(Vol, WorldPos, OutC);
+        }, NestedC))
+    {
+        return NestedC + WeatherC;
+    }
+
+    float ClipC = 0.f;
+    if (SampleClipmapTemp(WorldPos, ClipC)) return ClipC + WeatherC;
+
+    float BakedC = 0.f;
+    ComposeBaked(nullptr, WorldPos, BakedC);
+    return BakedC + WeatherC;
+}
+
+float UThermoForgeSubsystem::ComputeTemperatureNow(const FVector& WorldPos) const
+{
+    return SampleTemperatureNow(WorldPos, [this](const AThermoForgeVolume* Vol, const FVector& P, float& OutC)
+    {
+        return ComposeBakedNow(Vol, P, OutC);
+    });
+}
+
+// ---- query cursor ----
+bool UThermoForgeSubsystem::ResolveQueryCursor(FThermoQueryCursor& Cursor, const FVector& WorldPos, FThermoForgeGridHit& OutHit) const
+{
+    OutHit = FThermoForgeGridHit();
+
+    AThermoForgeVolume* Vol = Cursor.Volume.Get();
+    if (Vol && Cursor.Revision == VolumeSetRevision && Vol->BakedField)
+    {
+        // Same box, same or neighbouring cell: reuse the cached frame
+        const FVector L = Cursor.InvActor.TransformPosition(WorldPos);
+        const bool bInside = Cursor.bUnbounded
+            || (FMath::Abs(L.X) <= Cursor.BoxExtent.X && FMath::Abs(L.Y) <= Cursor.BoxExtent.Y && FMath::Abs(L.Z) <= Cursor.BoxExtent.Z);
+
+        const float Cell = Cursor.CellSizeCm;
+        const FVector LocalGrid = Cursor.InvFrame.TransformPosition(WorldPos) / Cell;
+        const FIntVector Idx(
+            FMath::Clamp(FMath::FloorToInt(LocalGrid.X + 0.5f), 0, Cursor.Dim.X - 1),
+            FMath::Clamp(FMath::FloorToInt(LocalGrid.Y + 0.5f), 0, Cursor.Dim.Y - 1),
+            FMath::Clamp(FMath::FloorToInt(LocalGrid.Z + 0.5f), 0, Cursor.Dim.Z - 1));
+        const FIntVector Step = Idx - Cursor.Cell;
+
+        // A finer volume nested inside the cached one takes over
+        const bool bFinest = Cursor.Node == INDEX_NONE || VolumeIndex.NextContaining(WorldPos) == Cursor.Node;
+
+        if (bInside && bFinest && FMath::Abs(Step.X) <= 1 && FMath::Abs(Step.Y) <= 1 && FMath::Abs(Step.Z) <= 1)
+        {
+            if (Step != FIntVector::ZeroValue)
+            {
+                Cursor.Cell         = Idx;
+                Cursor.LinearIndex  = Idx.X + Idx.Y * Cursor.Dim.X + Idx.Z * Cursor.Dim.X * Cursor.Dim.Y;
+                Cursor.CellCenterWS = Cursor.Frame.TransformPosition(FVector((Idx.X + 0.5f) * Cell, (Idx.Y + 0.5f) * Cell, (Idx.Z + 0.5f) * Cell));
+            }
+            ++Cursor.NumFastHits;
+
+            OutHit.bFound       = true;
+            OutHit.Volume       = Vol;
+            OutHit.GridIndex    = Cursor.Cell;
+            OutHit.LinearIndex  = Cursor.LinearIndex;
+            OutHit.CellCenterWS = Cursor.CellCenterWS;
+            OutHit.DistanceSq   = FVector::DistSquared(Cursor.CellCenterWS, WorldPos);
+            OutHit.CellSizeCm   = Cell;
+            return true;
+        }
+    }
+
+    // Full lookup; only answers from a containing volume are worth caching
+    ++Cursor.NumFullLookups;
+    const int32 FastHits = Cursor.NumFastHits, FullLookups = Cursor.NumFullLookups;
+    Cursor.Reset();
+    Cursor.NumFastHits    = FastHits;
+    Cursor.NumFullLookups = FullLookups;
+
+    if (!FindNearestCellPreferContaining(WorldPos, OutHit)) return false;
+
+    AThermoForgeVolume* HitVol = OutHit.Volume;
+    if (HitVol && HitVol->BakedField && VolumeContainsPoint(HitVol, WorldPos))
+    {
+        const UThermoForgeFieldAsset* Field = HitVol->BakedField;
+        Cursor.Revision     = VolumeSetRevision;
+        Cursor.Volume       = HitVol;
+        Cursor.Node         = VolumeIndex.Find(HitVol);
+        Cursor.Frame        = Field->GetGridFrame();
+        Cursor.InvFrame     = Cursor.Frame.Inverse();
+        Cursor.Dim          = Field->Dim;
+        Cursor.CellSizeCm   = Field->CellSizeCm;
+        Cursor.InvActor     = HitVol->GetActorTransform().Inverse();
+        Cursor.BoxExtent    = HitVol->BoxExtent;
+        Cursor.bUnbounded   = HitVol->bUnbounded;
+        Cursor.Cell         = OutHit.GridIndex;
+        Cursor.LinearIndex  = OutHit.LinearIndex;
+        Cursor.CellCenterWS = OutHit.CellCenterWS;
+    }
+    return true;
+}
+
+float UThermoForgeSubsystem::ComputeTemperatureNow(const FVector& WorldPos, FThermoQueryCursor& Cursor) const
+{
+    FThermoForgeGridHit Hit;
+    ResolveQueryCursor(Cursor, WorldPos, Hit);
+    const float WeatherC = WeatherOffsetAtHit(WorldPos, Hit);
+
+    // The cursor only holds containing volumes, which is where the runtime grids apply; its cell serves the
+    // cached volume, parents are sampled only inside its border band
+    const FThermoClimateState& C = ClimateState;
+    float CachedC = 0.f;
+    if (Cursor.Node != INDEX_NONE && VolumeIndex.Blend(WorldPos, [&](const FThermoVolumeNode& N, float& OutC)
+        {
+            if (N.Volume != Cursor.Volume) return SampleVolumeNow(N.Volume.Get(), WorldPos, OutC);
+            if (!SampleRuntimeTemp(Cursor.Volume.Get(), WorldPos, OutC))
+            {
+                OutC = ComposeTemperatureAtHit(Hit, WorldPos, C.AmbientAtZ(WorldPos.Z), C.WeatherAlpha01, C.SunDirWS);
+            }
+            return true;
+        }, CachedC, Cursor.Node))
+    {
+        return CachedC + WeatherC;
+    }
+    if (SampleRuntimeTemp(Cursor.Volume.Get(), WorldPos, CachedC)) return CachedC + WeatherC;
+    if (SampleClipmapTemp(WorldPos, CachedC)) return CachedC + WeatherC;
+
+    return ComposeTemperatureAtHit(Hit, WorldPos, C.AmbientAtZ(WorldPos.Z), C.WeatherAlpha01, C.SunDirWS) + WeatherC;
+}
+
+FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPointNow(const FVector& WorldLocation, FThermoQueryCursor& Cursor) const
+{
+    FThermoForgeGridHit Best;
+    if (!ResolveQueryCursor(Cursor, WorldLocation, Best)) return Best;
+
+    const FThermoClimateState& C = ClimateState;
+    Best.QueryTimeUTC = C.TimeUTC;
+    Best.CurrentTempC = ComposeTemperatureAtHit(Best, Best.CellCenterWS, C.AmbientAtZ(Best.CellCenterWS.Z), C.WeatherAlpha01, C.SunDirWS)
+                      + WeatherOffsetAtHit(Best.CellCenterWS, Best);
+    return Best;
+}
+
+float UThermoForgeSubsystem::ComputeTemperatureAtSeason(const FVector& WorldPos, float SeasonAlpha01, float TimeHours, float WeatherAlpha01) const
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S) return 0.f;
+
+    const float AmbientC = S->GetAmbientCelsiusAtSeason(SeasonAlpha01, TimeHours, WorldPos.Z);
+    return ComposeNestedAt(WorldPos, AmbientC, WeatherAlpha01, TF_SunDirFor(S, SeasonAlpha01, TimeHours));
+}
+
+static bool TF_SampleSkyWithGradient(const UThermoForgeFieldAsset* Field, const FVector& WorldPos, const FVector& SunDirWS, float& OutSky, FVector& OutGrad)
+{
+    const FTransform Frame = Field->GetGridFrame();
+    FIntVector Cells[8]; float W[8]; FVector DW[8];
+    if (!FThermoForgeComposedGrid::TrilinearCells(Frame.InverseTransformPosition(WorldPos), Field->CellSizeCm, Field->Dim, Cells, W, DW))
+        return false;
+
+    float Sky = 0.f;
+    FVector G = FVector::ZeroVector;
+    for (int32 k=0; k<8; ++k)
+    {
+        const float s = Field->GetSolarViewByLinearIdx(Field->Index(Cells[k].X, Cells[k].Y, Cells[k].Z), SunDirWS);
+        Sky += W[k] * s;
+        G   += DW[k] * s;
+    }
+    OutSky  = Sky;
+    OutGrad = Frame.TransformVectorNoScale(G);
+    return true;
+}
+
+bool UThermoForgeSubsystem::HasEvolvingTemp(const AThermoForgeVolume* Vol, const FVector& WorldPos) const
+{
+    if (!Vol)
+    {
+        float ClipC = 0.f;
+        return SampleClipmapTemp(WorldPos, ClipC);
+    }
+    const TWeakObjectPtr<AThermoForgeVolume> Key(const_cast<AThermoForgeVolume*>(Vol));
+    return Clipmaps.Contains(Key) || FixedGrids.Contains(Key) || DiffusionGrids.Contains(Key) || InertiaGrids.Contains(Key);
+}
+
+float UThermoForgeSubsystem::ComputeTemperatureGradientAt(const FVector& WorldPos, FVector& OutGradientCPerCm) const
+{
+    const FThermoClimateState& C = ClimateState;
+
+    // The volume ComputeTemperatureNow resolves first; the analytic terms hold only where it answers alone
+    const int32 Node = VolumeIndex.NextContaining(WorldPos);
+    const AThermoForgeVolume* Vol = Node != INDEX_NONE ? VolumeIndex[Node].Volume.Get() : nullptr;
+    const bool bBlended = Node != INDEX_NONE && VolumeIndex[Node].InnerWeight(WorldPos) < 1.f;
+
+    if (bBlended || HasEvolvingTemp(Vol, WorldPos))
+    {
+        const float Cell = (Vol && Vol->BakedField) ? Vol->BakedField->CellSizeCm : GetSettings()->DefaultCellSizeCm;
+        const float h = 0.5f * FMath::Max(1.f, Cell);
+        for (int32 i=0; i<3; ++i)
+        {
+            FVector d = FVector::ZeroVector;
+            d[i] = h;
+            OutGradientCPerCm[i] = (ComputeTemperatureNow(WorldPos + d) - ComputeTemperatureNow(WorldPos - d)) / (2.f * h);
+        }
+        return ComputeTemperatureNow(WorldPos);
+    }
+
+    // Ambient: linear in Z; the weather map varies over kilometres and is held constant here
+    float   T = C.AmbientAtZ(WorldPos.Z) + WeatherOffsetAt(WorldPos);
+    FVector G(0.f, 0.f, -C.LapseCPerCm);
+
+    float Sky = 0.f, SourceC = 0.f;
+    FVector SkyGrad = FVector::ZeroVector, SourceGrad = FVector::ZeroVector;
+
+    // Composed cells carry occlusion already
+    if (const TSharedPtr<FThermoForgeComposedGrid>* Grid = Vol ? ComposedGrids.Find(VolumeIndex[Node].Volume) : nullptr)
+    {
+        if ((*Grid)->GetField() == Vol->BakedField && (*Grid)->SampleWithGradient(WorldPos, C.SunDirWS, SourceC, SourceGrad, Sky, SkyGrad))
+        {
+            OutGradientCPerCm = G + C.SolarC * SkyGrad + SourceGrad;
+            return T + C.SolarC * Sky + SourceC;
+        }
+    }
+
+    // Baked channels of the containing volume (nearest cell outside all); occlusion per source held constant around WorldPos
+    FThermoForgeGridHit Hit;
+    float WallPerm = 1.f;
+    const bool bHit = Vol ? ComputeNearestInVolume(Vol, WorldPos, Hit) : FindNearestCell(WorldPos, Hit);
+    if (bHit && Hit.Volume && Hit.Volume->BakedField)
+    {
+        const UThermoForgeFieldAsset* Field = Hit.Volume->BakedField;
+        WallPerm = FMath::Clamp(GetWallPermAt(Field, Hit.LinearIndex), 0.f, 1.f);
+        if (!TF_SampleSkyWithGradient(Field, WorldPos, C.SunDirWS, Sky, SkyGrad))
+        {
+            Sky = Field->GetSolarViewByLinearIdx(Hit.LinearIndex, C.SunDirWS);
+        }
+    }
+
+    const float Cell = GetSettings()->DefaultCellSizeCm;
+    for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
+    {
+        const UThermoForgeSourceComponent* Sc = W.Get();
+        if (!Sc || !Sc->bEnabled) continue;
+
+        FVector g;
+        const float Intensity = Sc->GetShapeWS().SampleWithGradient(WorldPos, g);
+        if (Intensity == 0.f && g.IsZero()) continue;
+
+        const float k = OcclusionBetween(WorldPos, Sc->GetOwnerLocationSafe(), Cell) * WallPerm;
+        SourceC    += Intensity * k;
+        SourceGrad += g * k;
+    }
+
+    OutGradientCPerCm = G + C.SolarC * SkyGrad + SourceGrad;
+    return T + C.SolarC * Sky + SourceC;
+}
+
+// ---- path queries ----
+void UThermoForgeSubsystem::AccumulatePathSegment(const FVector& A, const FVector& B, double DistanceOffsetCm, FPathWalk& Walk, FThermoPathStats& Out) const
+{
+    const double Len = FVector::Distance(A, B);
+    if (Len <= KINDA_SMALL_NUMBER) return;
+    const FVector Dir = (B - A) / Len;
+    const FVector Mid = 0.5 * (A + B);
+    const FThermoClimateState& C = ClimateState;
+
+    // One volume per segment: the one holding its midpoint (or nearest)
+    FThermoForgeGridHit Seed;
+    FindNearestCellPreferContaining(Mid, Seed);
+    const AThermoForgeVolume* Vol = Seed.bFound ? Seed.Volume.Get() : nullptr;
+    const UThermoForgeFieldAsset* Field = Vol ? Vol->BakedField : nullptr;
+
+    // Sources whose bounds touch the segment; occlusion traced lazily, once per source
+    struct FSegSource { FThermoSourceShape Shape; FVector LocationWS; float Occ; };
+    TArray<FSegSource, TInlineAllocator<8>> Sources;
+    for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
+    {
+        const UThermoForgeSourceComponent* Sc = W.Get();
+        if (!Sc || !Sc->bEnabled) continue;
+
+        const FBox Bounds = Sc->GetBoundsWS();
+        if (!Bounds.IsInsideOrOn(A) && !FMath::LineBoxIntersection(Bounds, A, B, B - A)) continue;
+        Sources.Add({ Sc->GetShapeWS(), Sc->GetOwnerLocationSafe(), -1.f });
+    }
+
+    // Same resolver as ComputeTemperatureNow (blend, runtime grids, clipmaps, weather); only the baked
+    // composition of the segment's own volume is served from the walked cell and the per-segment occlusion
+    const float OccCell = GetSettings()->DefaultCellSizeCm;
+    auto Evaluate = [&](const FVector& P, int32 Linear) -> float
+    {
+        return SampleTemperatureNow(P, [&](const AThermoForgeVolume* V, const FVector& Q, float& OutC)
+        {
+            if (!Field || Linear < 0 || (V && V != Vol)) return ComposeBakedNow(V, Q, OutC);
+
+            const float Sky      = Field->GetSolarViewByLinearIdx(Linear, C.SunDirWS);
+            const float WallPerm = FMath::Clamp(GetWallPermAt(Field, Linear), 0.f, 1.f);
+
+            OutC = C.AmbientAtZ(Q.Z) + C.SolarC * Sky;
+            for (FSegSource& S : Sources)
+            {
+                const float Intensity = S.Shape.SampleAt(Q);
+                if (Intensity == 0.f) continue;
+                if (S.Occ < 0.f)
+                {
+                    const FVector Closest = FMath::ClosestPointOnSegment(S.LocationWS, A, B);
+                    S.Occ = OcclusionBetween(Closest, S.LocationWS, OccCell);
+                }
+                OutC += Intensity * S.Occ * WallPerm;
+            }
+            return true;
+        });
+    };
+
+    // One interval [t0,t1] (cm along this segment) sampled at its midpoint
+    auto Emit = [&](double t0, double t1, int32 Linear)
+    {
+        if (t1 <= t0) return;
+        const FVector P = A + Dir * (0.5 * (t0 + t1));
+        const float   T = Evaluate(P, Linear);
+        const double  DistMid = DistanceOffsetCm + 0.5 * (t0 + t1);
+
+        if (Out.NumSamples == 0 || T > Out.MaxC) { Out.MaxC = T; Out.MaxLocationWS = P; }
+        if (Out.NumSamples == 0 || T < Out.MinC) { Out.MinC = T; Out.MinLocationWS = P; }
+        Out.IntegralCcm += T * float(t1 - t0);
+        ++Out.NumSamples;
+
+        if (!Out.bCrossedThreshold && T >= Walk.ThresholdC)
+        {
+            Out.bCrossedThreshold = true;
+            if (Walk.bHasPrev && T > Walk.PrevT)
+            {
+                // Linear between the two interval midpoints
+                const float Alpha = FMath::Clamp((Walk.ThresholdC - Walk.PrevT) / (T - Walk.PrevT), 0.f, 1.f);
+                Out.FirstCrossingWS         = FMath::Lerp(Walk.PrevPos, P, Alpha);
+                Out.FirstCrossingDistanceCm = float(FMath::Lerp(Walk.PrevDistCm, DistMid, double(Alpha)));
+            }
+            else
+            {
+                Out.FirstCrossingWS         = A + Dir * t0;
+                Out.FirstCrossingDistanceCm = float(DistanceOffsetCm + t0);
+            }
+        }
+
+        Walk.bHasPrev   = true;
+        Walk.PrevT      = T;
+        Walk.PrevDistCm = DistMid;
+        Walk.PrevPos    = P;
+    };
+
+    auto NearestLinear = [&](const FVector& P) -> int32
+    {
+        FThermoForgeGridHit H;
+        return (Vol && ComputeNearestInVolume(Vol, P, H)) ? H.LinearIndex : -1;
+    };
+
+    if (!Field || Field->Dim.X <= 0 || Field->Dim.Y <= 0 || Field->Dim.Z <= 0)
+    {
+        Emit(0.0, Len, -1);
+        return;
+    }
+
+    // Grid-local, cell units; s in [0,1] along the segment
+    const FIntVector D = Field->Dim;
+    const double Cell = FMath::Max(1.f, Field->CellSizeCm);
+    const FTransform Frame = Field->GetGridFrame();
+    const FVector La = Frame.InverseTransformPosition(A) / Cell;
+    const FVector Ld = Frame.InverseTransformPosition(B) / Cell - La;
+
+    // Clip against the grid box [0, Dim]
+    double s0 = 0.0, s1 = 1.0;
+    for (int32 i=0; i<3 && s0 <= s1; ++i)
+    {
+        const double Hi = double(D[i]);
+        if (FMath::Abs(Ld[i]) < 1e-12)
+        {
+            if (La[i] < 0.0 || La[i] > Hi) s0 = 2.0; // parallel and outside
+            continue;
+        }
+        double e = (0.0 - La[i]) / Ld[i], x = (Hi - La[i]) / Ld[i];
+        if (e > x) Swap(e, x);
+        s0 = FMath::Max(s0, e);
+        s1 = FMath::Min(s1, x);
+    }
+
+    if (s0 >= s1)
+    {
+        Emit(0.0, Len, NearestLinear(Mid));
+        return;
+    }
+
+    // Outside stretches extend the nearest boundary cell
+    if (s0 > 0.0) Emit(0.0, s0 * Len, NearestLinear(A + Dir * (0.5 * s0 * Len)));
+
+    // 3D DDA (Amanatides–Woo)
+    const FVector P0 = La + Ld * s0;
+    FIntVector Cur(
+        FMath::Clamp(FMath::FloorToInt(P0.X), 0, D.X - 1),
+        FMath::Clamp(FMath::FloorToInt(P0.Y), 0, D.Y - 1),
+        FMath::Clamp(FMath::FloorToInt(P0.Z), 0, D.Z - 1));
+
+    int32  Step[3];
+    double SMax[3], SDelta[3];
+    for (int32 i=0; i<3; ++i)
+    {
+        if (FMath::Abs(Ld[i]) < 1e-12)
+        {
+            Step[i] = 0; SMax[i] = TNumericLimits<double>::Max(); SDelta[i] = 0.0;
+            continue;
+        }
+        Step[i]   = Ld[i] > 0.0 ? 1 : -1;
+        const double Boundary = double(Cur[i] + (Step[i] > 0 ? 1 : 0));
+        SMax[i]   = (Boundary - La[i]) / Ld[i];
+        SDelta[i] = 1.0 / FMath::Abs(Ld[i]);
+    }
+
+    double S = s0;
+    const int32 MaxSteps = D.X + D.Y + D.Z + 3;
+    for (int32 n=0; n<MaxSteps && S < s1; ++n)
+    {
+        const int32 Axis = (SMax[0] < SMax[1]) ? (SMax[0] < SMax[2] ? 0 : 2) : (SMax[1] < SMax[2] ? 1 : 2);
+        const double SNext = FMath::Min(SMax[Axis], s1);
+
+        Emit(S * Len, SNext * Len, Field->Index(Cur.X, Cur.Y, Cur.Z));
+        S = SNext;
+        if (S >= s1) break;
+
+        Cur[Axis] += Step[Axis];
+        if (Cur[Axis] < 0 || Cur[Axis] >= D[Axis]) break;
+        SMax[Axis] += SDelta[Axis];
+    }
+
+    if (s1 < 1.0) Emit(s1 * Len, Len, NearestLinear(B - Dir * (0.5 * (1.0 - s1) * Len)));
+}
+
+FThermoPathStats UThermoForgeSubsystem::QuerySegmentTemperature(const FVector& A, const FVector& B, float ThresholdC) const
+{
+    return QueryPathTemperature({ A, B }, ThresholdC);
+}
+
+FThermoPathStats UThermoForgeSubsystem::QueryPathTemperature(const TArray<FVector>& Points, float ThresholdC) const
+{
+    FThermoPathStats Out;
+    FPathWalk Walk;
+    Walk.ThresholdC = ThresholdC;
+
+    double Dist = 0.0;
+    for (int32 i=1; i<Points.Num(); ++i)
+    {
+        AccumulatePathSegment(Points[i-1], Points[i], Dist, Walk, Out);
+        Dist += FVector::Distance(Points[i-1], Points[i]);
+    }
+
+    Out.LengthCm = float(Dist);
+    Out.bValid   = Out.NumSamples > 0;
+    Out.MeanC    = (Out.bValid && Dist > 0.0) ? float(Out.IntegralCcm / Dist) : 0.f;
+    return Out;
+}
+
+// ---- composed cache ----
+static uint32 TF_HashSourceParams(const UThermoForgeSourceComponent* Src)
+{
+    uint32 H = GetTypeHash(Src->IntensityCelsius);
+    H = HashCombine(H, GetTypeHash(Src->RadiusCm));
+    H = HashCombine(H, GetTypeHash(Src->BoxExtent));
+    H = HashCombine(H, GetTypeHash(uint8(Src->Shape)));
+    H = HashCombine(H, GetTypeHash(uint8(Src->Falloff)));
+    H = HashCombine(H, GetTypeHash(Src->bAffectByOwnerScale));
+    return H;
+}
+
+bool UThermoForgeSubsystem::UseComposedGrids() const
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    const UWorld* World = GetWorld();
+    return S && S->bUseComposedGrid && World && World->IsGameWorld();
+}
+
+void UThermoForgeSubsystem::UpdateComposedGrids()
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    UWorld* World = GetWorld();
+    if (!UseComposedGrids())
+    {
+        ComposedGrids.Empty();
+        SourceStamps.Empty();
+        return;
+    }
+
+    // 1) One grid per baked volume
+    TSet<TWeakObjectPtr<AThermoForgeVolume>> Seen;
+    for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
+    {
+        AThermoForgeVolume* Vol = *It;
+        if (!Vol || !Vol->BakedField) continue;
+        Seen.Add(Vol);
+
+        TSharedPtr<FThermoForgeComposedGrid>& Grid = ComposedGrids.FindOrAdd(Vol);
+        if (!Grid.IsValid()) Grid = MakeShared<FThermoForgeComposedGrid>();
+        Grid->SetPermOverrides(FindPermOverrides(Vol->BakedField));
+        if (!Grid->IsValidFor(Vol->BakedField)) Grid->Init(Vol->BakedField);
+    }
+    for (auto It = ComposedGrids.CreateIterator(); It; ++It)
+    {
+        if (!Seen.Contains(It->Key)) It.RemoveCurrent();
+    }
+    if (ComposedGrids.Num() == 0)
+    {
+        SourceStamps.Empty();
+        return;
+    }
+
+    auto MarkAll = [this](const FBox& Box)
+    {
+        for (TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>>& G : ComposedGrids)
+            G.Value->MarkWorldBoxDirty(Box);
+    };
+
+    // 2) Diff sources against their stamps; a change dirties both the old and the new footprint
+    TArray<FThermoComposeSource> Sources;
+    Sources.Reserve(SourceSet.Num());
+    TSet<TWeakObjectPtr<UThermoForgeSourceComponent>> Live;
+
+    for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
+    {
+        const UThermoForgeSourceComponent* Src = W.Get();
+        if (!Src || !Src->bEnabled) continue;
+        Live.Add(W);
+
+        FSourceStamp Now;
+        Now.BoundsWS  = Src->GetBoundsWS();
+        Now.Transform = Src->GetOwnerTransformSafe();
+        Now.ParamHash = TF_HashSourceParams(Src);
+
+        FSourceStamp* Old = SourceStamps.Find(W);
+        if (!Old)
+        {
+            MarkAll(Now.BoundsWS);
+            SourceStamps.Add(W, Now);
+        }
+        else if (Old->ParamHash != Now.ParamHash || !Old->Transform.Equals(Now.Transform))
+        {
+            MarkAll(Old->BoundsWS);
+            MarkAll(Now.BoundsWS);
+            *Old = Now;
+        }
+
+        FThermoComposeSource& C = Sources.AddDefaulted_GetRef();
+        C.Source     = Src;
+        C.BoundsWS   = Now.BoundsWS;
+        C.LocationWS = Src->GetOwnerLocationSafe();
+    }
+    for (auto It = SourceStamps.CreateIterator(); It; ++It)
+    {
+        if (!Live.Contains(It->Key))
+        {
+            MarkAll(It->Value.BoundsWS);
+            It.RemoveCurrent();
+        }
+    }
+
+    // 3) Climate first (cheap, whole grid), then dirty bricks until the budget runs out
+    const float Cell = S->DefaultCellSizeCm;
+    auto Occlusion = [this, Cell](const FVector& A, const FVector& B){ return OcclusionBetween(A, B, Cell); };
+    const double Deadline = FPlatformTime::Seconds() + double(S->ComposeBudgetMs) / 1000.0;
+
+    for (TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>>& G : ComposedGrids)
+    {
+        G.Value->ApplyClimate(ClimateState, S->ComposeClimateEpsilonC);
+    }
+    for (TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>>& G : ComposedGrids)
+    {
+        if (FPlatformTime::Seconds() >= Deadline) break;
+        if (G.Value->HasDirty())
+        {
+            G.Value->UpdateDirty(ClimateState, Sources, Occlusion, Deadline);
+        }
+    }
+}
+
+// ---- snapshot ----
+TSharedPtr<const FThermoForgeSnapshot> UThermoForgeSubsystem::GetSnapshot() const
+{
+    FReadScopeLock Lock(SnapshotLock);
+    return Snapshot;
+}
+
+void UThermoForgeSubsystem::PublishSnapshot()
+{
+    UWorld* World = GetWorld();
+    if (!World) return;
+
+    TSharedRef<FThermoForgeSnapshot> Next = MakeShared<FThermoForgeSnapshot>();
+    Next->Climate     = ClimateState;
+    Next->FrameNumber = GFrameCounter;
+
+    // Snapshot volumes follow the resolve order; the actor scan runs only when a volume changed
+    if (bVolumeIndexDirty)
+    {
+        VolumeIndex.Build(World);
+        bVolumeIndexDirty = false;
+        if (VolumeIndex.GetHash() != VolumeSetHash)
+        {
+            VolumeSetHash = VolumeIndex.GetHash();
+            ++VolumeSetRevision;
+        }
+    }
+
+    TSet<TWeakObjectPtr<AThermoForgeVolume>> Seen;
+    for (int32 n=0; n<VolumeIndex.Num(); ++n)
+    {
+        AThermoForgeVolume* Vol = VolumeIndex[n].Volume.Get();
+        const UThermoForgeFieldAsset* Asset = Vol ? Vol->BakedField : nullptr;
+        if (!Asset) continue;
+        Seen.Add(Vol);
+
+        FSnapshotVolumeCache& Cache = SnapshotCache.FindOrAdd(Vol);
+
+        // Baked channels: copied once per field (patches drop the cache entry)
+        if (!Cache.Field.IsValid() || Cache.FieldAsset.Get() != Asset)
+        {
+            TSharedRef<FThermoSnapshotField> F = MakeShared<FThermoSnapshotField>();
+            F->Dim                = Asset->Dim;
+            F->CellSizeCm         = Asset->CellSizeCm;
+            F->Frame              = Asset->GetGridFrame();
+            F->InvFrame           = F->Frame.Inverse();
+            F->SkyView01          = Asset->SkyView01;
+            F->WallPermeability01 = Asset->WallPermeability01;
+            if (const TSharedPtr<const FThermoPermOverrideLayer> Overrides = FindPermOverrides(Asset))
+            {
+                for (const TPair<int32, FThermoPermOverrideCell>& O : Overrides->Cells)
+                {
+                    if (F->WallPermeability01.IsValidIndex(O.Key)) F->WallPermeability01[O.Key] = O.Value.GetPerm01();
+                }
+            }
+            if (Asset->HasSunVisibility())
+            {
+                F->SunVisibilitySH = Asset->SunVisibilitySH;
+            }
+            if (Asset->HasSkyViewHierarchy())
+            {
+                F->SkyViewHierarchy = Asset->GetSkyViewHierarchy();
+            }
+
+            Cache.FieldAsset = Asset;
+            Cache.Field      = F;
+            Cache.Composed.Reset();
+            Cache.ComposedFrom = nullptr;
+        }
+
+        // Composed sources: republished when the grid's revision moves, copying only bricks recomposed since
+        const TSharedPtr<FThermoForgeComposedGrid>* GridPtr = ComposedGrids.Find(Vol);
+        const FThermoForgeComposedGrid* Grid = (GridPtr && (*GridPtr)->GetField() == Asset) ? GridPtr->Get() : nullptr;
+        if (!Grid)
+        {
+            Cache.Composed.Reset();
+            Cache.ComposedFrom = nullptr;
+        }
+        else if (Cache.ComposedFrom != Grid || Cache.ComposedRevision != Grid->GetRevision() || !Cache.Composed.IsValid())
+        {
+            TSharedRef<FThermoSnapshotComposed> C = MakeShared<FThermoSnapshotComposed>();
+            C->BrickDim = Grid->GetBrickDim();
+
+            const int32 NB = C->BrickDim.X * C->BrickDim.Y * C->BrickDim.Z;
+            const FThermoSnapshotComposed* Prev = (Cache.ComposedFrom == Grid) ? Cache.Composed.Get() : nullptr;
+            if (Prev && (Prev->BrickDim != C->BrickDim || Prev->Bricks.Num() != NB)) Prev = nullptr;
+
+            const TBitArray<>& Dirty = Grid->GetDirtyBricks();
+            C->Bricks.SetNum(NB);
+            C->BrickStamps.SetNumZeroed(NB);
+            for (int32 b=0; b<NB; ++b)
+            {
+                if (Dirty[b]) continue;
+
+                const uint32 Stamp = Grid->GetBrickSourceStamp(b);
+                C->BrickStamps[b] = Stamp;
+                if (Prev && Prev->Bricks[b] && Prev->BrickStamps[b] == Stamp)
+                {
+                    C->Bricks[b] = Prev->Bricks[b];
+                    continue;
+                }
+
+                TSharedRef<FThermoSnapshotComposed::FBrick> Chunk = MakeShared<FThermoSnapshotComposed::FBrick>();
+                Grid->CopyBrickSourceC(b, *Chunk);
+                C->Bricks[b] = Chunk;
+            }
+
+            Cache.Composed         = C;
+            Cache.ComposedFrom     = Grid;
+            Cache.ComposedRevision = Grid->GetRevision();
+        }
+
+        FThermoSnapshotVolume& V = Next->Volumes.AddDefaulted_GetRef();
+        V.Volume         = Vol;
+        V.ActorTransform = Vol->GetActorTransform();
+        V.BoxExtent      = Vol->BoxExtent;
+        V.bUnbounded     = Vol->bUnbounded;
+        V.BlendBorderCm  = VolumeIndex[n].BlendBorderCm;
+        V.Field          = Cache.Field;
+        V.Composed       = Cache.Composed;
+    }
+    for (auto It = SnapshotCache.CreateIterator(); It; ++It)
+    {
+        if (!Seen.Contains(It->Key)) It.RemoveCurrent();
+    }
+
+    Next->Sources.Reserve(SourceSet.Num());
+    for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
+    {
+        const UThermoForgeSourceComponent* Src = W.Get();
+        if (!Src || !Src->bEnabled) continue;
+
+        FThermoSnapshotSource& Out = Next->Sources.AddDefaulted_GetRef();
+        Out.Shape    = Src->GetShapeWS();
+        Out.BoundsWS = Src->GetBoundsWS();
+    }
+
+    // Weather map: copied when it advects, shared between snapshots otherwise
+    if (!WeatherMap.IsValid())
+    {
+        PublishedWeather.Reset();
+    }
+    else if (!PublishedWeather.IsValid() || PublishedWeatherRevision != WeatherMap->GetRevision())
+    {
+        PublishedWeather         = MakeShared<FThermoForgeWeatherMap>(*WeatherMap);
+        PublishedWeatherRevision = WeatherMap->GetRevision();
+    }
+    Next->Weather = PublishedWeather;
+
+    // Readers holding the previous snapshot keep it alive until they let go
+    TSharedPtr<const FThermoForgeSnapshot> Published = Next;
+    {
+        FWriteScopeLock Lock(SnapshotLock);
+        Swap(Snapshot, Published);
+    }
+}
+
+// ---- async queries ----
+TSharedPtr<const FThermoForgeSnapshot> UThermoForgeSubsystem::GetSnapshotForAsync()
+{
+    TSharedPtr<const FThermoForgeSnapshot> Snap = GetSnapshot();
+    if (!Snap.IsValid() && IsInGameThread())
+    {
+        PublishSnapshot();
+        Snap = GetSnapshot();
+    }
+    return Snap;
+}
+
+TFuture<float> UThermoForgeSubsystem::ComputeTemperatureAsync(const FVector& WorldPos)
+{
+    TSharedPtr<const FThermoForgeSnapshot> Snap = GetSnapshotForAsync();
+    return Async(EAsyncExecution::ThreadPool, [Snap, WorldPos]()
+    {
+        return Snap.IsValid() ? Snap->ComputeTemperatureAt(WorldPos) : 0.f;
+    });
+}
+
+TFuture<TArray<float>> UThermoForgeSubsystem::ComputeTemperaturesAsync(TArray<FVector> Positions)
+{
+    TSharedPtr<const FThermoForgeSnapshot> Snap = GetSnapshotForAsync();
+    return Async(EAsyncExecution::ThreadPool, [Snap, Positions = MoveTemp(Positions)]()
+    {
+        TArray<float> Out;
+        Out.SetNumZeroed(Positions.Num());
+        if (Snap.IsValid())
+        {
+            for (int32 i=0; i<Positions.Num(); ++i) Out[i] = Snap->ComputeTemperatureAt(Positions[i]);
+        }
+        return Out;
+    });
+}
+
+TFuture<FThermoSnapshotCellHit> UThermoForgeSubsystem::FindBakedExtremeNearAsync(const FVector& CenterWS, float RadiusCm, bool bHottest)
+{
+    TSharedPtr<const FThermoForgeSnapshot> Snap = GetSnapshotForAsync();
+    return Async(EAsyncExecution::ThreadPool, [Snap, CenterWS, RadiusCm, bHottest]()
+    {
+        FThermoSnapshotCellHit Hit;
+        if (Snap.IsValid()) Snap->FindBakedExtremeNear(CenterWS, RadiusCm, bHottest, Hit);
+        return Hit;
+    });
+}
+
+// ---- diffusion ----
+void UThermoForgeSubsystem::UpdateDiffusion(float DeltaTime)
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S || !UseComposedGrids() || !S->bUseDiffusion || S->bDeterministicSimulation)
+    {
+        DiffusionGrids.Empty();
+        return;
+    }
+
+    FThermoForgeDiffusionGrid::FParams Params;
+    Params.DiffusivityCm2PerSec = S->DiffusivityCm2PerSec;
+    Params.ExchangeSeconds      = S->DiffusionExchangeSeconds;
+    Params.StepSeconds          = 1.f / FMath::Max(1.f, S->DiffusionStepHz);
+    Params.MaxStepsPerAdvance   = S->MaxDiffusionStepsPerFrame;
+
+    for (auto It = DiffusionGrids.CreateIterator(); It; ++It)
+    {
+        if (!ComposedGrids.Contains(It->Key)) It.RemoveCurrent();
+    }
+    for (auto It = WindFields.CreateIterator(); It; ++It)
+    {
+        if (!It->Key.IsValid()) It.RemoveCurrent();
+    }
+
+    const FVector WindWS = S->bWindAdvection ? FVector(GetWeatherWind() * S->WindAdvectionScale, 0.0) : FVector::ZeroVector;
+
+    for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>>& G : ComposedGrids)
+    {
+        const UThermoForgeFieldAsset* Field = G.Value->GetField();
+        if (!Field || G.Value->GetDim().X <= 0) continue;
+
+        // Start from the composed field so enabling diffusion doesn't cause a transient
+        TSharedPtr<FThermoForgeDiffusionGrid>& Diff = DiffusionGrids.FindOrAdd(G.Key);
+        if (!Diff.IsValid()) Diff = MakeShared<FThermoForgeDiffusionGrid>();
+        Diff->SetPermOverrides(FindPermOverrides(Field));
+        if (!Diff->IsValidFor(Field)) Diff->Init(Field, S->GuardCells, G.Value->GetTempC());
+
+        const TSharedPtr<const FThermoWindField>* WindField = S->bWindAdvection ? WindFields.Find(G.Key) : nullptr;
+        Diff->SetWind(WindWS, WindField ? *WindField : nullptr);
+
+        // Settle once every brick carries its sources, otherwise the steady state would miss them
+        if (Diff->IsSettlePending() && !G.Value->HasDirty())
+        {
+            FThermoMultigridParams Solver;
+            Solver.ToleranceC = S->SettleToleranceC;
+            Solver.MaxCycles  = S->MaxSettleCycles;
+
+            float Residual = 0.f;
+            const double T0 = FPlatformTime::Seconds();
+            const int32 Cycles = Diff->SolveEquilibrium(Params, G.Value->GetTempC(), Solver, &Residual);
+            UE_LOG(LogTemp, Log, TEXT("[ThermoForge] Diffusion settled for %s: %d V-cycles, residual %.4f C, %.1f ms"),
+                *GetNameSafe(G.Key.Get()), Cycles, Residual, (FPlatformTime::Seconds() - T0) * 1000.0);
+            continue;
+        }
+
+        Diff->Advance(DeltaTime, Params, G.Value->GetTempC());
+    }
+}
+
+void UThermoForgeSubsystem::SettleDiffusion()
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S || !UseComposedGrids() || !S->bUseDiffusion || S->bDeterministicSimulation)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] SettleDiffusion: diffusion is disabled (or replaced by the deterministic mode) in the project settings."));
+        return;
+    }
+
+    for (TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeDiffusionGrid>>& D : DiffusionGrids)
+    {
+        D.Value->RequestSettle();
+    }
+    UpdateDiffusion(0.f);
+}
+
+bool UThermoForgeSubsystem::SetVolumeWindField(AThermoForgeVolume* Volume, FIntVector WindDim, const TArray<FVector>& WindCmPerSec)
+{
+    if (!Volume) return false;
+
+    TSharedRef<FThermoWindField> F = MakeShared<FThermoWindField>();
+    F->WindDim = WindDim;
+    F->WindCmPerSec.Reserve(WindCmPerSec.Num());
+    for (const FVector& W : WindCmPerSec) F->WindCmPerSec.Add(FVector3f(W));
+    if (!F->IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] SetVolumeWindField: %d vectors for a %dx%dx%d field."),
+            WindCmPerSec.Num(), WindDim.X, WindDim.Y, WindDim.Z);
+        return false;
+    }
+
+    WindFields.Add(Volume, F);
+    return true;
+}
+
+void UThermoForgeSubsystem::ClearVolumeWindField(AThermoForgeVolume* Volume)
+{
+    WindFields.Remove(Volume);
+}
+
+bool UThermoForgeSubsystem::SampleRuntimeTemp(const AThermoForgeVolume* Vol, const FVector& WorldPos, float& OutTempC) const
+{
+    if (!Vol) return false;
+    const TWeakObjectPtr<AThermoForgeVolume> Key(const_cast<AThermoForgeVolume*>(Vol));
+
+    // Near the viewpoint the clipmap is finer than the coarse bake of an unbounded volume
+    if (const TSharedPtr<FThermoForgeClipmap>* Clip = Clipmaps.Find(Key))
+    {
+        float Sky = 0.f, Perm = 1.f;
+        if ((*Clip)->Sample(WorldPos, Sky, Perm))
+        {
+            const FThermoClimateState& C = ClimateState;
+            OutTempC = ComposeTemperatureFromChannels(WorldPos, C.AmbientAtZ(WorldPos.Z), C.WeatherAlpha01, Sky, Perm);
+            return true;
+        }
+    }
+    if (!Vol->BakedField) return false;
+
+    if (const TSharedPtr<FThermoForgeFixedGrid>* Fixed = FixedGrids.Find(Key))
+    {
+        if ((*Fixed)->GetField() == Vol->BakedField && (*Fixed)->SampleTemp(WorldPos, OutTempC)) return true;
+    }
+    if (const TSharedPtr<FThermoForgeDiffusionGrid>* Diff = DiffusionGrids.Find(Key))
+    {
+        if ((*Diff)->GetField() == Vol->BakedField && (*Diff)->SampleTemp(WorldPos, OutTempC)) return true;
+    }
+    if (const TSharedPtr<FThermoForgeInertiaGrid>* Inertia = InertiaGrids.Find(Key))
+    {
+        if ((*Inertia)->GetField() == Vol->BakedField && (*Inertia)->SampleTemp(WorldPos, OutTempC)) return true;
+    }
+    if (const TSharedPtr<FThermoForgeComposedGrid>* Grid = ComposedGrids.Find(Key))
+    {
+        if ((*Grid)->GetField() == Vol->BakedField && (*Grid)->SampleTemp(WorldPos, OutTempC)) return true;
+    }
+    return false;
+}
 
-    // --- Smooth seasonal alpha (0 = deep winter, 1 = peak summer), Northern Hemisphere ---
-    // Dec 21 (~355) -> 0, Jun 21 (~172) -> 1, smooth cosine over the year
-    auto Wrap01 = [](float x){ return x - FMath::FloorToFloat(x); };
-    const int32 DOY           = Best.QueryTimeUTC.GetDayOfYear();      // 1..365/366
-    const float YearPos       = Wrap01((float(DOY) - 355.0f) / 365.0f); // 0..1 starting at Dec 21
-    const float SeasonAlpha01 = 0.5f * (1.0f - FMath::Cos(2.0f * PI * YearPos)); // 0→1→0 yearly
+// ---- clipmaps ----
+void UThermoForgeSubsystem::SetClipmapCenter(const FVector& CenterWS)
+{
+    bHasClipmapCenter = true;
+    ClipmapCenter = CenterWS;
+}
 
-    // --- Compute BASELINE using the SAME season (blend winter/summer) to avoid steps ---
-    // Seasons Blend
-    const float BaseWinter = ComputeCurrentTemperatureAt(Best.CellCenterWS, /*bWinter=*/true , TimeHours, WeatherAlfa);
-    const float BaseSummer = ComputeCurrentTemperatureAt(Best.CellCenterWS, /*bWinter=*/false, TimeHours, WeatherAlfa);
-    const float BaselineTotalC = FMath::Lerp(BaseWinter, BaseSummer, SeasonAlpha01);
+void UThermoForgeSubsystem::ClearClipmapCenter()
+{
+    bHasClipmapCenter = false;
+}
 
-    // Extract the ambient part used by baseline (also blended), so we can phase-correct it:
-    const float AmbWinter = S ? S->GetAmbientCelsiusAt(/*bWinter=*/true , TimeHours, Best.CellCenterWS.Z) : 0.0f;
-    const float AmbSummer = S ? S->GetAmbientCelsiusAt(/*bWinter=*/false, TimeHours, Best.CellCenterWS.Z) : 0.0f;
-    const float BaselineAmbientC = FMath::Lerp(AmbWinter, AmbSummer, SeasonAlpha01);
+void UThermoForgeSubsystem::UpdateClipmaps()
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    UWorld* World = GetWorld();
+    if (!S || !World || !S->bUseUnboundedClipmap)
+    {
+        Clipmaps.Empty();
+        return;
+    }
 
-    // --- Desired ambient with new phase: coldest at 00:00, hottest at 12:00 (also seasonal blend) ---
-    const float WinterAvg   = S ? S->WinterAverageC       : 5.0f;
-    const float SummerAvg   = S ? S->SummerAverageC       : 28.0f;
-    const float WinterDelta = S ? S->WinterDayNightDeltaC : 8.0f;
-    const float SummerDelta = S ? S->SummerDayNightDeltaC : 10.0f;
+    FVector Center = ClipmapCenter;
+    if (!bHasClipmapCenter)
+    {
+        APlayerController* PC = World->GetFirstPlayerController();
+        if (!PC) return; // keep the rings where they are until there is a viewpoint
 
-    const float AvgC   = FMath::Lerp(WinterAvg,   SummerAvg,   SeasonAlpha01);
-    const float DeltaC = FMath::Lerp(WinterDelta, SummerDelta, SeasonAlpha01);
+        FRotator ViewRot;
+        PC->GetPlayerViewPoint(Center, ViewRot);
+    }
 
-    // 00:00 trough, 12:00 peak
-    const float Phase   = (TimeHours - 12.0f) / 24.0f;
-    const float CosWave = FMath::Cos(2.0f * PI * Phase);
-    const float DesiredAmbientSeaC = AvgC + 0.5f * DeltaC * CosWave;
+    TSet<TWeakObjectPtr<AThermoForgeVolume>> Seen;
+    for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
+    {
+        AThermoForgeVolume* Vol = *It;
+        if (!Vol || !Vol->bUnbounded) continue;
+        Seen.Add(Vol);
+
+        FThermoForgeClipmap::FParams Params;
+        Params.Levels         = S->ClipmapLevels;
+        Params.Resolution     = S->ClipmapResolution;
+        Params.BaseCellSizeCm = Vol->BakedField ? Vol->BakedField->CellSizeCm : Vol->GetEffectiveCellSize();
+
+        TSharedPtr<FThermoForgeClipmap>& Clip = Clipmaps.FindOrAdd(Vol);
+        if (!Clip.IsValid()) Clip = MakeShared<FThermoForgeClipmap>();
+        if (!Clip->IsValidFor(Params)) Clip->Init(Params);
+
+        Clip->Recenter(Center);
+        Clip->Fill(S->ClipmapTraceCellsPerFrame, Vol->BakedField,
+            [this](const FVector& P, float CellSizeCm, float& OutSky, float& OutPerm)
+            {
+                TraceCellChannels(P, CellSizeCm, OutSky, OutPerm);
+            });
+    }
+    for (auto It = Clipmaps.CreateIterator(); It; ++It)
+    {
+        if (!Seen.Contains(It->Key)) It.RemoveCurrent();
+    }
+}
 
-    // Altitude adjustment
-    const float DesiredAmbientC = S ? S->AdjustForAltitude(DesiredAmbientSeaC, Best.CellCenterWS.Z)
-                                    : DesiredAmbientSeaC;
+void UThermoForgeSubsystem::TraceCellChannels(const FVector& P, float CellSizeCm, float& OutSky01, float& OutWallPerm01) const
+{
+    static TArray<FVector> HemiDirs;
+    if (HemiDirs.Num() == 0) TF_BuildHemiDirs(HemiDirs);
+
+    // Same estimators as TickBake, with all six neighbours available
+    float Open = 0.f;
+    for (const FVector& d : HemiDirs) Open += TraceAmbientRay01(P, d, 100000.f);
+    OutSky01 = FMath::Clamp(Open / float(HemiDirs.Num()), 0.f, 1.f);
+
+    static const FVector Axes[6] = { FVector::ForwardVector, FVector::BackwardVector, FVector::RightVector,
+                                     FVector::LeftVector, FVector::UpVector, FVector::DownVector };
+    float Perm = 0.f;
+    for (const FVector& A : Axes) Perm += FMath::Clamp(OcclusionBetween(P, P + A * CellSizeCm, CellSizeCm), 0.f, 1.f);
+    OutWallPerm01 = Perm / 6.f;
+}
 
-    // --- Apply phase correction without jumps ---
-    const float AmbientDelta = DesiredAmbientC - BaselineAmbientC;
-    Best.CurrentTempC = BaselineTotalC + AmbientDelta;
+bool UThermoForgeSubsystem::SampleClipmapTemp(const FVector& WorldPos, float& OutTempC) const
+{
+    for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeClipmap>>& Clip : Clipmaps)
+    {
+        float Sky = 0.f, Perm = 1.f;
+        if (!Clip.Key.IsValid() || !Clip.Value->Sample(WorldPos, Sky, Perm)) continue;
 
+        const FThermoClimateState& C = ClimateState;
+        OutTempC = ComposeTemperatureFromChannels(WorldPos, C.AmbientAtZ(WorldPos.Z), C.WeatherAlpha01, Sky, Perm);
+        return true;
+    }
+    return false;
 }
 
+// ---- inertia ----
+void UThermoForgeSubsystem::UpdateInertia()
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    const UWorld* World = GetWorld();
+    if (!S || !World || !UseComposedGrids() || !S->bUseThermalInertia || S->bUseDiffusion || S->bDeterministicSimulation)
+    {
+        InertiaGrids.Empty();
+        return;
+    }
+
+    FThermoForgeInertiaGrid::FParams Params;
+    Params.OutdoorSeconds = S->InertiaOutdoorSeconds;
+    Params.IndoorSeconds  = S->InertiaIndoorSeconds;
+    Params.CellsPerFrame  = S->InertiaCellsPerFrame;
 
-    return Best;
+    // Game time: inertia pauses with the world
+    const double Now = World->GetTimeSeconds();
+
+    for (auto It = InertiaGrids.CreateIterator(); It; ++It)
+    {
+        if (!ComposedGrids.Contains(It->Key)) It.RemoveCurrent();
+    }
+
+    for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>>& G : ComposedGrids)
+    {
+        const UThermoForgeFieldAsset* Field = G.Value->GetField();
+        if (!Field || G.Value->GetDim().X <= 0) continue;
+
+        TSharedPtr<FThermoForgeInertiaGrid>& Inertia = InertiaGrids.FindOrAdd(G.Key);
+        if (!Inertia.IsValid()) Inertia = MakeShared<FThermoForgeInertiaGrid>();
+        if (!Inertia->IsValidFor(Field, Params)) Inertia->Init(Field, Params, G.Value->GetTempC(), Now);
+
+        // Follow the target exactly until its first full composition, so level start doesn't "warm up"
+        if (Inertia->IsSeeding())
+        {
+            Inertia->Snap(G.Value->GetTempC(), Now);
+            if (!G.Value->HasDirty()) Inertia->FinishSeeding();
+            continue;
+        }
+
+        Inertia->Update(Now, Params, G.Value->GetTempC());
+    }
 }
 
-FThermoForgeGridHit UThermoForgeSubsystem::QueryNearestBakedGridPointNow(const FVector& WorldLocation) const
+void UThermoForgeSubsystem::SnapThermalInertia()
 {
-    return QueryNearestBakedGridPoint(WorldLocation, FDateTime::UtcNow());
+    const UWorld* World = GetWorld();
+    if (!World) return;
+
+    for (TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeInertiaGrid>>& I : InertiaGrids)
+    {
+        const TSharedPtr<FThermoForgeComposedGrid>* Grid = ComposedGrids.Find(I.Key);
+        if (Grid) I.Value->Snap((*Grid)->GetTempC(), World->GetTimeSeconds());
+    }
 }
 
-// --------- Runtime composition ---------
-float UThermoForgeSubsystem::ComputeCurrentTemperatureAt(const FVector& WorldPos, bool bWinter, float TimeHours, float WeatherAlpha01) const
+// ---- deterministic ----
+bool UThermoForgeSubsystem::SyncFixedGrids()
 {
     const UThermoForgeProjectSettings* S = GetSettings();
-    if (!S) return 0.f;
+    if (!S || !UseComposedGrids() || !S->bDeterministicSimulation)
+    {
+        FixedGrids.Empty();
+        FixedStepCount = 0;
+        FixedClockTicks = 0;
+        FixedChecksum = 0;
+        return false;
+    }
 
-    // Find nearest baked field and read both scalars
-    float Sky = 0.f;
-    float WallPerm = 1.f;
+    for (auto It = FixedGrids.CreateIterator(); It; ++It)
+    {
+        if (!ComposedGrids.Contains(It->Key)) It.RemoveCurrent();
+    }
+
+    const FThermoFixedClimate Climate = MakeFixedClimate();
+    TArray<FThermoFixedSource> Sources;
+    bool bChanged = false;
+
+    for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>>& G : ComposedGrids)
+    {
+        const UThermoForgeFieldAsset* Field = G.Value->GetField();
+        if (!Field || G.Value->GetDim().X <= 0) continue;
+
+        TSharedPtr<FThermoForgeFixedGrid>& Fixed = FixedGrids.FindOrAdd(G.Key);
+        if (!Fixed.IsValid()) Fixed = MakeShared<FThermoForgeFixedGrid>();
+        if (Fixed->IsValidFor(Field)) continue;
+
+        // Start at the target, not the float cache: the seed must be reproducible too
+        Fixed->Init(Field, S->GuardCells, FindPermOverrides(Field).Get());
+        GatherFixedSources(*Fixed, Sources);
+        Fixed->Snap(Climate, Sources);
+        bChanged = true;
+    }
+
+    if (bChanged) RefreshFixedChecksum();
+    return true;
+}
+
+void UThermoForgeSubsystem::UpdateDeterministic()
+{
+    if (!SyncFixedGrids()) return;
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S->bDeterministicManualStep) AdvanceFixedGrids(1);
+}
+
+void UThermoForgeSubsystem::StepDeterministicSimulation(int32 Steps)
+{
+    if (Steps <= 0) return;
+    if (!SyncFixedGrids())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] StepDeterministicSimulation: bDeterministicSimulation is off in the project settings."));
+        return;
+    }
+    AdvanceFixedGrids(Steps);
+}
+
+void UThermoForgeSubsystem::ResetDeterministicSimulation()
+{
+    FixedGrids.Empty();
+    FixedStepCount = 0;
+    FixedClockTicks = 0;
+    FixedChecksum = 0;
+    SyncFixedGrids();
+}
+
+FThermoFixedClimate UThermoForgeSubsystem::MakeFixedClimate() const
+{
+    return FThermoFixedClimateModel::FromSettings(*GetSettings())
+        .At(GameClockStart.GetTicks() + FixedClockTicks, ThermoFixed::FromFloat(WeatherAlpha01));
+}
+
+void UThermoForgeSubsystem::AdvanceFixedGrids(int32 Steps)
+{
+    const UThermoForgeProjectSettings* S = GetSettings();
+    const float StepSeconds = 1.f / FMath::Max(1.f, S->DiffusionStepHz);
+    const int64 StepTicks = int64(FMath::RoundToDouble(double(ETimespan::TicksPerSecond) * StepSeconds * GameTimeScale));
+
+    struct FFixedStep
+    {
+        FThermoForgeFixedGrid* Grid;
+        FThermoForgeFixedGrid::FParams Params;
+        TArray<FThermoFixedSource> Sources;
+    };
+    TArray<FFixedStep> Work;
+    for (TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeFixedGrid>>& F : FixedGrids)
+    {
+        FFixedStep& W = Work.AddDefaulted_GetRef();
+        W.Grid   = F.Value.Get();
+        W.Params = FThermoForgeFixedGrid::FParams::Make(
+            S->DiffusivityCm2PerSec, S->DiffusionExchangeSeconds, StepSeconds, F.Value->GetCellSizeCm());
+        GatherFixedSources(*F.Value, W.Sources);
+    }
 
+    // The climate follows the step clock, so N steps in one call match N calls of one step
+    for (int32 s=0; s<Steps; ++s)
     {
-        UWorld* World = GetWorld();
-        FThermoForgeGridHit Best;
-        if (World)
+        const FThermoFixedClimate Climate = MakeFixedClimate();
+        for (FFixedStep& W : Work)
         {
-            for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
-            {
-                const AThermoForgeVolume* Vol = *It;
-                if (!Vol || !Vol->BakedField) continue;
+            W.Grid->Step(Climate, W.Sources, W.Params);
+        }
+        FixedClockTicks += StepTicks;
+    }
 
-                FThermoForgeGridHit Hit;
-                if (!ComputeNearestInVolume(Vol, WorldPos, Hit)) continue;
+    FixedStepCount += Steps;
+    RefreshFixedChecksum();
+}
 
-                if (!Best.bFound || Hit.DistanceSq < Best.DistanceSq)
-                    Best = Hit;
-            }
+void UThermoForgeSubsystem::GatherFixedSources(const FThermoForgeFixedGrid& Grid, TArray<FThermoFixedSource>& OutSources) const
+{
+    // Set order differs between peers; the integer sums it feeds do not depend on it
+    OutSources.Reset();
+    for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
+    {
+        const UThermoForgeSourceComponent* Src = W.Get();
+        if (!Src || !Src->bEnabled) continue;
+
+        FThermoFixedSource Fixed;
+        if (Grid.MakeSource(Src->GetShapeWS(), Fixed)) OutSources.Add(Fixed);
+    }
+}
+
+void UThermoForgeSubsystem::RefreshFixedChecksum()
+{
+    // Map order is not stable across peers; combine per-volume checksums in path order
+    TArray<TPair<FString, uint32>> PerVolume;
+    for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeFixedGrid>>& F : FixedGrids)
+    {
+        if (const AThermoForgeVolume* Vol = F.Key.Get()) PerVolume.Emplace(Vol->GetPathName(), F.Value->GetChecksum());
+    }
+    PerVolume.Sort([](const TPair<FString, uint32>& A, const TPair<FString, uint32>& B){ return A.Key < B.Key; });
+
+    uint32 Crc = FCrc::MemCrc32(&FixedStepCount, sizeof(FixedStepCount));
+    for (const TPair<FString, uint32>& V : PerVolume)
+    {
+        Crc = FCrc::MemCrc32(&V.Value, sizeof(uint32), Crc);
+    }
+    FixedChecksum = Crc;
+}
+
+// ---- zones ----
+void UThermoForgeSubsystem::SetTemperatureZoneLayer(FName LayerName, float ThresholdC, bool bAbove)
+{
+    if (LayerName.IsNone()) return;
+
+    const UThermoForgeProjectSettings* S = GetSettings();
+    if (!S || !S->bUseComposedGrid)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[ThermoForge] Zone layer '%s' needs bUseComposedGrid; it stays empty until enabled."), *LayerName.ToString());
+    }
+
+    FZoneLayer& L = ZoneLayers.FindOrAdd(LayerName);
+    L.ThresholdC = ThresholdC;
+    L.bAbove     = bAbove;
+    for (TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeZoneMap>>& M : L.Maps)
+        M.Value->Configure(ThresholdC, bAbove);
+
+    UpdateZoneLayers();
+}
+
+void UThermoForgeSubsystem::RemoveTemperatureZoneLayer(FName LayerName)
+{
+    ZoneLayers.Remove(LayerName);
+}
+
+void UThermoForgeSubsystem::UpdateZoneLayers()
+{
+    for (TPair<FName, FZoneLayer>& Layer : ZoneLayers)
+    {
+        FZoneLayer& L = Layer.Value;
+        for (auto It = L.Maps.CreateIterator(); It; ++It)
+        {
+            if (!ComposedGrids.Contains(It->Key)) It.RemoveCurrent();
         }
 
-        if (Best.bFound && Best.Volume && Best.Volume->BakedField)
+        for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>>& G : ComposedGrids)
         {
-            Sky      = FMath::Clamp(Best.Volume->BakedField->GetSkyViewByLinearIdx(Best.LinearIndex), 0.f, 1.f);
-            WallPerm = FMath::Clamp(Best.Volume->BakedField->GetWallPermByLinearIdx(Best.LinearIndex), 0.f, 1.f);
+            TSharedPtr<FThermoForgeZoneMap>& Map = L.Maps.FindOrAdd(G.Key);
+            if (!Map.IsValid())
+            {
+                Map = MakeShared<FThermoForgeZoneMap>();
+                Map->Configure(L.ThresholdC, L.bAbove);
+            }
+            Map->Update(*G.Value);
         }
     }
+}
 
-    // Ambient + altitude
-    float AmbientC = S->GetAmbientCelsiusAt(bWinter, TimeHours, WorldPos.Z);
+bool UThermoForgeSubsystem::FindZoneAt(FName LayerName, const FVector& WorldPos, FThermoZoneInfo& OutZone) const
+{
+    OutZone = FThermoZoneInfo();
 
-    // Solar gain (reduced by weather)
-    const float Solar = S->SolarGainScaleC * Sky * (1.f - FMath::Clamp(WeatherAlpha01, 0.f, 1.f));
+    const FZoneLayer* L = ZoneLayers.Find(LayerName);
+    if (!L) return false;
 
-    // Dynamic sources (attenuated by LOS * local wall permeability)
-    float SourceSum = 0.f;
+    for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeZoneMap>>& M : L->Maps)
     {
-        for (const TWeakObjectPtr<UThermoForgeSourceComponent>& W : SourceSet)
+        AThermoForgeVolume* Vol = M.Key.Get();
+        if (!Vol || !VolumeContainsPoint(Vol, WorldPos)) continue;
+
+        const int32 Id = M.Value->ZoneAt(WorldPos);
+        if (Id > 0 && M.Value->GetZoneInfo(Id, OutZone))
         {
-            const UThermoForgeSourceComponent* Sc = W.Get();
-            if (!Sc || !Sc->bEnabled) continue;
+            OutZone.Volume = Vol;
+            return true;
+        }
+    }
+    return false;
+}
 
-            const float Intensity = Sc->SampleAt(WorldPos); // °C delta
-            if (Intensity == 0.f) continue;
+int32 UThermoForgeSubsystem::GetTemperatureZones(FName LayerName, TArray<FThermoZoneInfo>& OutZones) const
+{
+    OutZones.Reset();
 
-            const float CellSize = S->DefaultCellSizeCm;
-            const float Occ = OcclusionBetween(WorldPos, Sc->GetOwnerLocationSafe(), CellSize);
-            // WallPerm scales local transmissivity
-            SourceSum += Intensity * Occ * WallPerm;
+    const FZoneLayer* L = ZoneLayers.Find(LayerName);
+    if (!L) return 0;
+
+    for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeZoneMap>>& M : L->Maps)
+    {
+        AThermoForgeVolume* Vol = M.Key.Get();
+        if (!Vol) continue;
+
+        for (int32 Id=1; Id<=M.Value->GetZones().Num(); ++Id)
+        {
+            FThermoZoneInfo Info;
+            if (!M.Value->GetZoneInfo(Id, Info)) continue;
+            Info.Volume = Vol;
+            OutZones.Add(Info);
         }
     }
+    return OutZones.Num();
+}
 
-    return AmbientC + Solar + SourceSum;
+bool UThermoForgeSubsystem::GetZoneIsosurface(FName LayerName, TArray<FVector>& OutVertices, TArray<int32>& OutTriangles) const
+{
+    OutVertices.Reset();
+    OutTriangles.Reset();
+
+    const FZoneLayer* L = ZoneLayers.Find(LayerName);
+    if (!L) return false;
+
+    for (const TPair<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeZoneMap>>& M : L->Maps)
+    {
+        if (M.Key.IsValid()) M.Value->AppendMesh(OutVertices, OutTriangles);
+    }
+    return OutTriangles.Num() > 0;
 }
 
 // ---- Save helpers ----
 #if WITH_EDITOR
 UThermoForgeFieldAsset* UThermoForgeSubsystem::CreateAndSaveFieldAsset(AThermoForgeVolume* Volume,
     const FIntVector& Dim, float Cell, const FVector& FieldOriginWS, const FRotator& GridRotation,
-    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01) const
+    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01,
+    const TArray<FVector4f>& SunVisibilitySH) const
 {
     if (!Volume) return nullptr;
 
@@ -658,20 +2592,57 @@ UThermoForgeFieldAsset* UThermoForgeSubsystem::CreateAndSaveFieldAsset(AThermoFo
 
     UThermoForgeFieldAsset* Saved = FindObject<UThermoForgeFieldAsset>(Pkg, *AssetName);
     const bool bIsNew = (Saved == nullptr);
-    if (!Saved)
+
+    // Same grid as last time: patch changed tiles in place, then save as usual
+    const UThermoForgeProjectSettings* S = GetSettings();
+    FThermoForgeFieldPatch Patch;
+    bool bPatched = false;
+    if (!bIsNew && S->bPatchFieldsOnRebake
+        && FThermoForgeFieldPatch::Diff(*Saved, Dim, Cell, FieldOriginWS, GridRotation,
+                                        SkyView01, WallPerm01, Indoor01, S->FieldPatchTolerance, Patch))
+    {
+        // Tiles carry the scalar channels only; the sun lobes are small enough to replace whole
+        const bool bSunChanged = Saved->SunVisibilitySH != SunVisibilitySH;
+        if (Patch.IsEmpty() && !bSunChanged)
+        {
+            UE_LOG(LogTemp, Log, TEXT("[ThermoForge] %s unchanged by rebake"), *PackageName);
+            return Saved;
+        }
+
+        Saved->Modify();
+        Saved->SunVisibilitySH = SunVisibilitySH;
+        bPatched = Saved->ApplyPatch(Patch);
+    }
+
+    if (bPatched && !Patch.IsEmpty())
     {
-        Saved = NewObject<UThermoForgeFieldAsset>(Pkg, UThermoForgeFieldAsset::StaticClass(),
-                                                  *AssetName, RF_Public | RF_Standalone);
-        FAssetRegistryModule::AssetCreated(Saved);
+        const FString PatchFile = FString::Printf(TEXT("%s/%s_Field_%s.tfpatch"),
+            *(FPaths::ProjectSavedDir() / TEXT("ThermoForge/Patches")), *VolName,
+            *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")));
+        Patch.SaveToFile(PatchFile);
+
+        UE_LOG(LogTemp, Log, TEXT("[ThermoForge] Patched %s : %d tiles, %lld cells (%s)"),
+               *PackageName, Patch.Tiles.Num(), Patch.NumCells(), *PatchFile);
     }
+    else if (!bPatched)
+    {
+        if (!Saved)
+        {
+            Saved = NewObject<UThermoForgeFieldAsset>(Pkg, UThermoForgeFieldAsset::StaticClass(),
+                                                      *AssetName, RF_Public | RF_Standalone);
+            FAssetRegistryModule::AssetCreated(Saved);
+        }
 
-    Saved->Dim               = Dim;
-    Saved->CellSizeCm        = Cell;
-    Saved->OriginWS          = FieldOriginWS;
-    Saved->GridRotation = GridRotation;
-    Saved->SkyView01         = SkyView01;
-    Saved->WallPermeability01= WallPerm01;
-    Saved->Indoorness01      = Indoor01;
+        Saved->Dim               = Dim;
+        Saved->CellSizeCm        = Cell;
+        Saved->OriginWS          = FieldOriginWS;
+        Saved->GridRotation = GridRotation;
+        Saved->SkyView01         = SkyView01;
+        Saved->WallPermeability01= WallPerm01;
+        Saved->Indoorness01      = Indoor01;
+        Saved->SunVisibilitySH   = SunVisibilitySH;
+        Saved->RebuildDerivedData();
+    }
 
     Saved->MarkPackageDirty();
     Pkg->MarkPackageDirty();
@@ -697,31 +2668,19 @@ UThermoForgeFieldAsset* UThermoForgeSubsystem::CreateAndSaveFieldAsset(AThermoFo
 #endif
 
 void UThermoForgeSubsystem::TF_DumpFieldToSavedFolder(const FString& VolName, const FIntVector& Dim, float Cell,
-    const FVector& OriginWS, const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01)
+    const FVector& OriginWS, const FRotator& GridRotation,
+    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01)
 {
 #if WITH_EDITOR
-    const FString Dir  = FPaths::ProjectSavedDir() / TEXT("ThermoForge/Bakes");
-    IFileManager::Get().MakeDirectory(*Dir, true);
+    const UThermoForgeProjectSettings* S = GetDefault<UThermoForgeProjectSettings>();
 
-    const FString Fn   = FString::Printf(TEXT("%s/%s_Field_%s.csv"),
+    const FString Dir  = FPaths::ProjectSavedDir() / TEXT("ThermoForge/Bakes");
+    const FString Base = FString::Printf(TEXT("%s/%s_Field_%s"),
                         *Dir, *VolName, *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")));
 
-    FString Out;
-    Out.Reserve(256 + SkyView01.Num() * 48);
-    Out += TEXT("# DimX,DimY,DimZ,CellSizeCm,OriginX,OriginY,OriginZ\n");
-    Out += FString::Printf(TEXT("%d,%d,%d,%.6f,%.6f,%.6f,%.6f\n"),
-                           Dim.X, Dim.Y, Dim.Z, Cell, OriginWS.X, OriginWS.Y, OriginWS.Z);
-    Out += TEXT("index,skyview,wallperm,indoor\n");
-
-    const int32 N = SkyView01.Num();
-    for (int32 i=0; i<N; ++i)
-    {
-        const float A = SkyView01.IsValidIndex(i) ? SkyView01[i] : 0.f;
-        const float B = WallPerm01.IsValidIndex(i) ? WallPerm01[i] : 1.f;
-        const float C = Indoor01.IsValidIndex(i) ? Indoor01[i] : 0.f;
-        Out += FString::Printf(TEXT("%d,%.6f,%.6f,%.6f\n"), i, A, B, C);
-    }
-
+    // Binary slabs streamed in chunks; peak memory stays at one chunk regardless of field size
+    FThermoForgeFieldExport::Write(Base, Dim, Cell, OriginWS, GridRotation,
+        SkyView01, WallPerm01, Indoor01, S->FieldExportFormat);
 #endif
 }
 
@@ -755,43 +2714,7 @@ float UThermoForgeSubsystem::ComputeBakedOnlyTemperatureAt(const FVector& WorldP
 
     // Pick nearest baked cell (prefer containing volume).
     FThermoForgeGridHit Best;
-    {
-        UWorld* W = GetWorld();
-        if (W)
-        {
-            bool FoundInContaining = false;
-            for (TActorIterator<AThermoForgeVolume> It(W); It; ++It)
-            {
-                const AThermoForgeVolume* Vol = *It;
-                if (!Vol || !Vol->BakedField) continue;
-                if (!VolumeContainsPoint(Vol, WorldPos)) continue;
-
-                FThermoForgeGridHit Hit;
-                if (ComputeNearestInVolume(Vol, WorldPos, Hit))
-                {
-                    if (!FoundInContaining || Hit.DistanceSq < Best.DistanceSq)
-                    {
-                        Best = Hit; FoundInContaining = true;
-                    }
-                }
-            }
-            if (!FoundInContaining)
-            {
-                for (TActorIterator<AThermoForgeVolume> It(W); It; ++It)
-                {
-                    const AThermoForgeVolume* Vol = *It;
-                    if (!Vol || !Vol->BakedField) continue;
-
-                    FThermoForgeGridHit Hit;
-                    if (ComputeNearestInVolume(Vol, WorldPos, Hit))
-                    {
-                        if (!Best.bFound || Hit.DistanceSq < Best.DistanceSq)
-                            Best = Hit;
-                    }
-                }
-            }
-        }
-    }
+    FindNearestCellPreferContaining(WorldPos, Best);
 
     float Sky = 0.f;
     if (Best.bFound && Best.Volume && Best.Volume->BakedField && Best.LinearIndex >= 0)
@@ -803,7 +2726,29 @@ float UThermoForgeSubsystem::ComputeBakedOnlyTemperatureAt(const FVector& WorldP
     return AmbientC + SolarC;
 }
 
+float UThermoForgeSubsystem::ComputeBakedOnlyTemperatureNow(const FVector& WorldPos) const
+{
+    FThermoForgeGridHit Best;
+    FindNearestCellPreferContaining(WorldPos, Best);
+
+    float Sky = 0.f;
+    if (Best.bFound && Best.Volume && Best.Volume->BakedField && Best.LinearIndex >= 0)
+        Sky = FMath::Clamp(Best.Volume->BakedField->GetSkyViewByLinearIdx(Best.LinearIndex), 0.f, 1.f);
+
+    return ClimateState.ToBakedModel().Evaluate(Sky, WorldPos.Z);
+}
+
 bool UThermoForgeSubsystem::FindBakedExtremeNear(const FVector& CenterWS, float RadiusCm, bool bHottest, FThermoForgeGridHit& OutHit, const FDateTime& QueryTimeUTC) const
+{
+    return FindBakedExtremeUnder(MakeClimateState(QueryTimeUTC), CenterWS, RadiusCm, bHottest, OutHit);
+}
+
+bool UThermoForgeSubsystem::FindBakedExtremeNearNow(const FVector& CenterWS, float RadiusCm, bool bHottest, FThermoForgeGridHit& OutHit) const
+{
+    return FindBakedExtremeUnder(ClimateState, CenterWS, RadiusCm, bHottest, OutHit);
+}
+
+bool UThermoForgeSubsystem::FindBakedExtremeUnder(const FThermoClimateState& Climate, const FVector& CenterWS, float RadiusCm, bool bHottest, FThermoForgeGridHit& OutHit) const
 {
     OutHit = FThermoForgeGridHit{};
     UWorld* W = GetWorld();
@@ -864,64 +2809,77 @@ bool UThermoForgeSubsystem::FindBakedExtremeNear(const FVector& CenterWS, float
     const FVector CenterLS = InvFrame.TransformPosition(CenterWS);
     const FVector CenterCell = CenterLS / Cell;
 
-    const int32 cx = FMath::Clamp(FMath::FloorToInt(CenterCell.X + 0.5f), 0, D.X-1);
-    const int32 cy = FMath::Clamp(FMath::FloorToInt(CenterCell.Y + 0.5f), 0, D.Y-1);
-    const int32 cz = FMath::Clamp(FMath::FloorToInt(CenterCell.Z + 0.5f), 0, D.Z-1);
-
-    const int32 R = FMath::Clamp(FMath::CeilToInt(RadiusCm / Cell), 0, 1024);
-
-    auto Index = [&](int32 x,int32 y,int32 z){ return (z*D.Y + y)*D.X + x; };
+    FThermoBakedExtremeQuery Q;
+    Q.CenterCell = FIntVector(
+        FMath::Clamp(FMath::FloorToInt(CenterCell.X + 0.5f), 0, D.X-1),
+        FMath::Clamp(FMath::FloorToInt(CenterCell.Y + 0.5f), 0, D.Y-1),
+        FMath::Clamp(FMath::FloorToInt(CenterCell.Z + 0.5f), 0, D.Z-1));
+    Q.RadiusCells = FMath::Clamp(FMath::CeilToInt(RadiusCm / Cell), 0, 1024);
+    Q.bHottest    = bHottest;
+    Q.Model       = Climate.ToBakedModel();
 
-    // Preview Knobs
-    const bool  bWinter     = false;
-    const float TimeHours   = 12.f;
-    const float WeatherAlfa = 0.3f;
-
-    float BestTemp = bHottest ? -FLT_MAX : +FLT_MAX;
+    // Hierarchical search over the baked SkyView pyramid (Ambient + Solar*Sky)
     FIntVector BestIdx = Seed.GridIndex;
-    FVector    BestPos = Seed.CellCenterWS;
-
-    for (int32 z = FMath::Max(0, cz-R); z <= FMath::Min(D.Z-1, cz+R); ++z)
-    for (int32 y = FMath::Max(0, cy-R); y <= FMath::Min(D.Y-1, cy+R); ++y)
-    for (int32 x = FMath::Max(0, cx-R); x <= FMath::Min(D.X-1, cx+R); ++x)
-    {
-        // Keep spherical radius; skip if outside
-        const FVector Delta(float(x-cx), float(y-cy), float(z-cz));
-        if (Delta.SizeSquared() > float(R*R)) continue;
-
-        const int32 lin = Index(x,y,z);
+    float BestTemp = 0.f;
+    if (!Field->FindExtremeCell(Q, BestIdx, BestTemp)) return false;
 
-        // Baked-only composition: Ambient + Solar*Sky
-        const float Sky = FMath::Clamp(Field->SkyView01.IsValidIndex(lin) ? Field->SkyView01[lin] : 0.f, 0.f, 1.f);
-
-        const FVector CellCenterLS((x+0.5f)*Cell, (y+0.5f)*Cell, (z+0.5f)*Cell);
-        const FVector CellCenterWS = Frame.TransformPosition(CellCenterLS);
-
-        const float AmbientC = S->GetAmbientCelsiusAt(bWinter, TimeHours, CellCenterWS.Z);
-        const float SolarC   = S->SolarGainScaleC * Sky * (1.f - WeatherAlfa);
-        const float ThisC    = AmbientC + SolarC;
-
-        const bool bBetter = bHottest ? (ThisC > BestTemp) : (ThisC < BestTemp);
-        if (bBetter)
-        {
-            BestTemp = ThisC;
-            BestIdx  = FIntVector(x,y,z);
-            BestPos  = CellCenterWS;
-        }
-    }
+    const FVector BestPos = Frame.TransformPosition(
+        FVector((BestIdx.X+0.5f)*Cell, (BestIdx.Y+0.5f)*Cell, (BestIdx.Z+0.5f)*Cell));
 
     OutHit.bFound       = true;
     OutHit.Volume       = const_cast<AThermoForgeVolume*>(BestVol);
     OutHit.GridIndex    = BestIdx;
-    OutHit.LinearIndex  = Index(BestIdx.X, BestIdx.Y, BestIdx.Z);
+    OutHit.LinearIndex  = Field->Index(BestIdx.X, BestIdx.Y, BestIdx.Z);
     OutHit.CellCenterWS = BestPos;
     OutHit.DistanceSq   = FVector::DistSquared(BestPos, CenterWS);
     OutHit.CellSizeCm   = Field->CellSizeCm;
-    OutHit.QueryTimeUTC = QueryTimeUTC;
+    OutHit.QueryTimeUTC = Climate.TimeUTC;
     OutHit.CurrentTempC = BestTemp;
 
     return true;
 }
+
+int32 UThermoForgeSubsystem::FindTopKExtremes(const FVector& CenterWS, float RadiusCm, int32 K, float MinSeparationCm, bool bHottest, TArray<FThermoForgeGridHit>& OutHits) const
+{
+    OutHits.Reset();
+    if (K <= 0) return 0;
+
+    // Same volume choice as FindBakedExtremeNearNow
+    FThermoForgeGridHit Seed;
+    if (!FindNearestCellPreferContaining(CenterWS, Seed) || !Seed.Volume || !Seed.Volume->BakedField) return 0;
+
+    const UThermoForgeFieldAsset* Field = Seed.Volume->BakedField;
+    const float Cell = FMath::Max(1.f, Field->CellSizeCm);
+    const FTransform Frame = Field->GetGridFrame();
+
+    FThermoBakedExtremeQuery Q;
+    Q.CenterCell  = Seed.GridIndex;
+    Q.RadiusCells = FMath::Clamp(FMath::CeilToInt(RadiusCm / Cell), 0, 1024);
+    Q.bHottest    = bHottest;
+    Q.Model       = ClimateState.ToBakedModel();
+
+    TArray<FThermoBakedExtremeCell> Cells;
+    if (!UThermoForgeFieldAsset::FindTopKCellsInView(Field->MakeSearchView(), Q, K, MinSeparationCm / Cell, Cells)) return 0;
+
+    OutHits.Reserve(Cells.Num());
+    for (const FThermoBakedExtremeCell& C : Cells)
+    {
+        const FVector Pos = Frame.TransformPosition(
+            FVector((C.Cell.X+0.5f)*Cell, (C.Cell.Y+0.5f)*Cell, (C.Cell.Z+0.5f)*Cell));
+
+        FThermoForgeGridHit& Hit = OutHits.AddDefaulted_GetRef();
+        Hit.bFound       = true;
+        Hit.Volume       = Seed.Volume;
+        Hit.GridIndex    = C.Cell;
+        Hit.LinearIndex  = Field->Index(C.Cell.X, C.Cell.Y, C.Cell.Z);
+        Hit.CellCenterWS = Pos;
+        Hit.DistanceSq   = FVector::DistSquared(Pos, CenterWS);
+        Hit.CellSizeCm   = Field->CellSizeCm;
+        Hit.QueryTimeUTC = ClimateState.TimeUTC;
+        Hit.CurrentTempC = C.TempC;
+    }
+    return OutHits.Num();
+}
 // bake per cell
 void UThermoForgeSubsystem::TickBake()
 {
@@ -949,12 +2907,18 @@ void UThermoForgeSubsystem::TickBake()
         );
         const FVector P = BakeFrame.TransformPosition(CenterLS);
 
-        // Sky openness
+        // Sky openness, and the same rays fitted to a directional lobe for the sun
         float openness = 0.f;
-        for (const FVector& d : BakeHemiDirs)
-            openness += TraceAmbientRay01(P, d, RayLen);
+        FVector4f SunSH(0.f, 0.f, 0.f, 0.f);
+        for (int32 d=0; d<BakeHemiDirs.Num(); ++d)
+        {
+            const float open = TraceAmbientRay01(P, BakeHemiDirs[d], RayLen);
+            openness += open;
+            SunSH    += BakeSunFit[d] * open;
+        }
         openness /= (float)BakeHemiDirs.Num();
         BakeSky[idx] = FMath::Clamp(openness, 0.f, 1.f);
+        BakeSunSH[idx] = SunSH;
 
         // Wall permeability
         float sumPerm = 0.f; int32 cnt = 0;
@@ -997,16 +2961,23 @@ void UThermoForgeSubsystem::TickBake()
         if (UThermoForgeFieldAsset* Saved = CreateAndSaveFieldAsset(
             BakeVolume.Get(), BakeDim, BakeCell,
             BakeFieldOriginWS, BakeFrame.Rotator(),
-            BakeSky, BakeWall, BakeIndoor))
+            BakeSky, BakeWall, BakeIndoor, BakeSunSH))
         {
             BakeVolume->Modify();
             BakeVolume->BakedField = Saved;
+            MarkVolumesDirty();
         #if WITH_EDITORONLY_DATA
             BakeVolume->GridPreviewISM->SetVisibility(true);
         #endif
             BakeVolume->BuildHeatPreviewFromField();
             BakeVolume->MarkPackageDirty();
         }
+
+        if (GetDefault<UThermoForgeProjectSettings>()->bExportFieldAfterBake && BakeVolume.IsValid())
+        {
+            TF_DumpFieldToSavedFolder(BakeVolume->GetName(), BakeDim, BakeCell,
+                BakeFieldOriginWS, BakeFrame.Rotator(), BakeSky, BakeWall, BakeIndoor);
+        }
 #endif
         BakeVolume = nullptr;
         StartNextBake(); 
@@ -72,6 +72,43 @@ void AThermoForgeVolume::BeginPlay()
             BakedField = BakedFieldRef.LoadSynchronous();
         }
     }
+    NotifyVolumeChanged();
+}
+
+void AThermoForgeVolume::PostRegisterAllComponents()
+{
+    Super::PostRegisterAllComponents();
+
+    if (RootComponent && !TransformUpdatedHandle.IsValid())
+    {
+        TransformUpdatedHandle = RootComponent->TransformUpdated.AddUObject(this, &AThermoForgeVolume::HandleTransformUpdated);
+    }
+    NotifyVolumeChanged();
+}
+
+void AThermoForgeVolume::PostUnregisterAllComponents()
+{
+    if (RootComponent && TransformUpdatedHandle.IsValid())
+    {
+        RootComponent->TransformUpdated.Remove(TransformUpdatedHandle);
+    }
+    TransformUpdatedHandle.Reset();
+    NotifyVolumeChanged();
+
+    Super::PostUnregisterAllComponents();
+}
+
+void AThermoForgeVolume::HandleTransformUpdated(USceneComponent* /*Component*/, EUpdateTransformFlags /*Flags*/, ETeleportType /*Teleport*/)
+{
+    NotifyVolumeChanged();
+}
+
+void AThermoForgeVolume::NotifyVolumeChanged() const
+{
+    if (UWorld* World = GetWorld())
+    {
+        if (UThermoForgeSubsystem* Sub = World->GetSubsystem<UThermoForgeSubsystem>()) Sub->MarkVolumesDirty();
+    }
 }
 
 void AThermoForgeVolume::SetBakedField(UThermoForgeFieldAsset* Asset)
@@ -84,6 +121,7 @@ void AThermoForgeVolume::SetBakedField(UThermoForgeFieldAsset* Asset)
 #if WITH_EDITOR
     MarkPackageDirty();
 #endif
+    NotifyVolumeChanged();
 }
 
 
@@ -195,6 +233,9 @@ void AThermoForgeVolume::PostEditChangeProperty(FPropertyChangedEvent& E)
     Super::PostEditChangeProperty(E);
     if (!E.Property) return;
 
+    // Box, field, priority or border may have changed the resolve order
+    NotifyVolumeChanged();
+
     const FName N = E.Property->GetFName();
 
     if (N == GET_MEMBER_NAME_CHECKED(AThermoForgeVolume, BoxExtent))
@@ -447,5 +488,6 @@ void AThermoForgeVolume::SetVolumeParameters(
 
     MarkPackageDirty();
 #endif
+    NotifyVolumeChanged();
 }
 
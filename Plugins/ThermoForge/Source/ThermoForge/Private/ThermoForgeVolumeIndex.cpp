@@ -0,0 +1,66 @@
+﻿#include "ThermoForgeVolumeIndex.h"
+#include "ThermoForgeVolume.h"
+#include "ThermoForgeFieldAsset.h"
+
+#include "EngineUtils.h"
+
+void FThermoForgeVolumeIndex::Build(UWorld* World)
+{
+    Nodes.Reset();
+    Hash = 0;
+    if (!World) return;
+
+    for (TActorIterator<AThermoForgeVolume> It(World); It; ++It)
+    {
+        AThermoForgeVolume* Vol = *It;
+        const UThermoForgeFieldAsset* Asset = Vol ? Vol->BakedField : nullptr;
+        if (!Asset || Asset->Dim.X <= 0 || Asset->Dim.Y <= 0 || Asset->Dim.Z <= 0) continue;
+
+        FThermoVolumeNode& N = Nodes.AddDefaulted_GetRef();
+        N.Volume         = Vol;
+        N.ActorTransform = Vol->GetActorTransform();
+        N.BoxExtent      = Vol->BoxExtent;
+        N.bUnbounded     = Vol->bUnbounded;
+        N.WorldBox       = N.bUnbounded ? Vol->GetWorldBounds() : FBox(-N.BoxExtent, N.BoxExtent).TransformBy(N.ActorTransform);
+        N.Priority       = Vol->Priority;
+        N.CellSizeCm     = Asset->CellSizeCm;
+        N.BlendBorderCm  = FMath::Max(0.f, Vol->BlendBorderCm);
+    }
+
+    Nodes.Sort([](const FThermoVolumeNode& A, const FThermoVolumeNode& B)
+    {
+        if (A.Priority != B.Priority)     return A.Priority > B.Priority;
+        if (A.bUnbounded != B.bUnbounded) return B.bUnbounded;
+        if (A.CellSizeCm != B.CellSizeCm) return A.CellSizeCm < B.CellSizeCm;
+        const double VA = A.BoxExtent.X * A.BoxExtent.Y * A.BoxExtent.Z;
+        const double VB = B.BoxExtent.X * B.BoxExtent.Y * B.BoxExtent.Z;
+        if (VA != VB) return VA < VB;
+        return GetNameSafe(A.Volume.Get()) < GetNameSafe(B.Volume.Get());
+    });
+
+    for (const FThermoVolumeNode& N : Nodes)
+    {
+        const AThermoForgeVolume* Vol = N.Volume.Get();
+        const FTransform& T = N.ActorTransform;
+        Hash = HashCombineFast(Hash, HashCombineFast(GetTypeHash(Vol), GetTypeHash(Vol->BakedField)));
+        Hash = HashCombineFast(Hash, HashCombineFast(GetTypeHash(T.GetLocation()), GetTypeHash(T.GetRotation().Euler())));
+        Hash = HashCombineFast(Hash, HashCombineFast(GetTypeHash(T.GetScale3D()), GetTypeHash(N.BoxExtent)));
+        Hash = HashCombineFast(Hash, HashCombineFast(GetTypeHash(N.bUnbounded), GetTypeHash(N.Priority)));
+        Hash = HashCombineFast(Hash, GetTypeHash(N.BlendBorderCm));
+    }
+}
+
+int32 FThermoForgeVolumeIndex::Find(const AThermoForgeVolume* Vol) const
+{
+    if (!Vol) return INDEX_NONE;
+    return Nodes.IndexOfByPredicate([Vol](const FThermoVolumeNode& N){ return N.Volume.Get() == Vol; });
+}
+
+int32 FThermoForgeVolumeIndex::NextContaining(const FVector& P, int32 After) const
+{
+    for (int32 n=FMath::Max(0, After + 1); n<Nodes.Num(); ++n)
+    {
+        if (Nodes[n].Volume.IsValid() && Nodes[n].Contains(P)) return n;
+    }
+    return INDEX_NONE;
+}
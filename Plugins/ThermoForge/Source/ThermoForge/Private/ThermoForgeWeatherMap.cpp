@@ -0,0 +1,154 @@
+﻿#include "ThermoForgeWeatherMap.h"
+
+void FThermoForgeWeatherMap::Init(const FParams& InParams, float BaselineCloud01)
+{
+    Params = InParams;
+    Params.Resolution = FMath::Clamp(InParams.Resolution, 2, 1024);
+    Params.CellSizeCm = FMath::Max(100.f, InParams.CellSizeCm);
+    MinWS = Params.CenterWS - FVector2D(0.5 * Params.Resolution * Params.CellSizeCm);
+
+    Baseline[Cloud]  = FMath::Clamp(BaselineCloud01, 0.f, 1.f);
+    Baseline[Precip] = 0.f;
+    Baseline[Chill]  = 0.f;
+
+    const int32 N = Params.Resolution * Params.Resolution;
+    for (int32 c=0; c<NumChannels; ++c) Channels[c].Init(Baseline[c], N);
+    Scratch.SetNumUninitialized(N);
+    ++Revision;
+}
+
+bool FThermoForgeWeatherMap::IsValidFor(const FParams& InParams) const
+{
+    return Channels[Cloud].Num() > 0
+        && Params.Resolution == FMath::Clamp(InParams.Resolution, 2, 1024)
+        && Params.CellSizeCm == FMath::Max(100.f, InParams.CellSizeCm)
+        && Params.CenterWS == InParams.CenterWS;
+}
+
+void FThermoForgeWeatherMap::SetResponse(float InSolarGainScaleC, float InPrecipCoolingC)
+{
+    SolarGainScaleC = InSolarGainScaleC;
+    PrecipCoolingC  = InPrecipCoolingC;
+}
+
+void FThermoForgeWeatherMap::Advect(float DeltaSeconds, const FVector2D& WindCmPerSec, float RelaxSeconds, float BaselineCloud01)
+{
+    const int32 R = Params.Resolution;
+    if (Channels[Cloud].Num() != R * R || DeltaSeconds <= 0.f) return;
+
+    Baseline[Cloud] = FMath::Clamp(BaselineCloud01, 0.f, 1.f);
+
+    // Each cell reads the point the wind carried to it; with a uniform wind that is the same offset everywhere
+    const FVector2D Back = -WindCmPerSec * DeltaSeconds / Params.CellSizeCm;
+    const int32 ox = FMath::FloorToInt(Back.X), oy = FMath::FloorToInt(Back.Y);
+    const float fx = float(Back.X - ox), fy = float(Back.Y - oy);
+    const float W00 = (1.f - fx) * (1.f - fy), W10 = fx * (1.f - fy), W01 = (1.f - fx) * fy, W11 = fx * fy;
+
+    const float Relax = RelaxSeconds > 0.f ? 1.f - FMath::Exp(-DeltaSeconds / RelaxSeconds) : 0.f;
+
+    for (int32 c=0; c<NumChannels; ++c)
+    {
+        const float* Src = Channels[c].GetData();
+        const float  B   = Baseline[c];
+        auto At = [Src, R, B](int32 x, int32 y)
+        {
+            return (x >= 0 && y >= 0 && x < R && y < R) ? Src[y * R + x] : B;
+        };
+
+        for (int32 y=0; y<R; ++y)
+        {
+            const int32 y0 = y + oy, y1 = y0 + 1;
+            float* Out = Scratch.GetData() + y * R;
+
+            // Interior span reads in-bounds rows and columns only, so it runs without per-cell checks
+            const bool bRowsIn = y0 >= 0 && y1 < R;
+            const int32 xLo = FMath::Clamp(-ox, 0, R), xHi = FMath::Clamp(R - 1 - ox, xLo, R);
+            if (bRowsIn)
+            {
+                const float* S0 = Src + y0 * R;
+                const float* S1 = Src + y1 * R;
+                for (int32 x=xLo; x<xHi; ++x)
+                {
+                    const int32 x0 = x + ox;
+                    Out[x] = W00 * S0[x0] + W10 * S0[x0 + 1] + W01 * S1[x0] + W11 * S1[x0 + 1];
+                }
+            }
+            for (int32 x=0; x<R; ++x)
+            {
+                if (bRowsIn && x >= xLo && x < xHi) { x = xHi - 1; continue; }
+                const int32 x0 = x + ox;
+                Out[x] = W00 * At(x0, y0) + W10 * At(x0 + 1, y0) + W01 * At(x0, y1) + W11 * At(x0 + 1, y1);
+            }
+        }
+
+        float* Dst = Channels[c].GetData();
+        for (int32 i=0; i<R * R; ++i) Dst[i] = Scratch[i] + (B - Scratch[i]) * Relax;
+    }
+    ++Revision;
+}
+
+void FThermoForgeWeatherMap::AddSystem(const FVector& CenterWS, float RadiusCm, const FSample& Peak)
+{
+    const int32 R = Params.Resolution;
+    if (Channels[Cloud].Num() != R * R || RadiusCm <= 0.f) return;
+
+    const float Target[NumChannels] = { FMath::Clamp(Peak.Cloud01, 0.f, 1.f), FMath::Clamp(Peak.Precip01, 0.f, 1.f), Peak.WindChillC };
+
+    const FVector2D C = (FVector2D(CenterWS) - MinWS) / Params.CellSizeCm - FVector2D(0.5);
+    const float Rc = RadiusCm / Params.CellSizeCm;
+    const int32 x0 = FMath::Max(0, FMath::FloorToInt(C.X - Rc)), x1 = FMath::Min(R - 1, FMath::CeilToInt(C.X + Rc));
+    const int32 y0 = FMath::Max(0, FMath::FloorToInt(C.Y - Rc)), y1 = FMath::Min(R - 1, FMath::CeilToInt(C.Y + Rc));
+
+    for (int32 y=y0; y<=y1; ++y)
+    for (int32 x=x0; x<=x1; ++x)
+    {
+        const float d2 = float(FVector2D::DistSquared(FVector2D(double(x), double(y)), C)) / (Rc * Rc);
+        if (d2 >= 1.f) continue;
+
+        // Smooth falloff: full strength in the eye, untouched at the rim
+        const float W = FMath::Square(1.f - d2);
+        const int32 i = Index(x, y);
+        for (int32 c=0; c<NumChannels; ++c) Channels[c][i] = FMath::Lerp(Channels[c][i], Target[c], W);
+    }
+    ++Revision;
+}
+
+bool FThermoForgeWeatherMap::Sample(const FVector& P, FSample& Out) const
+{
+    Out.Cloud01    = Baseline[Cloud];
+    Out.Precip01   = Baseline[Precip];
+    Out.WindChillC = Baseline[Chill];
+
+    const int32 R = Params.Resolution;
+    if (Channels[Cloud].Num() != R * R) return false;
+
+    // Cell-centre space, clamped within half a cell of the border
+    const FVector2D G = (FVector2D(P) - MinWS) / Params.CellSizeCm - FVector2D(0.5);
+    if (G.X < -0.5 || G.Y < -0.5 || G.X > R - 0.5 || G.Y > R - 0.5) return false;
+
+    const double cx = FMath::Clamp(G.X, 0.0, double(R - 1)), cy = FMath::Clamp(G.Y, 0.0, double(R - 1));
+    const int32 x0 = FMath::Min(FMath::FloorToInt(cx), R - 2), y0 = FMath::Min(FMath::FloorToInt(cy), R - 2);
+    const float ax = float(cx - x0), ay = float(cy - y0);
+
+    float V[NumChannels];
+    for (int32 c=0; c<NumChannels; ++c)
+    {
+        const TArray<float>& A = Channels[c];
+        V[c] = FMath::Lerp(FMath::Lerp(A[Index(x0, y0)],     A[Index(x0 + 1, y0)],     ax),
+                           FMath::Lerp(A[Index(x0, y0 + 1)], A[Index(x0 + 1, y0 + 1)], ax), ay);
+    }
+    Out.Cloud01    = V[Cloud];
+    Out.Precip01   = V[Precip];
+    Out.WindChillC = V[Chill];
+    return true;
+}
+
+float FThermoForgeWeatherMap::TemperatureOffsetC(const FVector& P, float SolarSky01, float GlobalWeather01) const
+{
+    FSample W;
+    if (!Sample(P, W)) return 0.f;
+
+    return SolarGainScaleC * SolarSky01 * (FMath::Clamp(GlobalWeather01, 0.f, 1.f) - W.Cloud01)
+         - W.WindChillC
+         - PrecipCoolingC * W.Precip01;
+}
@@ -0,0 +1,398 @@
+﻿#include "ThermoForgeZones.h"
+#include "ThermoForgeComposedGrid.h"
+
+void FThermoForgeZoneMap::Configure(float InThresholdC, bool bInAbove)
+{
+    if (InThresholdC != ThresholdC || bInAbove != bAbove)
+    {
+        ThresholdC = InThresholdC;
+        bAbove     = bInAbove;
+        SeenStamp  = 0; // full pass on next Update
+    }
+}
+
+void FThermoForgeZoneMap::Reset(const FThermoForgeComposedGrid& Grid)
+{
+    Dim        = Grid.GetDim();
+    BrickDim   = Grid.GetBrickDim();
+    CellSizeCm = Grid.GetCellSizeCm();
+    Frame      = Grid.GetFrame();
+    InvFrame   = Frame.Inverse();
+
+    const int32 N = Dim.X * Dim.Y * Dim.Z;
+    Mask.Init(false, N);
+    Labels.Init(0, N);
+    Zones.Reset();
+    FreeIds.Reset();
+    BrickZones.Reset();
+    BrickZones.SetNum(BrickDim.X * BrickDim.Y * BrickDim.Z);
+    BrickVertices.Reset();
+    BrickVertices.SetNum(BrickDim.X * BrickDim.Y * BrickDim.Z);
+}
+
+int32 FThermoForgeZoneMap::BrickOfCell(int32 i) const
+{
+    constexpr int32 B = FThermoForgeComposedGrid::BrickSize;
+    const int32 x = i % Dim.X, y = (i / Dim.X) % Dim.Y, z = i / (Dim.X * Dim.Y);
+    return BrickIndex(x / B, y / B, z / B);
+}
+
+bool FThermoForgeZoneMap::Update(const FThermoForgeComposedGrid& Grid)
+{
+    const TArray<float>& TempC = Grid.GetTempC();
+    const FIntVector GD = Grid.GetDim();
+    const int32 N = GD.X * GD.Y * GD.Z;
+    if (N <= 0 || TempC.Num() != N)
+    {
+        const bool bHad = Zones.Num() > 0 || Mask.Num() > 0;
+        Dim = FIntVector::ZeroValue;
+        Mask.Empty(); Labels.Empty(); Zones.Empty(); FreeIds.Empty(); BrickZones.Empty(); BrickVertices.Empty();
+        return bHad;
+    }
+
+    const bool bFull = SeenStamp == 0 || GD != Dim || Grid.GetBrickDim() != BrickDim || !Grid.GetFrame().Equals(Frame)
+                    || Grid.GetCellSizeCm() != CellSizeCm || Mask.Num() != N;
+    if (bFull) Reset(Grid);
+    if (!bFull && Grid.GetTempStamp() == SeenStamp) return false;
+
+    constexpr int32 B = FThermoForgeComposedGrid::BrickSize;
+    const int32 NB = BrickDim.X * BrickDim.Y * BrickDim.Z;
+
+    // 1) Mask in changed bricks; a changed brick also invalidates the cubes of its lower neighbours
+    TArray<int32> Flipped;
+    TBitArray<> StatsDirty(false, NB);
+    TBitArray<> Remesh(false, NB);
+    for (int32 bz=0; bz<BrickDim.Z; ++bz)
+    for (int32 by=0; by<BrickDim.Y; ++by)
+    for (int32 bx=0; bx<BrickDim.X; ++bx)
+    {
+        const int32 Bi = BrickIndex(bx, by, bz);
+        if (!bFull && Grid.GetBrickTempStamp(Bi) <= SeenStamp) continue;
+        StatsDirty[Bi] = true;
+
+        for (int32 z=bz*B; z<FMath::Min((bz+1)*B, Dim.Z); ++z)
+        for (int32 y=by*B; y<FMath::Min((by+1)*B, Dim.Y); ++y)
+        for (int32 x=bx*B; x<FMath::Min((bx+1)*B, Dim.X); ++x)
+        {
+            const int32 i = Index(x,y,z);
+            const bool bIn = Inside(TempC[i]);
+            if (bIn != Mask[i])
+            {
+                Mask[i] = bIn;
+                if (!bFull) Flipped.Add(i);
+            }
+        }
+
+        for (int32 dz=-1; dz<=0; ++dz)
+        for (int32 dy=-1; dy<=0; ++dy)
+        for (int32 dx=-1; dx<=0; ++dx)
+        {
+            const int32 nx = bx+dx, ny = by+dy, nz = bz+dz;
+            if (nx >= 0 && ny >= 0 && nz >= 0) Remesh[BrickIndex(nx, ny, nz)] = true;
+        }
+    }
+    SeenStamp = FMath::Max(1u, Grid.GetTempStamp());
+
+    // 2) Labels only around cells that crossed; brick stats for changed or relabelled bricks
+    if (bFull)                  RelabelAll();
+    else if (Flipped.Num() > 0) RelabelAround(Flipped, StatsDirty);
+
+    for (TConstSetBitIterator<> It(StatsDirty); It; ++It)
+    {
+        RebuildBrickStats(It.GetIndex(), TempC);
+    }
+    SumZoneStats();
+
+    // 3) Isosurface for touched bricks
+    for (TConstSetBitIterator<> It(Remesh); It; ++It)
+    {
+        const int32 Bi = It.GetIndex();
+        RemeshBrick(Bi % BrickDim.X, (Bi / BrickDim.X) % BrickDim.Y, Bi / (BrickDim.X * BrickDim.Y), TempC);
+    }
+    return true;
+}
+
+void FThermoForgeZoneMap::Flood(int32 Seed, int32 Id, TArray<int32>& Stack, TBitArray<>* OutBricks)
+{
+    // 6-connected
+    Labels[Seed] = Id;
+    Stack.Reset();
+    Stack.Add(Seed);
+
+    while (Stack.Num() > 0)
+    {
+        const int32 i = Stack.Pop(EAllowShrinking::No);
+        const int32 x = i % Dim.X, y = (i / Dim.X) % Dim.Y, z = i / (Dim.X * Dim.Y);
+        if (OutBricks) (*OutBricks)[BrickOfCell(i)] = true;
+
+        auto Visit = [&](int32 nx, int32 ny, int32 nz)
+        {
+            if (nx < 0 || ny < 0 || nz < 0 || nx >= Dim.X || ny >= Dim.Y || nz >= Dim.Z) return;
+            const int32 j = Index(nx, ny, nz);
+            if (Mask[j] && Labels[j] == 0)
+            {
+                Labels[j] = Id;
+                Stack.Add(j);
+            }
+        };
+        Visit(x-1,y,z); Visit(x+1,y,z);
+        Visit(x,y-1,z); Visit(x,y+1,z);
+        Visit(x,y,z-1); Visit(x,y,z+1);
+    }
+}
+
+void FThermoForgeZoneMap::RelabelAll()
+{
+    const int32 N = Mask.Num();
+    Labels.Init(0, N);
+    Zones.Reset();
+    FreeIds.Reset();
+
+    TArray<int32> Stack;
+    for (int32 Seed=0; Seed<N; ++Seed)
+    {
+        if (!Mask[Seed] || Labels[Seed] != 0) continue;
+        Zones.AddDefaulted();
+        Flood(Seed, Zones.Num(), Stack, nullptr);
+    }
+}
+
+void FThermoForgeZoneMap::RelabelAround(TConstArrayView<int32> Flipped, TBitArray<>& OutBricks)
+{
+    // Only zones that contain or border a flipped cell can merge, split or vanish
+    TBitArray<> Affected(false, Zones.Num() + 1);
+    TArray<int32> Seeds;
+    for (const int32 i : Flipped)
+    {
+        const int32 x = i % Dim.X, y = (i / Dim.X) % Dim.Y, z = i / (Dim.X * Dim.Y);
+        auto Touch = [&](int32 nx, int32 ny, int32 nz)
+        {
+            if (nx < 0 || ny < 0 || nz < 0 || nx >= Dim.X || ny >= Dim.Y || nz >= Dim.Z) return;
+            Affected[Labels[Index(nx, ny, nz)]] = true;
+        };
+        Touch(x,y,z);
+        Touch(x-1,y,z); Touch(x+1,y,z);
+        Touch(x,y-1,z); Touch(x,y+1,z);
+        Touch(x,y,z-1); Touch(x,y,z+1);
+        if (Mask[i]) Seeds.Add(i);
+    }
+    Affected[0] = false;
+
+    // Unlabel the affected zones in the bricks that hold them; their masked cells reseed the fill
+    constexpr int32 B = FThermoForgeComposedGrid::BrickSize;
+    for (int32 Bi=0; Bi<BrickZones.Num(); ++Bi)
+    {
+        if (!BrickZones[Bi].ContainsByPredicate([&](const FBrickZone& E) { return Affected[E.Id]; })) continue;
+        OutBricks[Bi] = true;
+
+        const int32 bx = Bi % BrickDim.X, by = (Bi / BrickDim.X) % BrickDim.Y, bz = Bi / (BrickDim.X * BrickDim.Y);
+        for (int32 z=bz*B; z<FMath::Min((bz+1)*B, Dim.Z); ++z)
+        for (int32 y=by*B; y<FMath::Min((by+1)*B, Dim.Y); ++y)
+        for (int32 x=bx*B; x<FMath::Min((bx+1)*B, Dim.X); ++x)
+        {
+            const int32 i = Index(x,y,z);
+            if (!Affected[Labels[i]]) continue;
+            Labels[i] = 0;
+            if (Mask[i]) Seeds.Add(i);
+        }
+    }
+
+    for (TConstSetBitIterator<> It(Affected); It; ++It)
+    {
+        Zones[It.GetIndex() - 1] = FZone();
+        FreeIds.Add(It.GetIndex());
+    }
+    FreeIds.Sort(TGreater<int32>()); // Pop() hands out the lowest free id
+
+    TArray<int32> Stack;
+    for (const int32 Seed : Seeds)
+    {
+        if (!Mask[Seed] || Labels[Seed] != 0) continue;
+
+        int32 Id;
+        if (FreeIds.Num() > 0)
+        {
+            Id = FreeIds.Pop(EAllowShrinking::No);
+        }
+        else
+        {
+            Zones.AddDefaulted();
+            Id = Zones.Num();
+        }
+        Flood(Seed, Id, Stack, &OutBricks);
+    }
+}
+
+static void TF_AccumulateZone(FThermoForgeZoneMap::FZone& Z, const FThermoForgeZoneMap::FZone& Part, bool bAbove)
+{
+    if (Part.NumCells <= 0) return;
+    Z.PeakC = (Z.NumCells == 0) ? Part.PeakC : (bAbove ? FMath::Max(Z.PeakC, Part.PeakC) : FMath::Min(Z.PeakC, Part.PeakC));
+    Z.SumC += Part.SumC;
+    Z.NumCells += Part.NumCells;
+    Z.MinCell = FIntVector(FMath::Min(Z.MinCell.X, Part.MinCell.X), FMath::Min(Z.MinCell.Y, Part.MinCell.Y), FMath::Min(Z.MinCell.Z, Part.MinCell.Z));
+    Z.MaxCell = FIntVector(FMath::Max(Z.MaxCell.X, Part.MaxCell.X), FMath::Max(Z.MaxCell.Y, Part.MaxCell.Y), FMath::Max(Z.MaxCell.Z, Part.MaxCell.Z));
+}
+
+void FThermoForgeZoneMap::RebuildBrickStats(int32 Bi, const TArray<float>& TempC)
+{
+    constexpr int32 B = FThermoForgeComposedGrid::BrickSize;
+    TArray<FBrickZone, TInlineAllocator<2>>& Parts = BrickZones[Bi];
+    Parts.Reset();
+
+    const int32 bx = Bi % BrickDim.X, by = (Bi / BrickDim.X) % BrickDim.Y, bz = Bi / (BrickDim.X * BrickDim.Y);
+    for (int32 z=bz*B; z<FMath::Min((bz+1)*B, Dim.Z); ++z)
+    for (int32 y=by*B; y<FMath::Min((by+1)*B, Dim.Y); ++y)
+    for (int32 x=bx*B; x<FMath::Min((bx+1)*B, Dim.X); ++x)
+    {
+        const int32 i = Index(x,y,z);
+        const int32 Id = Labels[i];
+        if (Id <= 0) continue;
+
+        FBrickZone* Part = Parts.FindByPredicate([Id](const FBrickZone& E) { return E.Id == Id; });
+        if (!Part)
+        {
+            Part = &Parts.AddDefaulted_GetRef();
+            Part->Id = Id;
+        }
+
+        FZone Cell;
+        Cell.MinCell = Cell.MaxCell = FIntVector(x, y, z);
+        Cell.NumCells = 1;
+        Cell.PeakC = TempC[i];
+        Cell.SumC  = TempC[i];
+        TF_AccumulateZone(Part->Stats, Cell, bAbove);
+    }
+}
+
+void FThermoForgeZoneMap::SumZoneStats()
+{
+    // Brick partials are few per brick, so this stays well below a cell scan
+    for (FZone& Z : Zones) Z = FZone();
+    for (const TArray<FBrickZone, TInlineAllocator<2>>& Parts : BrickZones)
+    {
+        for (const FBrickZone& E : Parts)
+        {
+            TF_AccumulateZone(Zones[E.Id - 1], E.Stats, bAbove);
+        }
+    }
+}
+
+// Cube corners (x,y,z bits) and the six tetrahedra around the 0–6 diagonal
+static const FIntVector TF_CubeCorner[8] =
+{
+    {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}, {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1}
+};
+static const int32 TF_CubeTets[6][4] =
+{
+    {0,5,1,6}, {0,1,2,6}, {0,2,3,6}, {0,3,7,6}, {0,7,4,6}, {0,4,5,6}
+};
+
+void FThermoForgeZoneMap::RemeshBrick(int32 bx, int32 by, int32 bz, const TArray<float>& TempC)
+{
+    constexpr int32 B = FThermoForgeComposedGrid::BrickSize;
+    TArray<FVector>& Out = BrickVertices[BrickIndex(bx, by, bz)];
+    Out.Reset();
+
+    // Cubes span cell centers (x..x+1), so the last layer of cells starts no cube
+    for (int32 z=bz*B; z<FMath::Min((bz+1)*B, Dim.Z-1); ++z)
+    for (int32 y=by*B; y<FMath::Min((by+1)*B, Dim.Y-1); ++y)
+    for (int32 x=bx*B; x<FMath::Min((bx+1)*B, Dim.X-1); ++x)
+    {
+        // Signed distance to the iso level, positive inside
+        float   F[8];
+        FVector P[8];
+        int32   NumIn = 0;
+        for (int32 c=0; c<8; ++c)
+        {
+            const FIntVector& o = TF_CubeCorner[c];
+            const float T = TempC[Index(x+o.X, y+o.Y, z+o.Z)];
+            F[c] = bAbove ? (T - ThresholdC) : (ThresholdC - T);
+            P[c] = FVector((x + o.X + 0.5f) * CellSizeCm, (y + o.Y + 0.5f) * CellSizeCm, (z + o.Z + 0.5f) * CellSizeCm);
+            NumIn += (F[c] >= 0.f) ? 1 : 0;
+        }
+        if (NumIn == 0 || NumIn == 8) continue;
+
+        for (const int32 (&Tet)[4] : TF_CubeTets)
+        {
+            int32 In[4], OutV[4], NIn = 0, NOut = 0;
+            for (int32 k=0; k<4; ++k)
+            {
+                if (F[Tet[k]] >= 0.f) In[NIn++] = Tet[k];
+                else                  OutV[NOut++] = Tet[k];
+            }
+            if (NIn == 0 || NOut == 0) continue;
+
+            auto Cut = [&](int32 a, int32 b)
+            {
+                const float t = F[a] / (F[a] - F[b]);
+                return FMath::Lerp(P[a], P[b], t);
+            };
+
+            // Inside → outside direction to orient triangles outward
+            FVector CIn = FVector::ZeroVector, COut = FVector::ZeroVector;
+            for (int32 k=0; k<NIn;  ++k) CIn  += P[In[k]];
+            for (int32 k=0; k<NOut; ++k) COut += P[OutV[k]];
+            const FVector Outward = COut / NOut - CIn / NIn;
+
+            auto Emit = [&](const FVector& A, const FVector& Bv, const FVector& C)
+            {
+                const bool bFlip = FVector::DotProduct(FVector::CrossProduct(Bv - A, C - A), Outward) < 0.f;
+                Out.Add(Frame.TransformPosition(A));
+                Out.Add(Frame.TransformPosition(bFlip ? C : Bv));
+                Out.Add(Frame.TransformPosition(bFlip ? Bv : C));
+            };
+
+            if (NIn == 1)
+            {
+                Emit(Cut(In[0], OutV[0]), Cut(In[0], OutV[1]), Cut(In[0], OutV[2]));
+            }
+            else if (NIn == 3)
+            {
+                Emit(Cut(In[0], OutV[0]), Cut(In[1], OutV[0]), Cut(In[2], OutV[0]));
+            }
+            else
+            {
+                // Quad between the two pairs
+                const FVector Q0 = Cut(In[0], OutV[0]), Q1 = Cut(In[0], OutV[1]);
+                const FVector Q2 = Cut(In[1], OutV[1]), Q3 = Cut(In[1], OutV[0]);
+                Emit(Q0, Q1, Q2);
+                Emit(Q0, Q2, Q3);
+            }
+        }
+    }
+}
+
+int32 FThermoForgeZoneMap::ZoneAt(const FVector& WorldPos) const
+{
+    if (Labels.Num() == 0 || CellSizeCm <= 0.f) return 0;
+
+    const FVector L = InvFrame.TransformPosition(WorldPos) / CellSizeCm;
+    const int32 x = FMath::FloorToInt(L.X), y = FMath::FloorToInt(L.Y), z = FMath::FloorToInt(L.Z);
+    if (x < 0 || y < 0 || z < 0 || x >= Dim.X || y >= Dim.Y || z >= Dim.Z) return 0;
+    return Labels[Index(x,y,z)];
+}
+
+bool FThermoForgeZoneMap::GetZoneInfo(int32 ZoneId, FThermoZoneInfo& Out) const
+{
+    if (!Zones.IsValidIndex(ZoneId - 1)) return false;
+    const FZone& Z = Zones[ZoneId - 1];
+    if (Z.NumCells <= 0) return false;
+
+    Out.ZoneId   = ZoneId;
+    Out.NumCells = Z.NumCells;
+    Out.VolumeM3 = float(double(Z.NumCells) * FMath::Cube(double(CellSizeCm)) * 1e-6);
+    Out.PeakC    = Z.PeakC;
+    Out.MeanC    = float(Z.SumC / Z.NumCells);
+    Out.BoundsWS = FBox(FVector(Z.MinCell) * CellSizeCm, FVector(Z.MaxCell + FIntVector(1)) * CellSizeCm).TransformBy(Frame);
+    return true;
+}
+
+void FThermoForgeZoneMap::AppendMesh(TArray<FVector>& OutVertices, TArray<int32>& OutTriangles) const
+{
+    for (const TArray<FVector>& V : BrickVertices)
+    {
+        const int32 Base = OutVertices.Num();
+        OutVertices.Append(V);
+        for (int32 i=0; i<V.Num(); ++i) OutTriangles.Add(Base + i);
+    }
+}
@@ -49,6 +49,10 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Config, Category="Thermal|Occlusion", meta=(EditCondition="bUseLineOfSight", ClampMin="1", ClampMax="16"))
     int32 LoSSteps = 8;
 
+    /** Probe along the analytic temperature gradient (2 samples) instead of two full rings; rings remain the fallback where it is flat. */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Config, Category="Thermal|Probe")
+    bool bUseGradientProbe = true;
+
     /** Update cadence per LOD ring (seconds). */
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Config, Category="Thermal|Update", meta=(ClampMin="0.01"))
     float NearUpdate = 0.10f;
@@ -4,6 +4,7 @@
 #include "Perception/AISense.h"
 #include "Perception/AISenseEvent.h"
 #include "Perception/AIPerceptionTypes.h"
+#include "ThermoForgeQueryCursor.h"
 #include "AISense_Thermal.generated.h"
 
 class UAISense_Thermal;
@@ -81,4 +82,7 @@ private:
     /** Active listener components having this sense enabled. */
     UPROPERTY(Transient)
     TArray<TWeakObjectPtr<UAIPerceptionComponent>> ListenerComps;
+
+    /** One lookup cursor per ring sample slot; the rings move with the listener, so each slot drifts slowly. */
+    TMap<TWeakObjectPtr<UAIPerceptionComponent>, TArray<FThermoQueryCursor>> ListenerCursors;
 };
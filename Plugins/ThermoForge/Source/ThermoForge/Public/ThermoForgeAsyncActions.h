@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "ThermoForgeSubsystem.h"
+#include "ThermoForgeAsyncActions.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FThermoAsyncTemperatureDone, float, TemperatureC);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FThermoAsyncExtremeDone, const FThermoForgeGridHit&, Hit);
+
+/**
+ * Latent "Compute Temperature (Async)": runs on a worker against the current snapshot,
+ * Completed fires on the game thread.
+ */
+UCLASS()
+class THERMOFORGE_API UThermoForgeAsyncTemperature : public UBlueprintAsyncActionBase
+{
+    GENERATED_BODY()
+public:
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Async",
+        meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject", DisplayName="Compute Temperature (Async)"))
+    static UThermoForgeAsyncTemperature* ComputeTemperatureAsync(UObject* WorldContextObject, FVector WorldPos);
+
+    UPROPERTY(BlueprintAssignable)
+    FThermoAsyncTemperatureDone Completed;
+
+    virtual void Activate() override;
+
+private:
+    TWeakObjectPtr<UWorld> World;
+    FVector WorldPos = FVector::ZeroVector;
+};
+
+/**
+ * Latent "Find Baked Extreme Near (Async)": hierarchical search on a worker,
+ * Found / NotFound fire on the game thread.
+ */
+UCLASS()
+class THERMOFORGE_API UThermoForgeAsyncExtreme : public UBlueprintAsyncActionBase
+{
+    GENERATED_BODY()
+public:
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Async",
+        meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject", DisplayName="Find Baked Extreme Near (Async)"))
+    static UThermoForgeAsyncExtreme* FindBakedExtremeNearAsync(UObject* WorldContextObject, FVector CenterWS, float RadiusCm, bool bHottest);
+
+    UPROPERTY(BlueprintAssignable)
+    FThermoAsyncExtremeDone Found;
+
+    UPROPERTY(BlueprintAssignable)
+    FThermoAsyncExtremeDone NotFound;
+
+    virtual void Activate() override;
+
+private:
+    TWeakObjectPtr<UWorld> World;
+    FVector CenterWS = FVector::ZeroVector;
+    float   RadiusCm = 0.f;
+    bool    bHottest = true;
+};
@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UThermoForgeFieldAsset;
+class UPrimitiveComponent;
+
+/** One baked cell under a dynamic blocker, with its WallPermeability01 traced in the blocker's open state. */
+struct FThermoBlockerCell
+{
+    TWeakObjectPtr<const UThermoForgeFieldAsset> Field;
+    FIntVector Cell = FIntVector::ZeroValue;
+    int32      LinearIndex = INDEX_NONE;
+    FVector    CenterWS = FVector::ZeroVector;
+    float      CellSizeCm = 0.f;
+    float      OpenPerm01 = 1.f;
+};
+
+/**
+ * Geometry that opens or disappears at runtime (a door, a destructible wall). The baked WallPermeability01
+ * is its closed state; its open state is re-traced per cell with the blocker ignored, and cells take
+ *   Perm = Baked + Σ Open01 · (OpenPerm - Baked)
+ * over every blocker covering them. The result lives in the subsystem's FThermoPermOverrideLayer, never in the asset.
+ */
+struct FThermoDynamicBlocker
+{
+    /** Ignored while tracing the open state; null for box-only blockers (geometry already gone). */
+    TWeakObjectPtr<UPrimitiveComponent> Component;
+    FBox  BoundsWS = FBox(ForceInit);
+    float Open01 = 1.f;
+
+    TArray<FThermoBlockerCell> Cells;
+    /** Cells [0, NumTraced) carry OpenPerm01. */
+    int32 NumTraced = 0;
+
+    /** Open01 currently folded into the override layers; the blocker only counts once every cell is traced. */
+    float AppliedOpen01 = 0.f;
+    bool  bApplied = false;
+
+    bool IsTraced() const { return NumTraced >= Cells.Num(); }
+};
+
+/** A baked cell some blocker overrides: its baked value and the summed departure from it. */
+struct FThermoPermOverrideCell
+{
+    float BakedPerm01 = 0.f;
+    float Delta = 0.f;
+    int32 NumBlockers = 0;
+
+    float GetPerm01() const { return FMath::Clamp(BakedPerm01 + Delta, 0.f, 1.f); }
+};
+
+/**
+ * One world's runtime WallPermeability01 for the cells of one field that blockers cover. Field assets are
+ * shared by the editor and every PIE world, so the bake is never written; the subsystem hands this layer to
+ * its composed, diffusion and fixed-point grids and applies it to snapshot copies.
+ */
+struct FThermoPermOverrideLayer
+{
+    /** Linear cell -> override. */
+    TMap<int32, FThermoPermOverrideCell> Cells;
+
+    /** Overridden permeability of Linear, or Baked when no blocker covers it. */
+    FORCEINLINE float GetWallPerm(int32 Linear, float Baked) const
+    {
+        const FThermoPermOverrideCell* O = Cells.Find(Linear);
+        return O ? O->GetPerm01() : Baked;
+    }
+};
@@ -0,0 +1,79 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ThermoForgeFieldAsset.h" // FThermoBakedTempModel
+#include "ThermoForgeClimate.generated.h"
+
+/** Where the climate clock takes its time from. */
+UENUM(BlueprintType)
+enum class EThermoClockMode : uint8
+{
+    SystemUtc UMETA(DisplayName="System UTC"),
+    GameTime  UMETA(DisplayName="Game Time (scaled)")
+};
+
+/**
+ * One instant of climate, rebuilt once per frame by UThermoForgeSubsystem.
+ * Everything queries need from the climate model is precomputed here:
+ *   Ambient(Z) = AmbientSeaLevelC - LapseCPerCm * (Z - SeaLevelZcm)
+ *   Solar(Sky) = SolarC * Sky
+ * where Sky is the cell's visibility toward SunDirWS when the field has a directional bake, else SkyView01.
+ */
+USTRUCT(BlueprintType)
+struct FThermoClimateState
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Climate")
+    FDateTime TimeUTC = FDateTime(0);
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Climate")
+    float TimeOfDayHours = 12.f;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Climate")
+    int32 DayOfYear = 1;
+
+    /** 0 = winter solstice, 1 = summer solstice. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Climate")
+    float SeasonAlpha01 = 0.f;
+
+    /** 0 clear … 1 overcast. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Climate")
+    float WeatherAlpha01 = 0.f;
+
+    /** Diurnal + seasonal ambient at sea level (°C). */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Climate")
+    float AmbientSeaLevelC = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Climate")
+    float SeaLevelZcm = 0.f;
+
+    /** °C lost per cm of altitude; 0 when lapse is disabled. */
+    float LapseCPerCm = 0.f;
+
+    /** Full-sun gain (°C) already scaled by (1 - WeatherAlpha01). */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Climate")
+    float SolarC = 0.f;
+
+    /** Unit vector toward the sun, held on the horizon at night; zero when directional solar gain is off. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Climate")
+    FVector SunDirWS = FVector::ZeroVector;
+
+    /** Increments every rebuild; lets caches tell whether the climate moved. */
+    uint32 Revision = 0;
+
+    FORCEINLINE float AmbientAtZ(double WorldZcm) const
+    {
+        return AmbientSeaLevelC - LapseCPerCm * float(WorldZcm - SeaLevelZcm);
+    }
+
+    FORCEINLINE FThermoBakedTempModel ToBakedModel() const
+    {
+        FThermoBakedTempModel M;
+        M.AmbientSeaLevelC = AmbientSeaLevelC;
+        M.SeaLevelZcm      = SeaLevelZcm;
+        M.LapseCPerCm      = LapseCPerCm;
+        M.SolarC           = SolarC;
+        return M;
+    }
+};
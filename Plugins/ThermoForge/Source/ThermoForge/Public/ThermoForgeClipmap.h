@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UThermoForgeFieldAsset;
+
+/**
+ * Runtime SkyView01 / WallPermeability01 around a moving centre for unbounded volumes, instead of baking the
+ * whole ±1e6 cm box. Levels are world-aligned rings of Resolution³ cells; level l has cells of
+ * BaseCellSizeCm · 2^l. Storage is toroidal: world cell (x,y,z) lives in slot (x mod R, y mod R, z mod R),
+ * so when a ring scrolls only the newly exposed slabs are recomputed. Each slot remembers the world cell it
+ * holds; a slot is readable only while that matches, so stale data is never sampled. Memory depends on
+ * Levels and Resolution only.
+ */
+class THERMOFORGE_API FThermoForgeClipmap
+{
+public:
+    struct FParams
+    {
+        int32 Levels = 4;
+        /** Cells per axis per level; rounded up to a power of two so slots wrap with a mask. */
+        int32 Resolution = 32;
+        float BaseCellSizeCm = 250.f;
+    };
+
+    /** Computes one cell's channels at its world centre (runtime traces). */
+    using FCellFn = TFunctionRef<void(const FVector& CenterWS, float CellSizeCm, float& OutSky01, float& OutWallPerm01)>;
+
+    void Init(const FParams& InParams);
+    bool IsValidFor(const FParams& InParams) const;
+
+    /** Move every ring so CenterWS sits in its middle (snapped to 2 cells) and queue the exposed cells. */
+    void Recenter(const FVector& CenterWS);
+
+    /**
+     * Fill queued cells, finest level first. Cells covered by Coarse at no finer spacing than the level are
+     * sampled from it for free; the rest call TraceCell, at most TraceBudget times. Returns cells traced.
+     */
+    int32 Fill(int32 TraceBudget, const UThermoForgeFieldAsset* Coarse, FCellFn TraceCell);
+
+    /** Trilinear channels from the finest level whose 8 cells around P are filled; false if none. */
+    bool Sample(const FVector& P, float& OutSky01, float& OutWallPerm01) const;
+
+    int32 GetPendingCells() const;
+
+private:
+    struct FLevel
+    {
+        float      CellSizeCm = 0.f;
+        /** World cell index of the window's min corner. */
+        FIntVector Min = FIntVector::ZeroValue;
+        bool       bPlaced = false;
+
+        TArray<float>      Sky;
+        TArray<float>      Perm;
+        /** World cell held by each slot; X == MIN_int32 while empty. */
+        TArray<FIntVector> Key;
+
+        /** World cells to fill, nearest first; entries that scrolled out are skipped. */
+        TArray<FIntVector> Queue;
+        int32              QueueHead = 0;
+    };
+
+    FORCEINLINE int32 Slot(const FIntVector& C) const
+    {
+        const int32 R = Params.Resolution;
+        return ((C.Z & Mask) * R + (C.Y & Mask)) * R + (C.X & Mask);
+    }
+    FORCEINLINE bool InWindow(const FIntVector& Min, const FIntVector& C) const
+    {
+        return C.X >= Min.X && C.Y >= Min.Y && C.Z >= Min.Z
+            && C.X < Min.X + Params.Resolution && C.Y < Min.Y + Params.Resolution && C.Z < Min.Z + Params.Resolution;
+    }
+
+    FParams Params;
+    int32   Mask = 0;
+    TArray<FLevel> Levels;
+};
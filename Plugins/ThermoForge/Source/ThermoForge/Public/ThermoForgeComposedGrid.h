@@ -0,0 +1,143 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "ThermoForgeClimate.h"
+
+class UThermoForgeFieldAsset;
+class UThermoForgeSourceComponent;
+struct FThermoPermOverrideLayer;
+
+/** A source as seen by one recomposition pass (resolved on the game thread). */
+struct FThermoComposeSource
+{
+    const UThermoForgeSourceComponent* Source = nullptr;
+    FBox    BoundsWS = FBox(ForceInit);
+    FVector LocationWS = FVector::ZeroVector;
+};
+
+/**
+ * Runtime cache of composed temperature per baked cell, same layout as the field.
+ *   SourceC = Σ source(P) * occlusion(P, source) * WallPerm(cell)   (expensive: traces)
+ *   TempC   = Ambient(Z) + SolarC * Sky(cell) + SourceC            (cheap)
+ * Sky is the cell's visibility toward the climate's sun (SkyView01 without a directional bake).
+ * SourceC is recomposed per dirty BrickSize³ brick under a time budget; TempC follows the climate globally.
+ */
+class THERMOFORGE_API FThermoForgeComposedGrid
+{
+public:
+    static constexpr int32 BrickSize = 8;
+
+    using FOcclusionFn = TFunctionRef<float(const FVector& /*From*/, const FVector& /*To*/)>;
+
+    /** Size to the field and mark everything dirty. */
+    void Init(const UThermoForgeFieldAsset* InField);
+
+    /** Still describes this field's grid. */
+    bool IsValidFor(const UThermoForgeFieldAsset* InField) const;
+
+    const UThermoForgeFieldAsset* GetField() const { return Field.Get(); }
+
+    /** Blocker overrides read instead of the baked WallPermeability01; bricks they touch must be marked dirty. */
+    void SetPermOverrides(const TSharedPtr<const FThermoPermOverrideLayer>& InOverrides) { PermOverrides = InOverrides; }
+
+    void MarkAllDirty();
+    void MarkWorldBoxDirty(const FBox& WorldBox);
+    bool HasDirty() const { return NumDirty > 0; }
+    int32 GetNumDirtyBricks() const { return NumDirty; }
+
+    /**
+     * Recompose dirty bricks until FPlatformTime::Seconds() passes DeadlineSeconds (at least one brick per call).
+     * Returns the number of bricks recomposed.
+     */
+    int32 UpdateDirty(const FThermoClimateState& Climate, TConstArrayView<FThermoComposeSource> Sources,
+                      FOcclusionFn Occlusion, double DeadlineSeconds);
+
+    /** Rebuild TempC of clean bricks if the climate moved by more than EpsilonC anywhere in the grid. */
+    void ApplyClimate(const FThermoClimateState& Climate, float EpsilonC);
+
+    /** Trilinear TempC at P; false outside the grid or if any of the 8 cells is dirty. */
+    bool SampleTemp(const FVector& P, float& OutTempC) const;
+
+    /** Trilinear SourceC and Sky toward SunDirWS at P; same validity rules as SampleTemp. */
+    bool SampleSourceAndSky(const FVector& P, const FVector& SunDirWS, float& OutSourceC, float& OutSky01) const;
+
+    /** SampleSourceAndSky plus the world-space derivatives of both (per cm) of the trilinear interpolant. */
+    bool SampleWithGradient(const FVector& P, const FVector& SunDirWS, float& OutSourceC, FVector& OutSourceGrad, float& OutSky01, FVector& OutSkyGrad) const;
+
+    /** Bumped whenever SourceC or the dirty set changes (not on climate-only updates). */
+    uint32 GetRevision() const { return Revision; }
+    const TArray<float>& GetSourceC() const { return SourceC; }
+    const TBitArray<>& GetDirtyBricks() const { return DirtyBricks; }
+    FIntVector GetBrickDim() const { return BrickDim; }
+
+    // Composed temperature, for consumers that derive data from it (zones)
+    const TArray<float>& GetTempC() const { return TempC; }
+    FIntVector GetDim() const { return Dim; }
+    float GetCellSizeCm() const { return CellSizeCm; }
+    const FTransform& GetFrame() const { return Frame; }
+
+    /** Monotonic counter bumped whenever TempC changes; GetBrickTempStamp(B) is its value when brick B last changed. */
+    uint32 GetTempStamp() const { return TempStamp; }
+    uint32 GetBrickTempStamp(int32 Brick) const { return BrickTempStamp[Brick]; }
+
+    /** Changes whenever brick B's SourceC is recomposed (unique per grid over its lifetime). */
+    uint32 GetBrickSourceStamp(int32 Brick) const { return BrickSourceStamp[Brick]; }
+
+    /** SourceC of one brick into BrickSize³ values, brick-local x fastest; cells past the grid edge are zero. */
+    void CopyBrickSourceC(int32 Brick, TArray<float>& Out) const;
+
+    /**
+     * Cell-center trilinear footprint of a grid-local position (cm). Clamps within half a cell of the border,
+     * false outside the grid. OutDW (8 entries, optional) receives each weight's grid-local derivative per cm;
+     * zero along axes that are clamped.
+     */
+    static bool TrilinearCells(const FVector& LocalCm, float CellSizeCm, const FIntVector& Dim,
+                               FIntVector (&OutCells)[8], float (&OutW)[8], FVector* OutDW = nullptr);
+
+private:
+    bool Trilinear(const FVector& P, int32 (&OutIdx)[8], float (&OutW)[8]) const;
+    bool IsBrickDirty(int32 x, int32 y, int32 z) const;
+    FBox BrickWorldBounds(const FIntVector& Brick) const;
+    void ComposeBrick(const FIntVector& Brick, const FThermoClimateState& Climate,
+                      TConstArrayView<FThermoComposeSource> Sources, FOcclusionFn Occlusion);
+
+    FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
+    FORCEINLINE int32 BrickIndex(int32 bx, int32 by, int32 bz) const { return (bz * BrickDim.Y + by) * BrickDim.X + bx; }
+    FORCEINLINE double CellZ(int32 x, int32 y, int32 z) const { return Z0 + Zx * x + Zy * y + Zz * z; }
+
+    TWeakObjectPtr<const UThermoForgeFieldAsset> Field;
+    TSharedPtr<const FThermoPermOverrideLayer> PermOverrides;
+    FIntVector Dim = FIntVector::ZeroValue;
+    FIntVector BrickDim = FIntVector::ZeroValue;
+    float      CellSizeCm = 0.f;
+    FTransform Frame;
+    FTransform InvFrame;
+
+    // World Z of cell centers is linear in the indices
+    double Z0 = 0.0, Zx = 0.0, Zy = 0.0, Zz = 0.0;
+
+    TArray<float> SourceC;
+    TArray<float> TempC;
+
+    TBitArray<> DirtyBricks;
+    int32 NumDirty = 0;
+    int32 ScanCursor = 0;
+    uint32 Revision = 0;
+
+    TArray<uint32> BrickTempStamp;
+    uint32 TempStamp = 0;
+
+    TArray<uint32> BrickSourceStamp;
+    uint32 SourceStamp = 0;
+
+    /** Climate TempC was last composed with. */
+    float AppliedAmbientSeaLevelC = 0.f;
+    float AppliedLapseCPerCm = 0.f;
+    float AppliedSeaLevelZcm = 0.f;
+    float AppliedSolarC = 0.f;
+    FVector AppliedSunDirWS = FVector::ZeroVector;
+
+    /** Largest |SH.xyz| in the field: bounds how far any cell's sun visibility moves per unit of sun travel. */
+    float SunLobeMax = 0.f;
+};
@@ -0,0 +1,124 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ThermoForgeMultigrid.h"
+
+class UThermoForgeFieldAsset;
+struct FThermoPermOverrideLayer;
+
+/** Coarse wind over one volume's box: WindDim cells (cell-centred, spanning the box), world-space cm/s. */
+struct FThermoWindField
+{
+    FIntVector       WindDim = FIntVector::ZeroValue;
+    TArray<FVector3f> WindCmPerSec;
+
+    bool IsValid() const { return WindDim.X > 0 && WindDim.Y > 0 && WindDim.Z > 0 && WindCmPerSec.Num() == WindDim.X * WindDim.Y * WindDim.Z; }
+};
+
+/**
+ * Transient temperature of one volume's cells, integrated with an explicit 7-point stencil:
+ *   dT/dt = D/h² · Σ_faces G_f (T_n - T) + (Target - T) / ExchangeSeconds
+ * G_f is the harmonic mean of the two cells' WallPermeability01 (0 on the grid border). Target is the
+ * composed temperature (ambient + solar + sources), so sources inject heat and the exchange term
+ * relaxes towards the climate; without sources and gradients T converges to the composed field.
+ * Arrays are padded by guard cells so the row kernel never branches on borders.
+ *
+ * With wind set, each step is followed by a semi-Lagrangian advection pass: every cell reads T at the point the
+ * wind carried to it, scaled by the cell's SkyView01 so enclosed space stays still. A uniform wind shares one
+ * 8-tap stencil across the grid; a coarse wind field adds a per-cell gather.
+ */
+class THERMOFORGE_API FThermoForgeDiffusionGrid
+{
+public:
+    struct FParams
+    {
+        float DiffusivityCm2PerSec = 20000.f;
+        float ExchangeSeconds = 60.f;
+        /** Fixed step; Advance carries the remainder to the next call. */
+        float StepSeconds = 1.f / 30.f;
+        int32 MaxStepsPerAdvance = 4;
+    };
+
+    /** Size to the field, build conductances and start from SeedC (field layout) or the field's zero state. */
+    void Init(const UThermoForgeFieldAsset* InField, int32 InGuardCells, TConstArrayView<float> SeedC);
+
+    bool IsValidFor(const UThermoForgeFieldAsset* InField) const;
+
+    /** Blocker overrides read instead of the baked WallPermeability01 by the next RefreshConductance / Init. */
+    void SetPermOverrides(const TSharedPtr<const FThermoPermOverrideLayer>& InOverrides) { PermOverrides = InOverrides; }
+
+    /** Re-read WallPermeability01 (and the SkyView01 wind mask) after a field patch; temperatures are kept. */
+    void RefreshConductance(const UThermoForgeFieldAsset* InField);
+
+    /** Same for the faces touching cells CellMin..CellMax (inclusive), e.g. after a runtime permeability override. */
+    void RefreshConductance(const UThermoForgeFieldAsset* InField, const FIntVector& CellMin, const FIntVector& CellMax);
+
+    /** Wind heat drifts with: a uniform world vector plus an optional coarse field (null for none). */
+    void SetWind(const FVector& InWindWS, const TSharedPtr<const FThermoWindField>& InWindField);
+
+    /** Integrate DeltaSeconds towards TargetC (field layout). Returns the number of fixed steps taken. */
+    int32 Advance(float DeltaSeconds, const FParams& Params, TConstArrayView<float> TargetC);
+
+    /**
+     * Jump straight to the steady state of the stencil for TargetC (multigrid). Returns the V-cycles run;
+     * OutResidualC receives the final largest residual.
+     */
+    int32 SolveEquilibrium(const FParams& Params, TConstArrayView<float> TargetC, const FThermoMultigridParams& Solver, float* OutResidualC = nullptr);
+
+    /** Ask the owner to settle this grid once its target is complete (set by Init). */
+    void RequestSettle() { bSettlePending = true; }
+    bool IsSettlePending() const { return bSettlePending; }
+
+    /** Trilinear T at P; false outside the grid. */
+    bool SampleTemp(const FVector& P, float& OutTempC) const;
+
+    /** Current temperatures in field layout (unpadded copy). */
+    void CopyTemperatures(TArray<float>& OutTempC) const;
+
+    const UThermoForgeFieldAsset* GetField() const { return Field.Get(); }
+    FIntVector GetDim() const { return Dim; }
+
+private:
+    void Step(float R, float K, TConstArrayView<float> TargetC);
+
+    /** One advection pass of Dt seconds (T -> TNext, then swap). */
+    void Advect(float Dt);
+
+    /** Rebuild per-cell wind (cells/s, grid axes) from the uniform wind, the field and the mask. */
+    void RebuildCellWind();
+
+    /** Copy the outermost cells into the first guard layer (zero-gradient inflow). */
+    void FillGuards();
+
+    FORCEINLINE int32 Padded(int32 x, int32 y, int32 z) const
+    {
+        return ((z + Guard) * PDim.Y + (y + Guard)) * PDim.X + (x + Guard);
+    }
+
+    TWeakObjectPtr<const UThermoForgeFieldAsset> Field;
+    TSharedPtr<const FThermoPermOverrideLayer> PermOverrides;
+    FIntVector Dim = FIntVector::ZeroValue;
+    FIntVector PDim = FIntVector::ZeroValue;
+    int32      Guard = 1;
+    float      CellSizeCm = 0.f;
+    FTransform Frame;
+    FTransform InvFrame;
+
+    // Padded layout; G* hold the face to the +X/+Y/+Z neighbour
+    TArray<float> T;
+    TArray<float> TNext;
+    TArray<float> Gx, Gy, Gz;
+
+    // Wind: SkyView01 mask (padded), uniform wind in cells/s (grid axes) and per-cell wind when a field is set
+    TArray<float>     WindMask;
+    FVector           WindWS = FVector::ZeroVector;
+    TSharedPtr<const FThermoWindField> WindField;
+    FVector3f         WindLocal = FVector3f::ZeroVector;
+    TArray<FVector3f> CellWind;
+    float             MaxWindCells = 0.f;
+    bool              bWindDirty = false;
+
+    double Accumulator = 0.0;
+    bool   bWarnedUnstable = false;
+    bool   bSettlePending = false;
+};
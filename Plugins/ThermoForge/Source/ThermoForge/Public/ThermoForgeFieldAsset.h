@@ -2,14 +2,121 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "HAL/CriticalSection.h"
 #include "ThermoForgeFieldAsset.generated.h"
 
+struct FThermoForgeFieldPatch;
+class UThermoForgeFieldAsset;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FThermoFieldPatchedDelegate, UThermoForgeFieldAsset* /*Field*/);
+
+/** Baked channels addressable by region queries. */
+UENUM(BlueprintType)
+enum class EThermoFieldChannel : uint8
+{
+    SkyView          UMETA(DisplayName="Sky View"),
+    WallPermeability UMETA(DisplayName="Wall Permeability"),
+    Indoorness       UMETA(DisplayName="Indoorness")
+};
+
+/**
+ * Baked-only temperature model used by field searches:
+ *   T = AmbientSeaLevelC - LapseCPerCm * (Z - SeaLevelZcm) + SolarC * SkyView01
+ * Linear in world Z and SkyView, so it can be bounded per brick.
+ */
+struct FThermoBakedTempModel
+{
+    float AmbientSeaLevelC = 0.f;
+    float SeaLevelZcm      = 0.f;
+    /** °C lost per cm of altitude; 0 when lapse is disabled. */
+    float LapseCPerCm      = 0.f;
+    /** SolarGainScaleC already scaled by (1 - WeatherAlpha01). */
+    float SolarC           = 0.f;
+
+    FORCEINLINE float Evaluate(float Sky01, double WorldZcm) const
+    {
+        return AmbientSeaLevelC - LapseCPerCm * float(WorldZcm - SeaLevelZcm) + SolarC * Sky01;
+    }
+};
+
+/**
+ * Sky visibility toward a world direction from a cell's L1 spherical-harmonic lobe:
+ *   V(d) = SH.W + SH.X * d.X + SH.Y * d.Y + SH.Z * d.Z, clamped to 0..1
+ * Open sky fits to V = 1 everywhere; a wall on one side tilts the lobe away from it.
+ */
+FORCEINLINE float ThermoEvalSunVisibility(const FVector4f& SH, const FVector& Dir)
+{
+    return FMath::Clamp(SH.X * float(Dir.X) + SH.Y * float(Dir.Y) + SH.Z * float(Dir.Z) + SH.W, 0.f, 1.f);
+}
+
+/** Hottest/coldest search request in grid space (cells). */
+struct FThermoBakedExtremeQuery
+{
+    FIntVector CenterCell = FIntVector::ZeroValue;
+    int32      RadiusCells = 0;
+    bool       bHottest = true;
+    FThermoBakedTempModel Model;
+};
+
+/** One cell returned by a ranked field search. */
+struct FThermoBakedExtremeCell
+{
+    FIntVector Cell = FIntVector::ZeroValue;
+    float      TempC = 0.f;
+};
+
+/** One level of the SkyView min/max pyramid. Level 0 bricks are BrickSize³ cells; each level above halves resolution. */
+struct FThermoForgeMinMaxLevel
+{
+    /** Bricks per axis at this level. */
+    FIntVector Dim = FIntVector::ZeroValue;
+    /** Cells per brick edge at this level. */
+    int32 BrickCells = 0;
+    TArray<float> Min;
+    TArray<float> Max;
+
+    FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
+};
+
+/** Read-only view of what FindExtremeCell walks, so copies of a field (snapshots) run the same search. */
+struct FThermoFieldSearchView
+{
+    FIntVector Dim = FIntVector::ZeroValue;
+    float      CellSizeCm = 0.f;
+    FTransform Frame;
+    TConstArrayView<float> SkyView01;
+    /** Empty = no pyramid (brute-force scan). */
+    TConstArrayView<FThermoForgeMinMaxLevel> SkyViewHierarchy;
+
+    FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
+};
+
+/**
+ * Cooked payload: channels quantized to uint16 in brick order, plus the prebuilt pyramid.
+ * Built in PreSave when cooking; decoded back into the float channels on load.
+ */
+struct FThermoForgeCookedField
+{
+    bool bValid = false;
+    /** False when Indoorness01 matched (1-Sky)*(1-Wall) and was dropped; left empty on load and derived on read. */
+    bool bHasIndoorness = true;
+    /** CRC32 of Quantized and every pyramid level; checked on load. */
+    uint32 Checksum = 0;
+    /** Older payloads checksummed Quantized only (load-time, from the archive version). */
+    bool bChecksumCoversPyramid = true;
+    /** Largest |decoded - editor| over all channels, verified at cook time. */
+    float MaxError = 0.f;
+    TArray<uint16> Quantized;
+    TArray<FThermoForgeMinMaxLevel> SkyViewHierarchy;
+};
+
 /**
  * Geometry-invariant bake per volume.
  * Channels:
  *  - SkyView01         (0..1) openness to sky
  *  - WallPermeability01(0..1) average permeability to 6 axis neighbors
  *  - Indoorness01      (0..1) indoor proxy = (1 - SkyView01) * (1 - WallPermeability01)
+ *  - SunVisibilitySH   directional sky visibility (L1 SH, world axes), weights solar gain by sun direction
  */
 UCLASS(BlueprintType)
 class THERMOFORGE_API UThermoForgeFieldAsset : public UDataAsset
@@ -17,6 +124,19 @@ class THERMOFORGE_API UThermoForgeFieldAsset : public UDataAsset
     GENERATED_BODY()
 public:
     UThermoForgeFieldAsset();
+
+    virtual void Serialize(FArchive& Ar) override;
+    virtual void PostLoad() override;
+#if WITH_EDITOR
+    virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+    /** Cells per brick edge at the finest hierarchy level. */
+    static constexpr int32 BrickSize = 4;
+
+    /** Max per-cell error accepted for the cooked (quantized) representation; above it the raw floats are cooked. */
+    static constexpr float CookTolerance = 1e-4f;
     
     /** Grid metadata */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Field")
@@ -42,9 +162,21 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Field", meta=(ToolTip="Avg permeability toward 6 axis neighbors, 0..1"))
     TArray<float> WallPermeability01;
 
+    /** Empty on cooked fields where it was exactly the formula (IsIndoornessDerived); read it through the accessors. */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Field", meta=(ToolTip="Indoor proxy = (1 - SkyView01) * (1 - WallPermeability01)"))
     TArray<float> Indoorness01;
 
+    /** Least-squares L1 fit of the bake's hemisphere rays per cell (xyz = linear band, w = constant). Empty on older bakes. */
+    UPROPERTY(EditAnywhere, Category="Field")
+    TArray<FVector4f> SunVisibilitySH;
+
+    /**
+     * Answer box sums/averages from 3D summed-volume tables, each built on the first query of its channel
+     * (8 bytes per cell per queried channel). Off: every query loops over the box.
+     */
+    UPROPERTY(EditAnywhere, Category="Field|Derived")
+    bool bBuildSummedVolumeTables = true;
+
     FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
 
     /** Trilinear; returns false if outside grid. */
@@ -70,8 +202,125 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category="ThermoForge|Field")
     float GetIndoorByLinearIdx(int32 Linear) const;
 
+    /** True if Indoorness01 is not stored and every read computes (1 - SkyView01) * (1 - WallPermeability01). */
+    bool IsIndoornessDerived() const;
+
+    /** True if SunVisibilitySH covers every cell. */
+    bool HasSunVisibility() const;
+
+    /**
+     * Solar weight of a cell: its visibility toward SunDirWS (unit, toward the sun), or SkyView01 when the field
+     * has no directional bake or SunDirWS is zero.
+     */
+    float GetSolarViewByLinearIdx(int32 Linear, const FVector& SunDirWS) const;
+
+    /** Sum of a channel over the inclusive cell box [MinCell, MaxCell] (clamped to the grid). */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ThermoForge|Field")
+    float SumChannelInBox(EThermoFieldChannel Channel, const FIntVector& MinCell, const FIntVector& MaxCell) const;
+
+    /** Mean of a channel over the inclusive cell box [MinCell, MaxCell] (clamped to the grid); 0 if empty. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ThermoForge|Field")
+    float AverageChannelInBox(EThermoFieldChannel Channel, const FIntVector& MinCell, const FIntVector& MaxCell) const;
+
+    /** Mean of a channel over all cells whose centers fall in the grid-aligned bounds of a world box. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ThermoForge|Field")
+    float AverageChannelInWorldBox(EThermoFieldChannel Channel, const FBox& WorldBox) const;
+
+    /** Raw channel array (Indoorness is empty when IsIndoornessDerived). */
+    const TArray<float>& GetChannel(EThermoFieldChannel Channel) const;
+
     FORCEINLINE FTransform GetGridFrame() const
     {
         return FTransform(GridRotation, OriginWS, FVector::OneVector);
     }
+
+    // --------- Derived (runtime) data ---------
+    /** Rebuild acceleration data from the baked channels. Call after channels change. */
+    void RebuildDerivedData();
+
+    /** True if the SkyView min/max pyramid matches the current grid at every level. */
+    bool HasSkyViewHierarchy() const;
+
+    /** True if Channel's summed-volume table is built and matches the current grid. */
+    bool HasSummedVolumeTable(EThermoFieldChannel Channel) const;
+
+    const TArray<FThermoForgeMinMaxLevel>& GetSkyViewHierarchy() const { return SkyViewHierarchy; }
+
+    /** Overwrite the patched tiles in place and rebuild derived data. False if the patch targets another grid. */
+    bool ApplyPatch(const FThermoForgeFieldPatch& Patch);
+
+    /** Fired after any field asset is patched in place (game thread). */
+    static FThermoFieldPatchedDelegate OnFieldPatched;
+
+    /**
+     * Hottest/coldest cell within a sphere of RadiusCells around CenterCell under the baked-only model.
+     * Descends the SkyView min/max pyramid and skips bricks whose bound cannot beat the current best.
+     * Ties resolve to the lowest linear index (same as a z/y/x scan).
+     */
+    bool FindExtremeCell(const FThermoBakedExtremeQuery& Query, FIntVector& OutCell, float& OutTempC) const;
+
+    /** FindExtremeCell over any view; thread-safe as long as the viewed data outlives the call. */
+    static bool FindExtremeCellInView(const FThermoFieldSearchView& View, const FThermoBakedExtremeQuery& Query, FIntVector& OutCell, float& OutTempC);
+
+    /**
+     * Up to K hottest/coldest cells in the query sphere, each at least MinSeparationCells (grid units) from
+     * every cell returned before it. Best-first over the pyramid with one heap of bricks and cells, so cells
+     * come out in exact order and bricks already covered by a returned cell's exclusion sphere are dropped.
+     * Equivalent to picking the best cell K times while excluding around each pick.
+     */
+    static bool FindTopKCellsInView(const FThermoFieldSearchView& View, const FThermoBakedExtremeQuery& Query,
+                                    int32 K, float MinSeparationCells, TArray<FThermoBakedExtremeCell>& OutCells);
+
+    /** View of this asset (pyramid included only when it matches the grid). */
+    FThermoFieldSearchView MakeSearchView() const;
+
+private:
+#if WITH_DEV_AUTOMATION_TESTS
+    friend class FThermoForgeCookedFieldTest;
+#endif
+
+    void BuildSkyViewHierarchy();
+    static void BuildMinMaxPyramid(const TArray<float>& Sky, const FIntVector& InDim, TArray<FThermoForgeMinMaxLevel>& Out);
+    /** True if Levels is exactly what BuildMinMaxPyramid makes for InDim: every level's size, brick span and array length. */
+    static bool IsMinMaxPyramidValid(const TArray<FThermoForgeMinMaxLevel>& Levels, const FIntVector& InDim);
+    /** Checksum of a cooked payload as stored in FThermoForgeCookedField::Checksum. */
+    static uint32 ComputeCookedChecksum(const FThermoForgeCookedField& Cooked);
+
+    /** Visit every cell once in brick order (BrickSize³ bricks, x fastest within and across bricks). */
+    template<typename FuncType>
+    void ForEachCellInBrickOrder(FuncType&& Func) const;
+
+#if WITH_EDITOR
+    /** Quantize + verify the channels into CookedField; leaves it invalid if verification fails. */
+    void BuildCookedField();
+#endif
+    void SerializeCookedField(FArchive& Ar);
+    /** Decode the staged payload into the channels; false (channels left empty) if it doesn't match or verify. */
+    bool DecodeCookedField();
+    /** Build Channel's table if missing; caller holds SummedVolumeLock. */
+    void BuildSummedVolumeTable(int32 Channel) const;
+
+    /** Clamp an inclusive cell box to the grid; false if empty. */
+    bool ClampCellBox(FIntVector& MinCell, FIntVector& MaxCell) const;
+
+    /** Channel covers every cell, stored or derived. */
+    bool HasChannelValues(EThermoFieldChannel Channel) const;
+    /** Channel value at a valid linear index, derived Indoorness included. */
+    float ChannelAt(EThermoFieldChannel Channel, int32 Linear) const;
+
+    /** Store the derived Indoorness01 before writing cells individually. */
+    void MaterializeIndoorness();
+
+    /** Fraction bits of the summed-volume fixed point; exact integer sums, 2^-25 rounding per cell. */
+    static constexpr int32 SummedVolumeFracBits = 24;
+
+    /** Summed-volume tables, (Dim+1)³ with a zero border, indexed by EThermoFieldChannel; empty until queried. */
+    mutable TArray<int64> SummedVolume[3];
+    mutable FCriticalSection SummedVolumeLock;
+
+    /** SkyView01 min/max pyramid; [0] is the finest level, Last() is a single brick. */
+    TArray<FThermoForgeMinMaxLevel> SkyViewHierarchy;
+
+    /** Transient cook/load staging for the packed representation. */
+    FThermoForgeCookedField CookedField;
 };
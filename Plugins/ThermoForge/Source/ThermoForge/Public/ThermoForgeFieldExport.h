@@ -0,0 +1,92 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ThermoForgeFieldAsset.h"
+#include "ThermoForgeFieldExport.generated.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/** Channel encoding inside a .tfield file. */
+UENUM(BlueprintType)
+enum class EThermoFieldExportFormat : uint8
+{
+    Float32     UMETA(DisplayName="Raw float32"),
+    Quantized16 UMETA(DisplayName="Quantized uint16 (0..1 → 0..65535)")
+};
+
+/**
+ * Fixed 128-byte header at the start of a .tfield file (little-endian).
+ * Followed by one slab per channel (SkyView, WallPermeability, Indoorness), cells in Index(x,y,z) order.
+ */
+struct FThermoFieldFileHeader
+{
+    static constexpr uint32 MagicValue   = 0x444C4654; // "TFLD"
+    static constexpr uint32 CurrentVersion = 1;
+    static constexpr int64  SizeBytes    = 128;
+    static constexpr int32  MaxChannels  = 3;
+
+    uint32     Magic = MagicValue;
+    uint32     Version = CurrentVersion;
+    FIntVector Dim = FIntVector::ZeroValue;
+    EThermoFieldExportFormat Format = EThermoFieldExportFormat::Float32;
+    uint8      NumChannels = 0;
+    float      CellSizeCm = 0.f;
+    FVector    OriginWS = FVector::ZeroVector;
+    FRotator   GridRotation = FRotator::ZeroRotator;
+    uint64     SlabOffset[MaxChannels] = { 0, 0, 0 };
+
+    int64 NumCells() const { return (Dim.X>0 && Dim.Y>0 && Dim.Z>0) ? int64(Dim.X) * Dim.Y * Dim.Z : 0; }
+    int32 BytesPerValue() const { return Format == EThermoFieldExportFormat::Quantized16 ? 2 : 4; }
+
+    /** Reads or writes exactly SizeBytes. */
+    void Serialize(FArchive& Ar);
+};
+
+/** Streaming writer for baked fields: header + channel slabs written in fixed-size chunks. */
+struct THERMOFORGE_API FThermoForgeFieldExport
+{
+    /** Cells converted per chunk before handing bytes to the file writer. */
+    static constexpr int32 ChunkCells = 64 * 1024;
+
+    /**
+     * Writes <BasePath>.tfield and a small <BasePath>.json describing its layout.
+     * Channels may be empty (then that slab is filled with the channel default).
+     */
+    static bool Write(const FString& BasePath,
+        const FIntVector& Dim, float CellSizeCm, const FVector& OriginWS, const FRotator& GridRotation,
+        TConstArrayView<float> SkyView01, TConstArrayView<float> WallPerm01, TConstArrayView<float> Indoor01,
+        EThermoFieldExportFormat Format);
+
+    static bool Write(const FString& BasePath, const UThermoForgeFieldAsset& Field, EThermoFieldExportFormat Format);
+};
+
+/** Read-only, memory-mapped view of a .tfield file. Values decode on access; nothing is copied. */
+class THERMOFORGE_API FThermoForgeMappedField
+{
+public:
+    FThermoForgeMappedField();
+    ~FThermoForgeMappedField();
+
+    bool Open(const FString& Filename);
+    void Close();
+    bool IsOpen() const { return Data != nullptr; }
+
+    const FThermoFieldFileHeader& GetHeader() const { return Header; }
+
+    /** Decoded value (0..1) at a linear cell index; channel default if out of range. */
+    float GetValue(EThermoFieldChannel Channel, int64 Linear) const;
+
+    /** Direct slab views; empty if the file uses the other encoding. */
+    TConstArrayView<float>  GetFloatSlab(EThermoFieldChannel Channel) const;
+    TConstArrayView<uint16> GetQuantizedSlab(EThermoFieldChannel Channel) const;
+
+private:
+    const uint8* SlabPtr(EThermoFieldChannel Channel) const;
+
+    TUniquePtr<IMappedFileHandle> Handle;
+    TUniquePtr<IMappedFileRegion> Region;
+    const uint8* Data = nullptr;
+    int64 DataSize = 0;
+    FThermoFieldFileHeader Header;
+};
@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UThermoForgeFieldAsset;
+
+/** New channel values for one TileSize³ tile (clipped to the grid), x fastest. */
+struct FThermoForgeFieldPatchTile
+{
+    FIntVector Tile = FIntVector::ZeroValue;
+    TArray<float> SkyView01;
+    TArray<float> WallPermeability01;
+    TArray<float> Indoorness01;
+};
+
+/**
+ * Incremental update for a baked field: only tiles whose values changed since the last bake.
+ * Applied in place with UThermoForgeFieldAsset::ApplyPatch; stored on disk as .tfpatch.
+ */
+struct THERMOFORGE_API FThermoForgeFieldPatch
+{
+    static constexpr uint32 MagicValue     = 0x48435054; // "TPCH"
+    static constexpr uint32 CurrentVersion = 1;
+    static constexpr int32  TileSize       = 8;
+
+    /** Object path of the field asset this patch was made against. */
+    FString TargetAsset;
+
+    /** Grid the patch expects; must match the target exactly. */
+    FIntVector Dim = FIntVector::ZeroValue;
+    float      CellSizeCm = 0.f;
+    FVector    OriginWS = FVector::ZeroVector;
+    FRotator   GridRotation = FRotator::ZeroRotator;
+
+    TArray<FThermoForgeFieldPatchTile> Tiles;
+
+    bool IsEmpty() const { return Tiles.Num() == 0; }
+    int64 NumCells() const;
+
+    /** Same grid layout and channel sizes as Field. */
+    bool Matches(const UThermoForgeFieldAsset& Field) const;
+
+    /** Cell range covered by a tile (inclusive min, exclusive max). */
+    void TileRange(const FIntVector& Tile, FIntVector& OutMin, FIntVector& OutMax) const;
+
+    /**
+     * Tiles where the new channels differ from Base by more than Tolerance.
+     * Returns false if the grids are incompatible (a full rebake is needed instead).
+     */
+    static bool Diff(const UThermoForgeFieldAsset& Base,
+        const FIntVector& NewDim, float NewCellSizeCm, const FVector& NewOriginWS, const FRotator& NewGridRotation,
+        const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01,
+        float Tolerance, FThermoForgeFieldPatch& Out);
+
+    void Serialize(FArchive& Ar);
+
+    bool SaveToFile(const FString& Filename) const;
+    bool LoadFromFile(const FString& Filename);
+};
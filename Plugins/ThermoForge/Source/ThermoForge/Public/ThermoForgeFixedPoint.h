@@ -0,0 +1,154 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UThermoForgeFieldAsset;
+class UThermoForgeProjectSettings;
+struct FThermoClimateState;
+struct FThermoPermOverrideLayer;
+struct FThermoSourceShape;
+
+/**
+ * Deterministic runtime temperature in Q16.16 (°C · 65536). Inputs (climate, sources) are quantised once
+ * per step; composition and the diffusion stencil then use integer arithmetic only, so peers fed the same
+ * inputs hold bit-identical grids regardless of compiler or thread count. Source occlusion is not traced
+ * here (physics queries are not deterministic); sources are attenuated by the baked WallPermeability01.
+ */
+namespace ThermoFixed
+{
+    static constexpr int32 Shift = 16;
+    static constexpr int32 One = 1 << Shift;
+
+    FORCEINLINE int32 FromFloat(float V)
+    {
+        return int32(FMath::Clamp<double>(FMath::RoundToDouble(double(V) * One), double(MIN_int32), double(MAX_int32)));
+    }
+    FORCEINLINE float ToFloat(int32 V) { return float(double(V) / One); }
+}
+
+/** Climate scalars for one step. */
+struct FThermoFixedClimate
+{
+    int32 AmbientSeaLevelQ = 0;
+    /** °C per metre (Q16.16); per-cm values are below Q16.16 resolution. */
+    int32 LapsePerMetreQ = 0;
+    /** 1/256 cm. */
+    int64 SeaLevelZ8 = 0;
+    int32 SolarQ = 0;
+
+    static FThermoFixedClimate FromClimate(const FThermoClimateState& Climate);
+};
+
+/**
+ * The season/diurnal climate model in Q16.16, quantised once from the settings. At() evaluates it for a
+ * lockstep clock reading with integer maths and a cosine table only, so the step's climate depends on
+ * nothing but the clock, the weather input and the config.
+ */
+struct FThermoFixedClimateModel
+{
+    int32 WinterAvgQ = 0;
+    int32 SummerAvgQ = 0;
+    int32 WinterDeltaQ = 0;
+    int32 SummerDeltaQ = 0;
+    /** Diurnal peak, FDateTime ticks after midnight. */
+    int64 PeakTicks = 0;
+    int32 LapsePerMetreQ = 0;
+    /** 1/256 cm. */
+    int64 SeaLevelZ8 = 0;
+    int32 SolarScaleQ = 0;
+
+    static FThermoFixedClimateModel FromSettings(const UThermoForgeProjectSettings& Settings);
+
+    /** Climate at ClockTicks (FDateTime ticks) under WeatherAlphaQ (0 clear … One overcast). */
+    FThermoFixedClimate At(int64 ClockTicks, int32 WeatherAlphaQ) const;
+};
+
+/** One source quantised into a grid's cell space (cell (x,y,z) centre sits at (x,y,z)). */
+struct FThermoFixedSource
+{
+    bool  bBox = false;
+    uint8 Falloff = 0;
+    int32 IntensityQ = 0;
+
+    // Point: centre and radius in cells (Q16.16)
+    int64 CX = 0, CY = 0, CZ = 0;
+    int32 RadiusQ = 0;
+
+    // Box: affine map cell coords → box coords normalised to ±1 (Q16.16)
+    int32 A[9] = {};
+    int32 B[3] = {};
+
+    FIntVector MinCell = FIntVector::ZeroValue;
+    FIntVector MaxCell = FIntVector(-1);
+};
+
+class THERMOFORGE_API FThermoForgeFixedGrid
+{
+public:
+    struct FParams
+    {
+        /** D·dt/h² and dt/tau per sub-step (Q16.16), already split for stability. */
+        int32 RQ = 0;
+        int32 KQ = 0;
+        int32 Split = 1;
+
+        static FParams Make(float DiffusivityCm2PerSec, float ExchangeSeconds, float StepSeconds, float CellSizeCm);
+    };
+
+    /** Size to the field and quantise its channels (WallPerm through PermOverrides if given); T starts at 0 until Snap. */
+    void Init(const UThermoForgeFieldAsset* InField, int32 InGuardCells, const FThermoPermOverrideLayer* PermOverrides = nullptr);
+
+    bool IsValidFor(const UThermoForgeFieldAsset* InField) const;
+
+    /** Quantise a source into this grid; false when it cannot touch any cell. */
+    bool MakeSource(const FThermoSourceShape& Shape, FThermoFixedSource& Out) const;
+
+    /** Compose the target from the inputs and integrate one fixed step. Updates the checksum. */
+    void Step(const FThermoFixedClimate& Climate, TConstArrayView<FThermoFixedSource> Sources, const FParams& Params);
+
+    /** Compose the target and jump every cell to it (start, load); deterministic like Step. */
+    void Snap(const FThermoFixedClimate& Climate, TConstArrayView<FThermoFixedSource> Sources);
+
+    /** CRC32 of the grid state after the last Step or Snap. */
+    uint32 GetChecksum() const { return Checksum; }
+
+    /** Trilinear T at P (°C); false outside the grid. */
+    bool SampleTemp(const FVector& P, float& OutTempC) const;
+
+    const UThermoForgeFieldAsset* GetField() const { return Field.Get(); }
+    float GetCellSizeCm() const { return CellSizeCm; }
+
+private:
+    void ComposeTarget(const FThermoFixedClimate& Climate, TConstArrayView<FThermoFixedSource> Sources);
+    void Diffuse(int32 RQ, int32 KQ);
+    void UpdateChecksum();
+
+    FORCEINLINE int32 Padded(int32 x, int32 y, int32 z) const
+    {
+        return ((z + Guard) * PDim.Y + (y + Guard)) * PDim.X + (x + Guard);
+    }
+    FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
+
+    TWeakObjectPtr<const UThermoForgeFieldAsset> Field;
+    FIntVector Dim = FIntVector::ZeroValue;
+    FIntVector PDim = FIntVector::ZeroValue;
+    int32      Guard = 1;
+    float      CellSizeCm = 0.f;
+    FTransform Frame;
+    FTransform InvFrame;
+
+    /** World Z of cell centres, linear in the indices (1/256 cm). */
+    int64 Z0 = 0, Zx = 0, Zy = 0, Zz = 0;
+
+    // Field layout (Q16.16)
+    TArray<int32> Sky;
+    TArray<int32> Perm;
+    TArray<int32> Target;
+
+    // Padded layout
+    TArray<int32> T;
+    TArray<int32> TNext;
+    TArray<int32> Gx, Gy, Gz;
+
+    uint32 Checksum = 0;
+};
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "ThermoForgeQueryCursor.h"
 #include "ThermoForgeHeatFXComponent.generated.h"
 
 class UPrimitiveComponent;
@@ -88,7 +89,7 @@ public:
 	UPROPERTY(EditAnywhere, Category="ThermoForge|Origin", meta=(ClampMin="10.0"))
 	float ProbeRadiusCm = 300.f;
 
-	/** Number of probe samples around the ring. */
+	/** Number of probe samples around the ring (used only where the temperature gradient is flat). */
 	UPROPERTY(EditAnywhere, Category="ThermoForge|Origin", meta=(ClampMin="4", ClampMax="64"))
 	int32 ProbeSamples = 12;
 
@@ -162,8 +163,8 @@ protected:
 	/** Write CPD[0..8] into TargetPrim (if enabled & valid). */
 	void WriteCustomPrimitiveData();
 
-	/** Sample grid/system temperature at P (°C). */
-	float SampleTempAt(const FVector& P) const;
+	/** Sample grid/system temperature at P (°C). Pass a cursor for points that move slowly between calls. */
+	float SampleTempAt(const FVector& P, FThermoQueryCursor* Cursor = nullptr) const;
 
 	/** Origin resolution helpers. Returns true if origin is valid. */
 	bool ResolveOrigin_NearestSource(const FVector& CenterWS, FVector& OutOriginWS, float& OutStrength);
@@ -181,4 +182,7 @@ private:
 
 	bool bHasOrigin = false;
 	bool bHadInitialFire = false;
+
+	/** Lookup cache for the owner-location query in TickHeat. */
+	FThermoQueryCursor OwnerCursor;
 };
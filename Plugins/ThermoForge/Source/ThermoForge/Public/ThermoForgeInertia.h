@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UThermoForgeFieldAsset;
+
+/**
+ * Per-cell thermal inertia without spatial exchange: each cell relaxes towards its composed temperature,
+ *   T += (Target - T) · (1 - exp(-dt / tau)),  tau = lerp(OutdoorSeconds, IndoorSeconds, Indoorness01)
+ * Cells are visited round-robin in fixed chunks, at most CellsPerFrame per Update; each chunk remembers when
+ * it was last integrated, so dt is exact however long the sweep takes.
+ */
+class THERMOFORGE_API FThermoForgeInertiaGrid
+{
+public:
+    static constexpr int32 ChunkCells = 4096;
+
+    struct FParams
+    {
+        float OutdoorSeconds = 20.f;
+        float IndoorSeconds = 180.f;
+        int32 CellsPerFrame = 65536;
+    };
+
+    /** Size to the field, bake per-cell rates from Indoorness01 and start at SeedC (field layout). */
+    void Init(const UThermoForgeFieldAsset* InField, const FParams& Params, TConstArrayView<float> SeedC, double NowSeconds);
+
+    bool IsValidFor(const UThermoForgeFieldAsset* InField, const FParams& Params) const;
+
+    /** Integrate the next chunks up to the cell budget. Returns the number of cells visited. */
+    int32 Update(double NowSeconds, const FParams& Params, TConstArrayView<float> TargetC);
+
+    /** Jump every cell to TargetC (no relaxation), e.g. while the target is still being built or after a time skip. */
+    void Snap(TConstArrayView<float> TargetC, double NowSeconds);
+
+    /** True from Init until the owner calls FinishSeeding (target complete). */
+    bool IsSeeding() const { return bSeeding; }
+    void FinishSeeding() { bSeeding = false; }
+
+    /** Trilinear T at P; false outside the grid. */
+    bool SampleTemp(const FVector& P, float& OutTempC) const;
+
+    const UThermoForgeFieldAsset* GetField() const { return Field.Get(); }
+
+private:
+    TWeakObjectPtr<const UThermoForgeFieldAsset> Field;
+    FIntVector Dim = FIntVector::ZeroValue;
+    float      CellSizeCm = 0.f;
+    FTransform InvFrame;
+
+    /** Time constants the per-cell rates were built from. */
+    float BuiltOutdoorSeconds = 0.f;
+    float BuiltIndoorSeconds = 0.f;
+
+    TArray<float>  T;
+    TArray<float>  InvTau;
+    TArray<double> ChunkTime;
+    int32 NextChunk = 0;
+    bool  bSeeding = false;
+};
@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+struct FThermoMultigridParams
+{
+    /** Stop once the largest equation residual (°C) drops below this. */
+    float ToleranceC = 0.01f;
+    int32 MaxCycles = 8;
+    int32 PreSmooth = 2;
+    int32 PostSmooth = 2;
+    int32 CoarsestIterations = 64;
+};
+
+/**
+ * Geometric multigrid for the steady state of the diffusion grid:
+ *   X + Beta · Σ_faces G_f (X - X_n) = B
+ * G is per face (+X/+Y/+Z neighbour, field layout, 0 on the border), B the composed temperature.
+ * Cell-centred 2:1 coarsening with re-discretised face conductances, red-black Gauss-Seidel smoothing,
+ * averaging restriction and constant prolongation. Every pass runs z planes in parallel.
+ */
+class THERMOFORGE_API FThermoForgeMultigrid
+{
+public:
+    void Build(const FIntVector& Dim, TConstArrayView<float> Gx, TConstArrayView<float> Gy, TConstArrayView<float> Gz, float Beta);
+
+    /** V-cycles until ToleranceC or MaxCycles. InOutX is the initial guess. Returns the cycles run. */
+    int32 Solve(TConstArrayView<float> B, TArray<float>& InOutX, const FThermoMultigridParams& Params, float* OutResidualC = nullptr);
+
+    int32 GetNumLevels() const { return Levels.Num(); }
+
+private:
+    struct FLevel
+    {
+        FIntVector Dim = FIntVector::ZeroValue;
+        float Beta = 0.f;
+        TArray<float> Gx, Gy, Gz;
+        TArray<float> X, B, R;
+
+        FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
+        int32 Num() const { return Dim.X * Dim.Y * Dim.Z; }
+    };
+
+    void Smooth(FLevel& L, int32 Iterations) const;
+    float Residual(FLevel& L) const;
+    void Restrict(const FLevel& Fine, FLevel& Coarse) const;
+    void ProlongAdd(const FLevel& Coarse, FLevel& Fine) const;
+    void VCycle(int32 Level, const FThermoMultigridParams& Params);
+
+    TArray<FLevel> Levels;
+};
@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
 #include "Engine/EngineTypes.h" // ECollisionChannel
+#include "ThermoForgeFieldExport.h" // EThermoFieldExportFormat
+#include "ThermoForgeClimate.h"     // EThermoClockMode
 #include "ThermoForgeProjectSettings.generated.h"
 
 /**
@@ -35,6 +37,10 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Climate", meta=(ClampMin="0", ClampMax="60"))
     float SummerDayNightDeltaC = 10.f;
 
+    /** Hour of the diurnal peak (coolest 12h later); shared by the climate clock and explicit-time queries. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate", meta=(ClampMin="0", ClampMax="24"))
+    float DiurnalPeakHour = 15.f;
+
     /** Default weather factor (0 clear … 1 overcast). */
     UPROPERTY(EditAnywhere, Config, Category="Climate", meta=(ClampMin="0", ClampMax="1"))
     float DefaultWeatherAlpha01 = 0.3f;
@@ -43,6 +49,51 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Climate", meta=(ClampMin="0", ClampMax="50", ToolTip="How many °C does full sun add at SkyView=1, Weather=0"))
     float SolarGainScaleC = 6.f;
 
+    // ======== SUN ========
+    /** Weight solar gain by each cell's baked visibility toward the sun instead of its isotropic SkyView01 (fields baked before this keep SkyView01). */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Sun")
+    bool bDirectionalSolarGain = true;
+
+    /** Site latitude for the sun path (degrees, north positive). */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Sun", meta=(ClampMin="-90", ClampMax="90", EditCondition="bDirectionalSolarGain"))
+    float LatitudeDeg = 45.f;
+
+    /** World yaw of geographic north (0 = +X, 90 = +Y); east is 90° clockwise from it. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Sun", meta=(ClampMin="-180", ClampMax="180", EditCondition="bDirectionalSolarGain"))
+    float NorthYawDeg = 0.f;
+
+    // ======== WEATHER MAP ========
+    /** Regional weather (cloud, precipitation, wind chill) on a 2D map drifting with the wind, on top of the global weather. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Weather Map")
+    bool bUseWeatherMap = false;
+
+    /** Cells per side. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Weather Map", meta=(ClampMin="2", ClampMax="1024", EditCondition="bUseWeatherMap"))
+    int32 WeatherMapResolution = 64;
+
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Weather Map", meta=(ClampMin="100", Units="cm", EditCondition="bUseWeatherMap"))
+    float WeatherMapCellSizeCm = 10000.f;
+
+    /** World XY the map is centred on. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Weather Map", meta=(EditCondition="bUseWeatherMap"))
+    FVector2D WeatherMapCenterWS = FVector2D::ZeroVector;
+
+    /** Default wind the map drifts with (cm/s, world XY); SetWeatherWind overrides it at runtime. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Weather Map", meta=(EditCondition="bUseWeatherMap || bWindAdvection"))
+    FVector2D WeatherWindCmPerSec = FVector2D(500.f, 0.f);
+
+    /** Advection step; the map only changes this often. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Weather Map", meta=(ClampMin="0.02", ClampMax="60", Units="s", EditCondition="bUseWeatherMap"))
+    float WeatherStepSeconds = 0.5f;
+
+    /** Time constant for weather systems to fade back to the global weather (0 = never). */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Weather Map", meta=(ClampMin="0", Units="s", EditCondition="bUseWeatherMap"))
+    float WeatherRelaxSeconds = 900.f;
+
+    /** °C lost under full precipitation. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Weather Map", meta=(ClampMin="0", ClampMax="30", EditCondition="bUseWeatherMap"))
+    float PrecipitationCoolingC = 4.f;
+
     // ======== ALTITUDE ========
     /** Apply environmental lapse rate with altitude. */
     UPROPERTY(EditAnywhere, Config, Category="Climate|Altitude")
@@ -56,6 +107,23 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Climate|Altitude", meta=(ClampMin="0.0", ClampMax="40.0"))
     float LapseRateCPerKm = 10.f;
 
+    // ======== CLOCK ========
+    /** Time source for the per-world climate clock that all runtime queries read. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Clock")
+    EThermoClockMode ClockMode = EThermoClockMode::SystemUtc;
+
+    /** Game-time seconds per real second (GameTime mode). 60 = one in-game hour per real minute. */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Clock", meta=(ClampMin="0", ClampMax="86400", EditCondition="ClockMode==EThermoClockMode::GameTime"))
+    float GameTimeScale = 60.f;
+
+    /** Time of day the game clock starts at (hours). */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Clock", meta=(ClampMin="0", ClampMax="24", EditCondition="ClockMode==EThermoClockMode::GameTime"))
+    float GameStartTimeOfDayHours = 9.f;
+
+    /** Day of year the game clock starts at (1..365). */
+    UPROPERTY(EditAnywhere, Config, Category="Climate|Clock", meta=(ClampMin="1", ClampMax="365", EditCondition="ClockMode==EThermoClockMode::GameTime"))
+    int32 GameStartDayOfYear = 172;
+
     // ======== PERMEABILITY / OCCLUSION ========
     /** If true, read density from Physical Materials; otherwise use defaults. */
     UPROPERTY(EditAnywhere, Config, Category="Permeability")
@@ -109,7 +177,7 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Grid")
     FIntVector DefaultTileDim = FIntVector(128,128,64);
 
-    /** Guard cells around volume bounds (reserved for future diffusion). */
+    /** Padding cells around each volume's diffusion grid (at least one is always used). */
     UPROPERTY(EditAnywhere, Config, Category="Grid", meta=(ClampMin="0", ClampMax="3"))
     int32 GuardCells = 1;
 
@@ -126,6 +194,133 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Preview", meta=(ClampMin="0", ClampMax="1"))
     float PreviewWeatherAlpha = 0.3f;
 
+    // ======== EXPORT ========
+    /** Write the baked channels to Saved/ThermoForge/Bakes as a .tfield binary (+ .json layout) after each bake. */
+    UPROPERTY(EditAnywhere, Config, Category="Export")
+    bool bExportFieldAfterBake = false;
+
+    /** Encoding for exported channel slabs. Quantized16 halves the file size; values are 0..1 so the loss is below 2e-5. */
+    UPROPERTY(EditAnywhere, Config, Category="Export", meta=(EditCondition="bExportFieldAfterBake"))
+    EThermoFieldExportFormat FieldExportFormat = EThermoFieldExportFormat::Float32;
+
+    // ======== REBAKE ========
+    /**
+     * Rebaking over an existing field with the same grid patches only the changed tiles in place (live consumers refresh
+     * instead of reinitialising) and records the delta as a .tfpatch under Saved/. The package is saved either way.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Rebake")
+    bool bPatchFieldsOnRebake = true;
+
+    /** Per-channel change below this is ignored when diffing a rebake. */
+    UPROPERTY(EditAnywhere, Config, Category="Rebake", meta=(ClampMin="0", ClampMax="0.1", EditCondition="bPatchFieldsOnRebake"))
+    float FieldPatchTolerance = 1e-4f;
+
+    // ======== COOK ========
+    /** Cook field assets as quantized, brick-ordered payloads with a prebuilt pyramid. Editor data is untouched. */
+    UPROPERTY(EditAnywhere, Config, Category="Cook")
+    bool bOptimizeFieldsOnCook = true;
+
+    // ======== RUNTIME ========
+    /**
+     * Cache composed temperature per baked cell; queries read it instead of tracing every source.
+     * Costs a full-field float grid per volume, so it is off by default and never built in editor worlds.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime")
+    bool bUseComposedGrid = false;
+
+    /** Time per frame spent recomposing bricks dirtied by moved or edited sources. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime", meta=(ClampMin="0.1", ClampMax="16", Units="ms", EditCondition="bUseComposedGrid"))
+    float ComposeBudgetMs = 1.f;
+
+    /** Time per frame spent re-tracing cells under dynamic blockers (doors, destroyed walls). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Blockers", meta=(ClampMin="0.05", ClampMax="16", Units="ms"))
+    float BlockerTraceBudgetMs = 0.5f;
+
+    /** Climate drift (°C) tolerated before the cached temperatures are refreshed. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime", meta=(ClampMin="0", ClampMax="2", EditCondition="bUseComposedGrid"))
+    float ComposeClimateEpsilonC = 0.05f;
+
+    /** Simulate heat diffusion per volume on top of the composed grid; queries read the transient temperature. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Diffusion", meta=(EditCondition="bUseComposedGrid"))
+    bool bUseDiffusion = false;
+
+    /** Spread rate through fully permeable cells (cm²/s). Larger values need more sub-steps per fixed step. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Diffusion", meta=(ClampMin="0", ClampMax="1000000", EditCondition="bUseComposedGrid && (bUseDiffusion || bDeterministicSimulation)"))
+    float DiffusivityCm2PerSec = 20000.f;
+
+    /** Time constant pulling each cell towards its composed temperature (ambient exchange + source injection). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Diffusion", meta=(ClampMin="0.1", ClampMax="3600", Units="s", EditCondition="bUseComposedGrid && (bUseDiffusion || bDeterministicSimulation)"))
+    float DiffusionExchangeSeconds = 60.f;
+
+    /** Fixed simulation rate (steps per second). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Diffusion", meta=(ClampMin="1", ClampMax="120", EditCondition="bUseComposedGrid && (bUseDiffusion || bDeterministicSimulation)"))
+    float DiffusionStepHz = 30.f;
+
+    /** Fixed steps allowed per frame; time beyond this is dropped after hitches. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Diffusion", meta=(ClampMin="1", ClampMax="16", EditCondition="bUseComposedGrid && bUseDiffusion"))
+    int32 MaxDiffusionStepsPerFrame = 4;
+
+    /** Largest residual (°C) accepted when settling a diffusion grid to its steady state. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Diffusion", meta=(ClampMin="0.0001", ClampMax="1", EditCondition="bUseComposedGrid && bUseDiffusion"))
+    float SettleToleranceC = 0.01f;
+
+    /** Multigrid V-cycles allowed per settle. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Diffusion", meta=(ClampMin="1", ClampMax="50", EditCondition="bUseComposedGrid && bUseDiffusion"))
+    int32 MaxSettleCycles = 8;
+
+    /** Carry heat downwind in the diffusion grids (weather wind plus any per-volume wind field), masked by SkyView01. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Diffusion", meta=(EditCondition="bUseComposedGrid && bUseDiffusion"))
+    bool bWindAdvection = false;
+
+    /** Fraction of the weather wind felt near the ground. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Diffusion", meta=(ClampMin="0", ClampMax="2", EditCondition="bUseComposedGrid && bUseDiffusion && bWindAdvection"))
+    float WindAdvectionScale = 0.5f;
+
+    /** Let each cell warm up / cool down towards its composed temperature instead of jumping (ignored while diffusion is on). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Inertia", meta=(EditCondition="bUseComposedGrid"))
+    bool bUseThermalInertia = false;
+
+    /** Relaxation time constant of fully outdoor cells (Indoorness01 = 0). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Inertia", meta=(ClampMin="0.1", ClampMax="3600", Units="s", EditCondition="bUseComposedGrid && bUseThermalInertia"))
+    float InertiaOutdoorSeconds = 20.f;
+
+    /** Relaxation time constant of fully indoor cells (Indoorness01 = 1). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Inertia", meta=(ClampMin="0.1", ClampMax="3600", Units="s", EditCondition="bUseComposedGrid && bUseThermalInertia"))
+    float InertiaIndoorSeconds = 180.f;
+
+    /** Cells integrated per frame per volume; larger volumes take proportionally longer per sweep, not more time per frame. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Inertia", meta=(ClampMin="4096", ClampMax="4194304", EditCondition="bUseComposedGrid && bUseThermalInertia"))
+    int32 InertiaCellsPerFrame = 65536;
+
+    /**
+     * Run the runtime grid in Q16.16 fixed point from quantised climate and sources, so every peer of a lockstep
+     * session (or a replay) reproduces it bit for bit. Uses the Diffusion rates; replaces diffusion and inertia.
+     * Sources are not occlusion-traced in this mode, only attenuated by the baked wall permeability.
+     * The climate clock then advances by whole fixed steps of game time from the game clock start; SystemUtc is ignored.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Deterministic", meta=(EditCondition="bUseComposedGrid"))
+    bool bDeterministicSimulation = false;
+
+    /** Only advance through StepDeterministicSimulation (e.g. from the lockstep tick); otherwise one fixed step per world tick. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Deterministic", meta=(EditCondition="bUseComposedGrid && bDeterministicSimulation"))
+    bool bDeterministicManualStep = false;
+
+    /** Replace the bake of unbounded volumes with runtime rings of cells around the viewpoint (baked data is reused where coarse enough). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Clipmap")
+    bool bUseUnboundedClipmap = false;
+
+    /** Nested rings; each doubles the cell size of the previous one, starting at the volume's cell size. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Clipmap", meta=(ClampMin="1", ClampMax="8", EditCondition="bUseUnboundedClipmap"))
+    int32 ClipmapLevels = 4;
+
+    /** Cells per axis per ring (rounded up to a power of two). Memory is Levels · Resolution³ cells per unbounded volume. */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Clipmap", meta=(ClampMin="8", ClampMax="128", EditCondition="bUseUnboundedClipmap"))
+    int32 ClipmapResolution = 32;
+
+    /** Newly exposed cells traced per frame (each costs the bake's hemisphere and neighbour traces). */
+    UPROPERTY(EditAnywhere, Config, Category="Runtime|Clipmap", meta=(ClampMin="1", ClampMax="4096", EditCondition="bUseUnboundedClipmap"))
+    int32 ClipmapTraceCellsPerFrame = 64;
+
     // ======== Helpers ========
     /** Diurnal ambient at sea level (°C). */
     UFUNCTION(BlueprintPure, Category="Thermo Forge")
@@ -139,6 +334,21 @@ public:
     UFUNCTION(BlueprintPure, Category="Thermo Forge")
     float GetAmbientCelsiusAt(bool bWinter, float TimeOfDayHours, float WorldZcm) const;
 
+    /** Ambient at world Z (°C) for a continuous season (0 = winter, 1 = summer); one diurnal curve, peak at DiurnalPeakHour. */
+    UFUNCTION(BlueprintPure, Category="Thermo Forge")
+    float GetAmbientCelsiusAtSeason(float SeasonAlpha01, float TimeOfDayHours, float WorldZcm) const;
+
+    /**
+     * Unit world vector toward the sun for a season (0 = winter solstice, 1 = summer) and solar time (noon at 12:00),
+     * at LatitudeDeg. Below the horizon the sun is held on it.
+     */
+    UFUNCTION(BlueprintPure, Category="Thermo Forge")
+    FVector GetSunDirectionAtSeason(float SeasonAlpha01, float TimeOfDayHours) const;
+
+    /** Smooth yearly season alpha for a date: 0 at the winter solstice, 1 at the summer solstice. */
+    UFUNCTION(BlueprintPure, Category="Thermo Forge")
+    static float GetSeasonAlphaForDate(const FDateTime& Date);
+
     /** Map material density & path thickness to permeability [0..1]. */
     UFUNCTION(BlueprintPure, Category="Thermo Forge")
     float DensityToPermeability(float DensityKgM3, float ThicknessFraction) const;
@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class AThermoForgeVolume;
+
+/**
+ * Remembers the volume and cell of the last query made through it. While the next point stays inside
+ * that volume and rounds to the same or an adjacent cell, UThermoForgeSubsystem answers from the cached
+ * frame instead of scanning every volume. Anything else (or a change to the volume set) is a full lookup.
+ * Hold one per caller; not thread safe.
+ */
+struct THERMOFORGE_API FThermoQueryCursor
+{
+    void Reset() { *this = FThermoQueryCursor(); }
+
+    /** Fast-path answers / full lookups since the last Reset (debugging aid). */
+    int32 GetNumFastHits() const { return NumFastHits; }
+    int32 GetNumFullLookups() const { return NumFullLookups; }
+
+private:
+    friend class UThermoForgeSubsystem;
+
+    /** Subsystem volume-set revision the cache was built against; 0 = empty. */
+    uint32 Revision = 0;
+
+    TWeakObjectPtr<AThermoForgeVolume> Volume;
+    /** Volume's node in the subsystem's volume index; a finer node containing the point forces a lookup. */
+    int32 Node = INDEX_NONE;
+
+    // grid (field frame)
+    FTransform Frame;
+    FTransform InvFrame;
+    FIntVector Dim = FIntVector::ZeroValue;
+    float      CellSizeCm = 0.f;
+
+    // containment (actor box)
+    FTransform InvActor;
+    FVector    BoxExtent = FVector::ZeroVector;
+    bool       bUnbounded = false;
+
+    // last cell
+    FIntVector Cell = FIntVector::ZeroValue;
+    int32      LinearIndex = INDEX_NONE;
+    FVector    CellCenterWS = FVector::ZeroVector;
+
+    int32 NumFastHits = 0;
+    int32 NumFullLookups = 0;
+};
@@ -0,0 +1,157 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ThermoForgeClimate.h"
+#include "ThermoForgeComposedGrid.h" // brick layout of FThermoSnapshotComposed
+#include "ThermoForgeFieldAsset.h" // FThermoForgeMinMaxLevel, FThermoFieldSearchView
+#include "ThermoForgeSourceComponent.h" // FThermoSourceShape
+#include "ThermoForgeWeatherMap.h"
+
+class AThermoForgeVolume;
+
+/** Baked channels of one field, copied so readers never touch the UObject. Shared between snapshots. */
+struct FThermoSnapshotField
+{
+    FIntVector Dim = FIntVector::ZeroValue;
+    float      CellSizeCm = 0.f;
+    FTransform Frame;
+    FTransform InvFrame;
+
+    TArray<float> SkyView01;
+    TArray<float> WallPermeability01;
+    /** Empty when the source asset has no directional bake. */
+    TArray<FVector4f> SunVisibilitySH;
+    /** Empty when the source asset had no matching pyramid. */
+    TArray<FThermoForgeMinMaxLevel> SkyViewHierarchy;
+
+    FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
+    FORCEINLINE float SkyAt(int32 i) const  { return SkyView01.IsValidIndex(i) ? FMath::Clamp(SkyView01[i], 0.f, 1.f) : 0.f; }
+    /** Sky weight of solar gain toward SunDirWS; SkyAt without a directional bake. */
+    FORCEINLINE float SolarAt(int32 i, const FVector& SunDirWS) const
+    {
+        return (SunVisibilitySH.IsValidIndex(i) && !SunDirWS.IsZero()) ? ThermoEvalSunVisibility(SunVisibilitySH[i], SunDirWS) : SkyAt(i);
+    }
+    FORCEINLINE float WallAt(int32 i) const { return WallPermeability01.IsValidIndex(i) ? FMath::Clamp(WallPermeability01[i], 0.f, 1.f) : 1.f; }
+
+    FThermoFieldSearchView MakeSearchView() const
+    {
+        FThermoFieldSearchView View;
+        View.Dim = Dim;
+        View.CellSizeCm = CellSizeCm;
+        View.Frame = Frame;
+        View.SkyView01 = SkyView01;
+        View.SkyViewHierarchy = SkyViewHierarchy;
+        return View;
+    }
+};
+
+/**
+ * Occluded source contribution of a composed grid at one revision, cut into FThermoForgeComposedGrid bricks.
+ * A brick's chunk is shared with every earlier snapshot that saw the same recomposition; only bricks
+ * recomposed since the previous publish are copied.
+ */
+struct FThermoSnapshotComposed
+{
+    /** SourceC of one clean brick, BrickSize³ values, brick-local x fastest. */
+    using FBrick = TArray<float>;
+
+    /** Grid brick order; null while the brick is dirty. */
+    TArray<TSharedPtr<const FBrick>> Bricks;
+    /** FThermoForgeComposedGrid::GetBrickSourceStamp each chunk was copied at. */
+    TArray<uint32> BrickStamps;
+    FIntVector     BrickDim = FIntVector::ZeroValue;
+
+    /** SourceC of a grid cell; false while its brick is dirty. */
+    FORCEINLINE bool SourceAt(const FIntVector& Cell, float& OutSourceC) const;
+};
+
+FORCEINLINE bool FThermoSnapshotComposed::SourceAt(const FIntVector& Cell, float& OutSourceC) const
+{
+    constexpr int32 B = FThermoForgeComposedGrid::BrickSize;
+    const FBrick* Brick = Bricks[((Cell.Z / B) * BrickDim.Y + (Cell.Y / B)) * BrickDim.X + (Cell.X / B)].Get();
+    if (!Brick) return false;
+
+    OutSourceC = (*Brick)[((Cell.Z % B) * B + (Cell.Y % B)) * B + (Cell.X % B)];
+    return true;
+}
+
+struct FThermoSnapshotVolume
+{
+    /** Identity only; resolve on the game thread. */
+    TWeakObjectPtr<AThermoForgeVolume> Volume;
+
+    /** Containment box (actor transform + extent), same test as the subsystem. */
+    FTransform ActorTransform;
+    FVector    BoxExtent = FVector::ZeroVector;
+    bool       bUnbounded = false;
+    float      BlendBorderCm = 0.f;
+
+    TSharedPtr<const FThermoSnapshotField>    Field;
+    /** Null when the composed cache is off. */
+    TSharedPtr<const FThermoSnapshotComposed> Composed;
+
+    bool Contains(const FVector& WorldPos) const;
+
+    /** Weight of this volume against its parent at WorldPos (see ThermoVolumeInnerWeight). */
+    float InnerWeight(const FVector& WorldPos) const;
+};
+
+/** Cell found by a snapshot search; Volume is resolved by the caller on the game thread. */
+struct FThermoSnapshotCellHit
+{
+    bool       bFound = false;
+    TWeakObjectPtr<AThermoForgeVolume> Volume;
+    FIntVector GridIndex = FIntVector::ZeroValue;
+    int32      LinearIndex = -1;
+    FVector    CellCenterWS = FVector::ZeroVector;
+    double     DistanceSq = TNumericLimits<double>::Max();
+    float      CellSizeCm = 0.f;
+    float      TempC = 0.f;
+    FDateTime  TimeUTC;   // climate instant TempC was evaluated at
+};
+
+struct FThermoSnapshotSource
+{
+    FThermoSourceShape Shape;
+    FBox BoundsWS = FBox(ForceInit);
+};
+
+/**
+ * Immutable copy of everything the runtime queries read, published by UThermoForgeSubsystem once per tick.
+ * Hold it through TSharedPtr<const FThermoForgeSnapshot> and query from any thread; nothing here touches
+ * UObjects or the scene. Unchanged volume data is shared between consecutive snapshots.
+ *
+ * No scene queries are possible off the game thread, so source occlusion comes from the composed cache;
+ * where a brick is still dirty (or the cache is off) sources are attenuated by wall permeability only.
+ */
+class THERMOFORGE_API FThermoForgeSnapshot
+{
+public:
+    FThermoClimateState Climate;
+    /** Resolve order (FThermoForgeVolumeIndex): the first containing volume is the finest. */
+    TArray<FThermoSnapshotVolume> Volumes;
+    TArray<FThermoSnapshotSource> Sources;
+    /** Regional weather; null when the map is off. Shared between snapshots until it advects. */
+    TSharedPtr<const FThermoForgeWeatherMap> Weather;
+    /** GFrameCounter at publish. */
+    uint64 FrameNumber = 0;
+
+    /** Current composed temperature (°C), same model as UThermoForgeSubsystem::ComputeTemperatureNow. */
+    float ComputeTemperatureAt(const FVector& WorldPos) const;
+
+    /** Ambient + solar only, same as UThermoForgeSubsystem::ComputeBakedOnlyTemperatureNow. */
+    float ComputeBakedOnlyTemperatureAt(const FVector& WorldPos) const;
+
+    /** Hottest/coldest baked cell near CenterWS, same search as UThermoForgeSubsystem::FindBakedExtremeNearNow. */
+    bool FindBakedExtremeNear(const FVector& CenterWS, float RadiusCm, bool bHottest, FThermoSnapshotCellHit& OutHit) const;
+
+    /** Nearest baked cell of the finest containing volume, else of any volume. */
+    bool FindNearestCell(const FVector& WorldPos, int32& OutVolume, int32& OutLinearIndex, FVector& OutCellCenterWS) const;
+
+private:
+    bool NearestInVolume(const FThermoSnapshotVolume& V, const FVector& WorldPos, int32& OutLinear, FVector& OutCenter, double& OutDistSq) const;
+    bool SampleComposed(const FThermoSnapshotVolume& V, const FVector& WorldPos, float& OutSourceC, float& OutSky01) const;
+
+    /** Weather map departure from the global climate at WorldPos (0 without a map). */
+    float WeatherOffsetAt(const FVector& WorldPos) const;
+};
@@ -19,6 +19,23 @@ enum class EThermoSourceFalloff : uint8
     InverseSquare UMETA(DisplayName="Inverse Square (1 / (1 + (d/R)^2))")
 };
 
+/** Resolved world-space shape of a source; plain data, safe to evaluate on any thread. */
+struct FThermoSourceShape
+{
+    FTransform Transform;
+    EThermoSourceShape Shape = EThermoSourceShape::Point;
+    EThermoSourceFalloff Falloff = EThermoSourceFalloff::Linear;
+    float IntensityCelsius = 0.f;
+    /** Owner scale already applied when bAffectByOwnerScale. */
+    float RadiusCm = 0.f;
+    FVector BoxExtent = FVector::ZeroVector;
+
+    float SampleAt(const FVector& WorldPos) const;
+
+    /** SampleAt plus its closed-form spatial derivative (°C per cm); zero for boxes (step edge). */
+    float SampleWithGradient(const FVector& WorldPos, FVector& OutGradient) const;
+};
+
 UCLASS(ClassGroup=(ThermoForge), BlueprintType, Blueprintable, meta=(BlueprintSpawnableComponent))
 class THERMOFORGE_API UThermoForgeSourceComponent : public UActorComponent
 {
@@ -55,6 +72,9 @@ public:
     UFUNCTION(BlueprintCallable, Category="Thermo Source")
     float SampleAt(const FVector& WorldPos) const;
 
+    /** Snapshot of the current shape for evaluation away from the component. */
+    FThermoSourceShape GetShapeWS() const;
+
     UFUNCTION(BlueprintPure, Category="Thermo Source")
     FTransform GetOwnerTransformSafe() const;
 
@@ -2,12 +2,27 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "HAL/CriticalSection.h"
+#include "Async/Future.h"
+#include "ThermoForgeBlockers.h"
+#include "ThermoForgeClimate.h"
+#include "ThermoForgeClipmap.h"
+#include "ThermoForgeComposedGrid.h"
+#include "ThermoForgeDiffusion.h"
+#include "ThermoForgeFixedPoint.h"
+#include "ThermoForgeInertia.h"
+#include "ThermoForgeSnapshot.h"
+#include "ThermoForgeQueryCursor.h"
+#include "ThermoForgeVolumeIndex.h"
+#include "ThermoForgeWeatherMap.h"
+#include "ThermoForgeZones.h"
 #include "ThermoForgeSubsystem.generated.h"
 
 class UThermoForgeSourceComponent;
 class AThermoForgeVolume;
 class UThermoForgeFieldAsset;
 class UThermoForgeProjectSettings;
+class UPrimitiveComponent;
 
 USTRUCT()
 struct FThermoProbe
@@ -52,11 +67,59 @@ struct FThermoForgeGridHit
     float CurrentTempC = 0.f;
 };
 
+/** Temperature along a segment or polyline, one sample per baked cell crossed. */
+USTRUCT(BlueprintType)
+struct FThermoPathStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    bool bValid = false;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    float LengthCm = 0.f;
+
+    /** ∫ T dl along the path (°C·cm). */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    float IntegralCcm = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    float MeanC = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    float MaxC = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    FVector MaxLocationWS = FVector::ZeroVector;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    float MinC = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    FVector MinLocationWS = FVector::ZeroVector;
+
+    /** T reached ThresholdC somewhere on the path. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    bool bCrossedThreshold = false;
+
+    /** First point at or above ThresholdC (the start if it already is). */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    FVector FirstCrossingWS = FVector::ZeroVector;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    float FirstCrossingDistanceCm = 0.f;
+
+    /** Cell intervals evaluated. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge")
+    int32 NumSamples = 0;
+};
+
 DECLARE_MULTICAST_DELEGATE_OneParam(FThermoBakeProgress, float /*Progress01*/);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FThermoSourcesChanged);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FThermoVolumeFieldPatched, AThermoForgeVolume*, Volume);
 
 UCLASS()
-class THERMOFORGE_API UThermoForgeSubsystem : public UWorldSubsystem
+class THERMOFORGE_API UThermoForgeSubsystem : public UTickableWorldSubsystem
 {
     GENERATED_BODY()
 public:
@@ -64,6 +127,60 @@ public:
     virtual void Initialize(FSubsystemCollectionBase& Collection) override;
     virtual void Deinitialize() override;
 
+    // tick (climate clock)
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    virtual bool IsTickableInEditor() const override { return true; }
+
+    // --------- Climate clock ----------
+    /** Climate at the current frame. Rebuilt once per tick; every runtime query reads this. */
+    const FThermoClimateState& GetClimateState() const { return ClimateState; }
+
+    UFUNCTION(BlueprintPure, Category="Thermo Forge|Climate", meta=(DisplayName="Get Climate State"))
+    FThermoClimateState K2_GetClimateState() const { return ClimateState; }
+
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Climate")
+    void SetWeatherAlpha(float InWeatherAlpha01);
+
+    /** Jump the game clock (GameTime mode) to a day and time. */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Climate")
+    void SetGameClock(int32 DayOfYear, float TimeOfDayHours);
+
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Climate")
+    void SetGameTimeScale(float InScale);
+
+    /** Blend a weather system (e.g. a storm) into the weather map; it drifts with the wind and fades back to the global weather. */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Climate")
+    void AddWeatherSystem(const FVector& CenterWS, float RadiusCm, float Cloud01, float Precip01, float WindChillC);
+
+    /** Wind the weather map drifts with (cm/s, world XY). */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Climate")
+    void SetWeatherWind(const FVector2D& WindCmPerSec);
+
+    /** Regional weather at WorldPos; false (and the global weather) where the map is off or does not reach. */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Climate")
+    bool GetWeatherAt(const FVector& WorldPos, float& OutCloud01, float& OutPrecip01, float& OutWindChillC) const;
+
+    // --------- Snapshot ----------
+    /**
+     * Latest published snapshot; callable from any thread. Keep the pointer for the duration of a job:
+     * it stays valid (and unchanged) until the last holder releases it.
+     */
+    TSharedPtr<const FThermoForgeSnapshot> GetSnapshot() const;
+
+    // --------- Async queries (worker threads, against the snapshot current at the call) ----------
+    /** ComputeTemperatureNow on a worker. The future completes off the game thread. */
+    TFuture<float> ComputeTemperatureAsync(const FVector& WorldPos);
+
+    /** Batch variant; results match Positions order. */
+    TFuture<TArray<float>> ComputeTemperaturesAsync(TArray<FVector> Positions);
+
+    /** FindBakedExtremeNearNow on a worker; resolve Hit.Volume on the game thread. */
+    TFuture<FThermoSnapshotCellHit> FindBakedExtremeNearAsync(const FVector& CenterWS, float RadiusCm, bool bHottest);
+
+    /** A volume was registered, unregistered, moved or re-baked; the resolve order is rebuilt on the next tick. */
+    void MarkVolumesDirty() { bVolumeIndexDirty = true; }
+
     // sources
     void RegisterSource(UThermoForgeSourceComponent* Source);
     void UnregisterSource(UThermoForgeSourceComponent* Source);
@@ -75,6 +192,14 @@ public:
     UPROPERTY(BlueprintAssignable, Category="Thermo Forge")
     FThermoSourcesChanged OnSourcesChanged;
 
+    /** A volume's baked field was patched in place (rebake or ApplyFieldPatchFromFile). */
+    UPROPERTY(BlueprintAssignable, Category="Thermo Forge")
+    FThermoVolumeFieldPatched OnFieldPatched;
+
+    /** Load a .tfpatch and apply it to its target field if loaded. Live: every world using the asset sees it. */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge")
+    bool ApplyFieldPatchFromFile(const FString& Filename);
+
     // --------- Geometry-only bake ----------
     UFUNCTION(BlueprintCallable, Category="Thermo Forge")
     void KickstartSamplingFromVolumes();
@@ -87,10 +212,33 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Query")
     float ComputeCurrentTemperatureAt(const FVector& WorldPos, bool bWinter, float TimeHours, float WeatherAlpha01) const;
 
-    /** Find nearest baked grid point; also fills CurrentTempC using default preview knobs. */
+    /** Same composition as ComputeCurrentTemperatureAt, with a continuous season (0 = winter, 1 = summer). */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Query")
+    float ComputeTemperatureAtSeason(const FVector& WorldPos, float SeasonAlpha01, float TimeHours, float WeatherAlpha01) const;
+
+    /** ComputeCurrentTemperatureAt at the climate clock's current instant. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="Thermo Forge|Query")
+    float ComputeTemperatureNow(const FVector& WorldPos) const;
+
+    /**
+     * Temperature (°C) and its world-space gradient (°C per cm) at the climate clock's current instant.
+     * Analytic inside a single volume's baked/composed cells: lapse term, trilinear derivative of the cells,
+     * closed-form source falloffs; temperature is the smooth (trilinear) value the gradient belongs to.
+     * In nested border bands, under evolving grids (diffusion, inertia, fixed-point) and clipmaps it is a
+     * central difference of ComputeTemperatureNow over half a cell.
+     */
+    UFUNCTION(BlueprintCallable, Category="Thermo Forge|Query")
+    float ComputeTemperatureGradientAt(const FVector& WorldPos, FVector& OutGradientCPerCm) const;
+
+    /** ComputeBakedOnlyTemperatureAt at the climate clock's current instant. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category="ThermoForge|Query")
+    float ComputeBakedOnlyTemperatureNow(const FVector& WorldPos) const;
+
+    /** Find nearest baked grid point; CurrentTempC is composed at QueryTimeUTC with the climate clock's weather. */
     UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
     FThermoForgeGridHit QueryNearestBakedGridPoint(const FVector& WorldLocation, const FDateTime& QueryTimeUTC) const;
 
+    /** Nearest baked grid point, CurrentTempC composed from the climate clock. */
     UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
     FThermoForgeGridHit QueryNearestBakedGridPointNow(const FVector& WorldLocation) const;
 
@@ -98,10 +246,141 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category="ThermoForge|Query")
     float ComputeBakedOnlyTemperatureAt(const FVector& WorldPos, bool bWinter, float TimeHours, float WeatherAlpha01) const;
 
-    // Find hottest/coldest baked cell near a point within RadiusCm (searches the right volume).
+    // Find hottest/coldest baked cell near a point within RadiusCm (searches the right volume), under the climate at QueryTimeUTC.
     UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
     bool FindBakedExtremeNear(const FVector& CenterWS, float RadiusCm, bool bHottest, FThermoForgeGridHit& OutHit, const FDateTime& QueryTimeUTC) const;
 
+    /** FindBakedExtremeNear at the climate clock's current instant; the hit is stamped with that instant. */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
+    bool FindBakedExtremeNearNow(const FVector& CenterWS, float RadiusCm, bool bHottest, FThermoForgeGridHit& OutHit) const;
+
+    /**
+     * Up to K hottest/coldest baked cells within RadiusCm, each at least MinSeparationCm from the others,
+     * best first, under the current climate. One hierarchical pass; returns the number found.
+     */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
+    int32 FindTopKExtremes(const FVector& CenterWS, float RadiusCm, int32 K, float MinSeparationCm, bool bHottest, TArray<FThermoForgeGridHit>& OutHits) const;
+
+    /**
+     * Temperature statistics along A→B at the climate clock's current instant. Walks the baked grid with a
+     * 3D DDA (one sample per crossed cell); source occlusion is traced once per source per segment. Samples
+     * resolve like ComputeTemperatureNow (nested blend, runtime grids, clipmaps, regional weather).
+     */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
+    FThermoPathStats QuerySegmentTemperature(const FVector& A, const FVector& B, float ThresholdC) const;
+
+    /** QuerySegmentTemperature over consecutive points; distances run along the whole path. */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Query")
+    FThermoPathStats QueryPathTemperature(const TArray<FVector>& Points, float ThresholdC) const;
+
+    /**
+     * Jump every diffusion grid to the steady state of its current sources and climate (level start,
+     * load, time skip). Grids whose composed sources are still being rebuilt settle once they finish.
+     */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Diffusion")
+    void SettleDiffusion();
+
+    /**
+     * Coarse wind over Volume's box for heat advection: WindDim cells (X fastest), world-space cm/s, added to the
+     * weather wind. False if the sizes don't match.
+     */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Diffusion")
+    bool SetVolumeWindField(AThermoForgeVolume* Volume, FIntVector WindDim, const TArray<FVector>& WindCmPerSec);
+
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Diffusion")
+    void ClearVolumeWindField(AThermoForgeVolume* Volume);
+
+    /** Jump every inertia grid to its composed temperature (load, time skip). */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Inertia")
+    void SnapThermalInertia();
+
+    /**
+     * Advance the deterministic grids by Steps fixed steps with the current sources (bDeterministicManualStep).
+     * Each step moves the climate clock by one step of game time, so the result does not depend on frame deltas.
+     */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Deterministic")
+    void StepDeterministicSimulation(int32 Steps = 1);
+
+    /** Jump the deterministic grids to their composed target and restart the step count (match or replay start). */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Deterministic")
+    void ResetDeterministicSimulation();
+
+    /** CRC32 of the step count and every deterministic grid (volumes in path order); differs between peers once they desync. */
+    UFUNCTION(BlueprintPure, Category="ThermoForge|Deterministic")
+    int32 GetDeterministicChecksum() const { return int32(FixedChecksum); }
+
+    /** Fixed steps taken since the deterministic grids were created or reset. */
+    UFUNCTION(BlueprintPure, Category="ThermoForge|Deterministic")
+    int64 GetDeterministicStep() const { return FixedStepCount; }
+
+    /** Centre the unbounded-volume clipmaps on CenterWS instead of the first player's viewpoint. */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Clipmap")
+    void SetClipmapCenter(const FVector& CenterWS);
+
+    /** Follow the first player's viewpoint again. */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Clipmap")
+    void ClearClipmapCenter();
+
+    // --------- Cursor queries (C++) ----------
+    /**
+     * Nearest baked cell (preferring containing volumes) through a cursor: O(1) while WorldPos stays in the
+     * cursor's volume within one cell of its last answer, a full lookup otherwise. Returns OutHit.bFound.
+     */
+    bool ResolveQueryCursor(FThermoQueryCursor& Cursor, const FVector& WorldPos, FThermoForgeGridHit& OutHit) const;
+
+    /** ComputeTemperatureNow with the volume/cell lookup served by Cursor. */
+    float ComputeTemperatureNow(const FVector& WorldPos, FThermoQueryCursor& Cursor) const;
+
+    /** QueryNearestBakedGridPointNow with the volume/cell lookup served by Cursor. */
+    FThermoForgeGridHit QueryNearestBakedGridPointNow(const FVector& WorldLocation, FThermoQueryCursor& Cursor) const;
+
+    // --------- Dynamic blockers ----------
+    /**
+     * Let heat through Blocker in proportion to Open01 (0 = as baked, 1 = gone). The cells around it are
+     * re-traced with it ignored over the next frames; composition, diffusion and snapshots pick the result up
+     * from this world's override layer without a rebake. The field asset keeps its bake, so regional box
+     * queries (summed-volume tables, min/max pyramid) still see the baked permeability.
+     * Refused while bDeterministicSimulation is on: the traces are physics queries and not reproducible.
+     * Returns a handle for SetDynamicBlockerOpen / RemoveDynamicBlocker (0 on failure).
+     */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Blockers")
+    int32 AddDynamicBlocker(UPrimitiveComponent* Blocker, float Open01 = 1.f);
+
+    /** AddDynamicBlocker for geometry that is already gone: the cells in BoundsWS are re-traced as they are now. */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Blockers")
+    int32 AddDynamicBlockerBox(const FBox& BoundsWS, float Open01 = 1.f);
+
+    /** Door open fraction; cheap once the blocker's cells are traced. */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Blockers")
+    void SetDynamicBlockerOpen(int32 BlockerId, float Open01);
+
+    /** Drop the blocker; its cells return to the baked permeability. */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Blockers")
+    void RemoveDynamicBlocker(int32 BlockerId);
+
+    // --------- Zones ----------
+    /**
+     * Track connected regions hotter (bAbove) or colder than ThresholdC under LayerName. Maintained
+     * incrementally from the composed grids each tick; requires bUseComposedGrid.
+     */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Zones")
+    void SetTemperatureZoneLayer(FName LayerName, float ThresholdC, bool bAbove = true);
+
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Zones")
+    void RemoveTemperatureZoneLayer(FName LayerName);
+
+    /** Zone of the layer containing WorldPos (O(1) label lookup). */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Zones")
+    bool FindZoneAt(FName LayerName, const FVector& WorldPos, FThermoZoneInfo& OutZone) const;
+
+    /** Every zone of the layer across all volumes. */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Zones")
+    int32 GetTemperatureZones(FName LayerName, TArray<FThermoZoneInfo>& OutZones) const;
+
+    /** The layer's isosurface as a world-space triangle list (e.g. for a procedural mesh). */
+    UFUNCTION(BlueprintCallable, Category="ThermoForge|Zones")
+    bool GetZoneIsosurface(FName LayerName, TArray<FVector>& OutVertices, TArray<int32>& OutTriangles) const;
+
     // Progress
 
     void TickBake();
@@ -115,7 +394,10 @@ public:
     int32 Bake_ix0, Bake_iy0, Bake_iz0;
 
     TArray<float> BakeSky, BakeWall, BakeIndoor;
+    TArray<FVector4f> BakeSunSH;
     TArray<FVector> BakeHemiDirs;
+    /** Per hemisphere ray, its weight in the L1 sun visibility fit (SH = Σ open · weight). */
+    TArray<FVector4f> BakeSunFit;
 
     FTimerHandle BakeTimerHandle;
 
@@ -156,18 +438,243 @@ private:
     float TraceAmbientRay01(const FVector& P, const FVector& Dir, float MaxLen) const;
 
     static void TF_DumpFieldToSavedFolder(const FString& VolName,
-        const FIntVector& Dim, float Cell, const FVector& OriginWS,
+        const FIntVector& Dim, float Cell, const FVector& OriginWS, const FRotator& GridRotation,
         const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01);
 
     bool ComputeNearestInVolume(const AThermoForgeVolume* Vol, const FVector& WorldLocation, FThermoForgeGridHit& OutHit) const;
     bool VolumeContainsPoint(const AThermoForgeVolume* Vol, const FVector& WorldLocation) const;
 
+    /** Nearest cell over all baked volumes (no containment preference). */
+    bool FindNearestCell(const FVector& WorldPos, FThermoForgeGridHit& OutHit) const;
+
+    /** Nearest cell, preferring volumes that contain the point. */
+    bool FindNearestCellPreferContaining(const FVector& WorldPos, FThermoForgeGridHit& OutHit) const;
+
+    void RebuildClimateState();
+
+    /** Climate at TimeUTC under the current weather and settings (what the clock would publish at that instant). */
+    FThermoClimateState MakeClimateState(const FDateTime& TimeUTC) const;
+
+    /** FindBakedExtremeNear under Climate; the hit is stamped with Climate.TimeUTC. */
+    bool FindBakedExtremeUnder(const FThermoClimateState& Climate, const FVector& CenterWS, float RadiusCm, bool bHottest, FThermoForgeGridHit& OutHit) const;
+
+    /** Running state of a path walk between segments. */
+    struct FPathWalk
+    {
+        float   ThresholdC = 0.f;
+        bool    bHasPrev = false;
+        float   PrevT = 0.f;
+        double  PrevDistCm = 0.0;
+        FVector PrevPos = FVector::ZeroVector;
+    };
+
+    void AccumulatePathSegment(const FVector& A, const FVector& B, double DistanceOffsetCm, FPathWalk& Walk, FThermoPathStats& Out) const;
+
+    /** Ambient + solar(sky toward SunDirWS at Hit) + sources(wall perm at Hit) at WorldPos; one pass over the sources. */
+    float ComposeTemperatureAtHit(const FThermoForgeGridHit& Hit, const FVector& WorldPos, float AmbientC, float WeatherAlpha01, const FVector& SunDirWS) const;
+
+    /** ComposeTemperatureAtHit with the baked scalars supplied directly. */
+    float ComposeTemperatureFromChannels(const FVector& WorldPos, float AmbientC, float WeatherAlpha01, float Sky01, float WallPerm01) const;
+
 #if WITH_EDITOR
     UThermoForgeFieldAsset* CreateAndSaveFieldAsset(AThermoForgeVolume* Volume, const FIntVector& Dim, float Cell, const FVector& FieldOriginWS, const FRotator& GridRotation,
-                                                    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01) const;
+                                                    const TArray<float>& SkyView01, const TArray<float>& WallPerm01, const TArray<float>& Indoor01,
+                                                    const TArray<FVector4f>& SunVisibilitySH) const;
 #endif
 
     void CompactSources();
+    void HandleFieldPatched(UThermoForgeFieldAsset* Field);
+
+    /** bUseComposedGrid, limited to game worlds (PIE, standalone); editor worlds query the baked field directly. */
+    bool UseComposedGrids() const;
+
+    /** Sync grids with the world's volumes, dirty bricks around changed sources, recompose within budget. */
+    void UpdateComposedGrids();
+
+    /** Whether an evolving grid (clipmap, fixed-point, diffusion, inertia) may answer for Vol at WorldPos (null Vol: any clipmap). */
+    bool HasEvolvingTemp(const AThermoForgeVolume* Vol, const FVector& WorldPos) const;
+
+    /** Current temperature from one volume: its runtime grids, else its nearest baked cell. */
+    bool SampleVolumeNow(const AThermoForgeVolume* Vol, const FVector& WorldPos, float& OutTempC) const;
+
+    /** Baked composition in Vol (null: nearest cell anywhere) under the current climate; false if Vol has no cell. */
+    using FComposeBakedFn = TFunctionRef<bool(const AThermoForgeVolume* Vol, const FVector& WorldPos, float& OutTempC)>;
+    bool ComposeBakedNow(const AThermoForgeVolume* Vol, const FVector& WorldPos, float& OutTempC) const;
+
+    /**
+     * The ComputeTemperatureNow resolver: containing volumes blended (runtime grids, else ComposeBaked), then the
+     * clipmaps, then ComposeBaked(nullptr); plus regional weather. Callers caching cells or occlusion pass their own
+     * ComposeBaked; everything else stays shared.
+     */
+    float SampleTemperatureNow(const FVector& WorldPos, FComposeBakedFn ComposeBaked) const;
+
+    /** Explicit-climate composition over the containing volumes (finest first, blended into parents), else the nearest cell. */
+    float ComposeNestedAt(const FVector& WorldPos, float AmbientC, float WeatherAlpha01, const FVector& SunDirWS) const;
+
+    /** Advance the diffusion grids towards the composed temperatures (bUseDiffusion). */
+    void UpdateDiffusion(float DeltaTime);
+
+    /** Relax the inertia grids towards the composed temperatures (bUseThermalInertia, diffusion off). */
+    void UpdateInertia();
+
+    /** Create/drop fixed-point grids with the composed ones (new grids are snapped); false when the mode is off. */
+    bool SyncFixedGrids();
+
+    /** One automatic fixed step per tick unless bDeterministicManualStep. */
+    void UpdateDeterministic();
+
+    /** Quantise this tick's sources, then step every fixed-point grid Steps times, each on its own step's climate. */
+    void AdvanceFixedGrids(int32 Steps);
+
+    /** Climate of the fixed clock (game clock start + FixedClockTicks), integer maths only. */
+    FThermoFixedClimate MakeFixedClimate() const;
+
+    /** Enabled sources as quantised into Grid's cell space. */
+    void GatherFixedSources(const FThermoForgeFixedGrid& Grid, TArray<FThermoFixedSource>& OutSources) const;
+
+    void RefreshFixedChecksum();
+
+    /** Keep one clipmap per unbounded volume centred on the viewpoint and fill exposed cells within budget. */
+    void UpdateClipmaps();
+
+    /** SkyView01 / WallPermeability01 of one runtime cell, traced like the bake. */
+    void TraceCellChannels(const FVector& CenterWS, float CellSizeCm, float& OutSky01, float& OutWallPerm01) const;
+
+    /** Temperature composed from the first clipmap covering WorldPos; false if none. */
+    bool SampleClipmapTemp(const FVector& WorldPos, float& OutTempC) const;
+
+    /** Runtime temperature of Vol's grids at WorldPos: clipmap, then deterministic, diffusion, inertia, then the composed cache. */
+    bool SampleRuntimeTemp(const AThermoForgeVolume* Vol, const FVector& WorldPos, float& OutTempC) const;
+
+    /** Fold this tick's composed temperature changes into every zone layer. */
+    void UpdateZoneLayers();
+
+    /** Create, resize or drop the weather map per the settings and advect it in fixed steps. */
+    void UpdateWeatherMap(float DeltaTime);
+
+    /** Collect the baked cells within a cell of the blocker's bounds. */
+    void RasteriseBlocker(FThermoDynamicBlocker& Blocker) const;
+
+    /** Re-trace queued blocker cells under BlockerTraceBudgetMs; fold in every blocker that finishes. */
+    void UpdateBlockers();
+
+    /** False (with a warning) while blockers can't be honoured; Caller names the entry point in the log. */
+    bool CanAddBlocker(const TCHAR* Caller) const;
+
+    /** Move the blocker's contribution in the override layers from AppliedOpen01 to Open01 (bRemove: take it out). */
+    void ApplyBlocker(FThermoDynamicBlocker& Blocker, bool bRemove);
+
+    /** This world's blocker overrides for Field, or null if no blocker covers it. */
+    TSharedPtr<const FThermoPermOverrideLayer> FindPermOverrides(const UThermoForgeFieldAsset* Field) const;
+
+    /** WallPermeability01 of Field at Linear with this world's blocker overrides applied. */
+    float GetWallPermAt(const UThermoForgeFieldAsset* Field, int32 Linear) const;
+
+    /** OcclusionBetween with Ignore left out of the trace. */
+    float OcclusionBetweenIgnoring(const FVector& A, const FVector& B, float CellSizeCm, const UPrimitiveComponent* Ignore) const;
+
+    /** SetWeatherWind's wind, or the configured default. */
+    FVector2D GetWeatherWind() const;
+
+    /** Weather map departure from the global climate at WorldPos; Hit supplies the cell's solar weight. */
+    float WeatherOffsetAt(const FVector& WorldPos) const;
+    float WeatherOffsetAtHit(const FVector& WorldPos, const FThermoForgeGridHit& Hit) const;
+
+    /** Build this frame's snapshot (reusing unchanged volume data) and swap it in. */
+    void PublishSnapshot();
+
+    /** Snapshot for an async job; publishes one first if nothing has ticked yet (game thread only). */
+    TSharedPtr<const FThermoForgeSnapshot> GetSnapshotForAsync();
+
+    FDelegateHandle FieldPatchedHandle;
+
+    // climate clock
+    FThermoClimateState ClimateState;
+    /** Game-time seconds since the clock's start instant (GameTime mode). */
+    double GameClockSeconds = 0.0;
+    FDateTime GameClockStart = FDateTime(0);
+    float GameTimeScale = 60.f;
+    float WeatherAlpha01 = 0.3f;
+
+    // weather map
+    TSharedPtr<FThermoForgeWeatherMap> WeatherMap;
+    FVector2D WeatherWind = FVector2D::ZeroVector;
+    bool      bHasWeatherWind = false;
+    float     WeatherStepAccum = 0.f;
+    /** Copy handed to snapshots; refreshed when the map's revision moves. */
+    TSharedPtr<const FThermoForgeWeatherMap> PublishedWeather;
+    uint32    PublishedWeatherRevision = 0;
+
+    // composed cache
+    /** What a source looked like when its bricks were last composed. */
+    struct FSourceStamp
+    {
+        FBox       BoundsWS = FBox(ForceInit);
+        FTransform Transform;
+        uint32     ParamHash = 0;
+    };
+
+    TMap<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeComposedGrid>> ComposedGrids;
+    TMap<TWeakObjectPtr<UThermoForgeSourceComponent>, FSourceStamp> SourceStamps;
+
+    // diffusion
+    TMap<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeDiffusionGrid>> DiffusionGrids;
+    TMap<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<const FThermoWindField>> WindFields;
+
+    // dynamic blockers
+    TMap<int32, FThermoDynamicBlocker> Blockers;
+    int32 NextBlockerId = 1;
+    /** Per field this world's blockers cover; the shared assets are never written. */
+    TMap<TWeakObjectPtr<const UThermoForgeFieldAsset>, TSharedPtr<FThermoPermOverrideLayer>> PermOverrides;
+
+    // inertia
+    TMap<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeInertiaGrid>> InertiaGrids;
+
+    // clipmaps (unbounded volumes)
+    TMap<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeClipmap>> Clipmaps;
+    bool    bHasClipmapCenter = false;
+    FVector ClipmapCenter = FVector::ZeroVector;
+
+    // deterministic
+    TMap<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeFixedGrid>> FixedGrids;
+    int64  FixedStepCount = 0;
+    /** Game time the fixed steps have covered since GameClockStart (FDateTime ticks); the climate clock while deterministic. */
+    int64  FixedClockTicks = 0;
+    uint32 FixedChecksum = 0;
+
+    // zones
+    struct FZoneLayer
+    {
+        float ThresholdC = 0.f;
+        bool  bAbove = true;
+        TMap<TWeakObjectPtr<AThermoForgeVolume>, TSharedPtr<FThermoForgeZoneMap>> Maps;
+    };
+
+    TMap<FName, FZoneLayer> ZoneLayers;
+
+    // snapshot
+    /** Per-volume data carried from one snapshot to the next until it changes. */
+    struct FSnapshotVolumeCache
+    {
+        TWeakObjectPtr<const UThermoForgeFieldAsset> FieldAsset;
+        TSharedPtr<const FThermoSnapshotField> Field;
+        TSharedPtr<const FThermoSnapshotComposed> Composed;
+        const FThermoForgeComposedGrid* ComposedFrom = nullptr;
+        uint32 ComposedRevision = 0;
+    };
+
+    TMap<TWeakObjectPtr<AThermoForgeVolume>, FSnapshotVolumeCache> SnapshotCache;
+
+    mutable FRWLock SnapshotLock;
+    TSharedPtr<const FThermoForgeSnapshot> Snapshot;
+
+    /** Bumped by PublishSnapshot whenever the baked volumes, their fields, boxes or nesting change; invalidates cursors. */
+    uint32 VolumeSetRevision = 1;
+    uint32 VolumeSetHash = 0;
+
+    /** Baked volumes in resolve order, rebuilt by PublishSnapshot after MarkVolumesDirty. */
+    FThermoForgeVolumeIndex VolumeIndex;
+    bool bVolumeIndexDirty = true;
 
     // data
     TSet<TWeakObjectPtr<UThermoForgeSourceComponent>> SourceSet;
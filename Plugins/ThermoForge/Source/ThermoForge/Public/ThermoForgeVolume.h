@@ -37,6 +37,8 @@ public:
 
     virtual void BeginPlay() override;
     virtual void OnConstruction(const FTransform& Transform) override;
+    virtual void PostRegisterAllComponents() override;
+    virtual void PostUnregisterAllComponents() override;
 
     UPROPERTY(EditAnywhere, Blueprintable, Category="A Thermo Forge Volume|Field")
     TSoftObjectPtr<UThermoForgeFieldAsset> BakedFieldRef;
@@ -62,6 +64,15 @@ public:
     UPROPERTY(EditAnywhere, Category="A Thermo Forge Volume")
     bool bUnbounded = false;
 
+    // -------- Nesting --------
+    /** Resolve order where volumes overlap: higher first; ties go to finer cells, then smaller boxes. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="A Thermo Forge Volume|Nesting")
+    int32 Priority = 0;
+
+    /** Band inside the box faces across which queries fade into the enclosing volume; 0 = hard edge. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="A Thermo Forge Volume|Nesting", meta=(ClampMin="0.0", Units="cm"))
+    float BlendBorderCm = 0.f;
+
     // -------- Grid --------
     UPROPERTY(EditAnywhere, Blueprintable, Category="A Thermo Forge Volume|Grid")
     bool bUseGlobalGrid = true;
@@ -125,6 +136,11 @@ private:
     UPROPERTY(VisibleAnywhere, Category="A Thermo Forge Volume")
     UBoxComponent* Bounds = nullptr;
 
+    /** Tell the world's ThermoForge subsystem that this volume's box, field or nesting changed. */
+    void NotifyVolumeChanged() const;
+    void HandleTransformUpdated(USceneComponent* Component, EUpdateTransformFlags Flags, ETeleportType Teleport);
+    FDelegateHandle TransformUpdatedHandle;
+
     // Helpers used by preview; declared for all builds (definitions may be editor-guarded)
     void        ApplyBasePreviewMaterialIfNeeded();
     void        ApplyHeatMaterialIfPossible();
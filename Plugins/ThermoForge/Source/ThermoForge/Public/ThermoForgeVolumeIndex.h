@@ -0,0 +1,106 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class AThermoForgeVolume;
+class UWorld;
+
+/**
+ * How far P is inside an actor box, as a blend weight: 1 from BlendBorderCm inside the faces inwards, falling
+ * linearly to 0 on the faces (no band: 1 everywhere inside). Unbounded boxes are always 1; outside is -1.
+ */
+inline float ThermoVolumeInnerWeight(const FTransform& ActorTransform, const FVector& BoxExtent, bool bUnbounded, float BlendBorderCm, const FVector& P)
+{
+    if (bUnbounded) return 1.f;
+
+    const FVector L = ActorTransform.InverseTransformPosition(P);
+    const double Inner = FMath::Min3(BoxExtent.X - FMath::Abs(L.X), BoxExtent.Y - FMath::Abs(L.Y), BoxExtent.Z - FMath::Abs(L.Z));
+    if (Inner < 0.0) return -1.f;
+    return BlendBorderCm > 0.f ? float(FMath::Min(1.0, Inner / BlendBorderCm)) : 1.f;
+}
+
+/** One baked volume as seen by the query resolver. */
+struct FThermoVolumeNode
+{
+    TWeakObjectPtr<AThermoForgeVolume> Volume;
+    FTransform ActorTransform;
+    FVector    BoxExtent = FVector::ZeroVector;
+    FBox       WorldBox = FBox(ForceInit);
+    bool       bUnbounded = false;
+    int32      Priority = 0;
+    float      CellSizeCm = 0.f;
+    float      BlendBorderCm = 0.f;
+
+    bool Contains(const FVector& P) const
+    {
+        return bUnbounded || (WorldBox.IsInsideOrOn(P) && InnerWeight(P) >= 0.f);
+    }
+    float InnerWeight(const FVector& P) const
+    {
+        return ThermoVolumeInnerWeight(ActorTransform, BoxExtent, bUnbounded, BlendBorderCm, P);
+    }
+};
+
+/**
+ * Baked volumes in resolve order: higher Priority first, then bounded before unbounded, finer cells first,
+ * smaller boxes first. The first node containing a point is the finest volume there; the next containing
+ * node after it is its parent. Queries blend a node into its parent across the node's BlendBorderCm band
+ * and never sample a parent where a child's weight is 1.
+ */
+class THERMOFORGE_API FThermoForgeVolumeIndex
+{
+public:
+    /** Parents visited per query at most. */
+    static constexpr int32 MaxBlendDepth = 4;
+
+    /** Collect every volume in World with a usable baked field, in resolve order. */
+    void Build(UWorld* World);
+
+    void Reset() { Nodes.Reset(); }
+    int32 Num() const { return Nodes.Num(); }
+    const FThermoVolumeNode& operator[](int32 i) const { return Nodes[i]; }
+
+    /** Node of Vol, or INDEX_NONE. */
+    int32 Find(const AThermoForgeVolume* Vol) const;
+
+    /** First node after After (resolve order) containing P, or INDEX_NONE. */
+    int32 NextContaining(const FVector& P, int32 After = INDEX_NONE) const;
+
+    /** Hash of everything that affects resolve order and containment. */
+    uint32 GetHash() const { return Hash; }
+
+    /**
+     * Walk the containing nodes from Start (or the finest containing node), weighting each sample by its
+     * inner weight and handing the remainder to the next parent; whatever is left goes to the last sampled
+     * node. Sample(Node, OutValue) may decline a node, which passes it on. False if nothing was sampled.
+     */
+    template<typename FSampleFn>
+    bool Blend(const FVector& P, FSampleFn&& Sample, float& OutValue, int32 Start = INDEX_NONE) const
+    {
+        float Sum = 0.f, Remaining = 1.f, Last = 0.f;
+        bool bAny = false;
+
+        int32 n = (Nodes.IsValidIndex(Start) && Nodes[Start].Contains(P)) ? Start : NextContaining(P);
+        for (int32 Depth=0; n != INDEX_NONE && Depth < MaxBlendDepth; n = NextContaining(P, n))
+        {
+            float V = 0.f;
+            if (!Sample(Nodes[n], V)) continue;
+            ++Depth;
+
+            const float W = FMath::Clamp(Nodes[n].InnerWeight(P), 0.f, 1.f);
+            Sum       += Remaining * W * V;
+            Remaining *= 1.f - W;
+            Last       = V;
+            bAny       = true;
+            if (Remaining <= KINDA_SMALL_NUMBER) break;
+        }
+        if (!bAny) return false;
+
+        OutValue = Sum + Remaining * Last;
+        return true;
+    }
+
+private:
+    TArray<FThermoVolumeNode> Nodes;
+    uint32 Hash = 0;
+};
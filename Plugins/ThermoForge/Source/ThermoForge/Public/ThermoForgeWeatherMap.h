@@ -0,0 +1,70 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Regional weather on a world-aligned 2D grid (Resolution² cells of CellSizeCm, centred on CenterWS):
+ * cloud cover, precipitation and wind chill. The global WeatherAlpha01 stays the climate's baseline; the map
+ * is a departure from it, so queries only add
+ *   Offset = SolarGainScaleC · Sky · (WeatherAlpha01 - Cloud) - WindChillC - PrecipCoolingC · Precip
+ * on top of whatever the runtime grids composed. Outside the map every channel reads as the baseline.
+ */
+class THERMOFORGE_API FThermoForgeWeatherMap
+{
+public:
+    struct FParams
+    {
+        int32     Resolution = 64;
+        float     CellSizeCm = 10000.f;
+        FVector2D CenterWS = FVector2D::ZeroVector;
+    };
+
+    struct FSample
+    {
+        float Cloud01 = 0.f;
+        float Precip01 = 0.f;
+        float WindChillC = 0.f;
+    };
+
+    /** Fill every cell with the baseline (clear of precipitation and chill). */
+    void Init(const FParams& InParams, float BaselineCloud01);
+    bool IsValidFor(const FParams& InParams) const;
+
+    /** How a departure turns into °C; copied in by the owner so published copies carry it. */
+    void SetResponse(float InSolarGainScaleC, float InPrecipCoolingC);
+
+    /**
+     * Semi-Lagrangian step under a uniform wind: every cell reads its upwind point, so the four bilinear weights
+     * are shared by the whole grid. Air blowing in from outside carries the baseline, and every cell relaxes
+     * towards it with time constant RelaxSeconds (0 = never).
+     */
+    void Advect(float DeltaSeconds, const FVector2D& WindCmPerSec, float RelaxSeconds, float BaselineCloud01);
+
+    /** Blend a weather system into the map: Peak at CenterWS, fading to untouched at RadiusCm. */
+    void AddSystem(const FVector& CenterWS, float RadiusCm, const FSample& Peak);
+
+    /** Bilinear channels at P; false (and the baseline) outside the map. */
+    bool Sample(const FVector& P, FSample& Out) const;
+
+    /** Temperature departure from the global climate at P for a cell with solar weight SolarSky01. */
+    float TemperatureOffsetC(const FVector& P, float SolarSky01, float GlobalWeather01) const;
+
+    /** Bumped whenever any cell changes. */
+    uint32 GetRevision() const { return Revision; }
+
+private:
+    enum EChannel { Cloud, Precip, Chill, NumChannels };
+
+    FORCEINLINE int32 Index(int32 x, int32 y) const { return y * Params.Resolution + x; }
+
+    FParams   Params;
+    FVector2D MinWS = FVector2D::ZeroVector;
+    float     Baseline[NumChannels] = { 0.f, 0.f, 0.f };
+
+    TArray<float> Channels[NumChannels];
+    TArray<float> Scratch;
+
+    float  SolarGainScaleC = 0.f;
+    float  PrecipCoolingC = 0.f;
+    uint32 Revision = 0;
+};
@@ -0,0 +1,122 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "ThermoForgeZones.generated.h"
+
+class AThermoForgeVolume;
+class FThermoForgeComposedGrid;
+
+/** One connected region of cells beyond a zone layer's threshold. */
+USTRUCT(BlueprintType)
+struct FThermoZoneInfo
+{
+    GENERATED_BODY()
+
+    /** 1-based within its volume; 0 = no zone. Kept while the zone is untouched; merged or split zones are renumbered. */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Zones")
+    int32 ZoneId = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Zones")
+    TObjectPtr<AThermoForgeVolume> Volume = nullptr;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Zones")
+    FBox BoundsWS = FBox(ForceInit);
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Zones")
+    int32 NumCells = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Zones")
+    float VolumeM3 = 0.f;
+
+    /** Hottest cell for "above" layers, coldest for "below" layers (°C). */
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Zones")
+    float PeakC = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category="ThermoForge|Zones")
+    float MeanC = 0.f;
+};
+
+/**
+ * Iso-regions of one composed grid for a threshold: cell mask, 6-connected zone labels and an
+ * isosurface mesh. Update() only revisits bricks whose composed temperature changed since the last
+ * call. When cells cross the threshold only the zones touching them are relabelled (merges and splits
+ * stay local); zone stats are kept per brick and re-summed from the bricks that changed; meshes are
+ * rebuilt only for the touched bricks.
+ */
+class THERMOFORGE_API FThermoForgeZoneMap
+{
+public:
+    struct FZone
+    {
+        FIntVector MinCell = FIntVector(MAX_int32);
+        FIntVector MaxCell = FIntVector(MIN_int32);
+        int32  NumCells = 0;
+        float  PeakC = 0.f;
+        double SumC = 0.0;
+    };
+
+    void Configure(float InThresholdC, bool bInAbove);
+
+    /** Bring mask, labels and mesh up to date with Grid. Returns true if anything changed. */
+    bool Update(const FThermoForgeComposedGrid& Grid);
+
+    /** Zone id of the cell containing WorldPos (O(1)); 0 outside the grid or any zone. */
+    int32 ZoneAt(const FVector& WorldPos) const;
+
+    /** Zones indexed by id - 1. */
+    const TArray<FZone>& GetZones() const { return Zones; }
+
+    /** Fill everything but Volume. */
+    bool GetZoneInfo(int32 ZoneId, FThermoZoneInfo& Out) const;
+
+    /** Append this grid's isosurface (world space, triangle list) to the buffers. */
+    void AppendMesh(TArray<FVector>& OutVertices, TArray<int32>& OutTriangles) const;
+
+private:
+    void Reset(const FThermoForgeComposedGrid& Grid);
+    /** Label every masked cell from scratch. */
+    void RelabelAll();
+    /** Relabel the zones containing or bordering Flipped cells; bricks whose labels moved are set in OutBricks. */
+    void RelabelAround(TConstArrayView<int32> Flipped, TBitArray<>& OutBricks);
+    /** Label the unlabelled masked component around Seed as Id. */
+    void Flood(int32 Seed, int32 Id, TArray<int32>& Stack, TBitArray<>* OutBricks);
+    void RebuildBrickStats(int32 Brick, const TArray<float>& TempC);
+    void SumZoneStats();
+    void RemeshBrick(int32 bx, int32 by, int32 bz, const TArray<float>& TempC);
+
+    FORCEINLINE bool Inside(float T) const { return bAbove ? (T >= ThresholdC) : (T <= ThresholdC); }
+    FORCEINLINE int32 Index(int32 x, int32 y, int32 z) const { return (z * Dim.Y + y) * Dim.X + x; }
+    FORCEINLINE int32 BrickIndex(int32 bx, int32 by, int32 bz) const { return (bz * BrickDim.Y + by) * BrickDim.X + bx; }
+    int32 BrickOfCell(int32 i) const;
+
+    float ThresholdC = 0.f;
+    bool  bAbove = true;
+
+    FIntVector Dim = FIntVector::ZeroValue;
+    FIntVector BrickDim = FIntVector::ZeroValue;
+    float      CellSizeCm = 0.f;
+    FTransform Frame;
+    FTransform InvFrame;
+
+    /** Grid TempStamp already folded in; 0 forces a full pass. */
+    uint32 SeenStamp = 0;
+
+    TBitArray<>   Mask;
+    TArray<int32> Labels;
+    /** Zones by id - 1; ids on FreeIds are empty and reused first. */
+    TArray<FZone> Zones;
+    TArray<int32> FreeIds;
+
+    /** One zone's share of one brick. */
+    struct FBrickZone
+    {
+        int32 Id = 0;
+        FZone Stats;
+    };
+    /** Per brick, the zones with cells in it; Zones are the sums of these. */
+    TArray<TArray<FBrickZone, TInlineAllocator<2>>> BrickZones;
+
+    /** Triangle soup per brick (cubes whose min corner lies in the brick). */
+    TArray<TArray<FVector>> BrickVertices;
+};
@@ -42,7 +42,8 @@ public class ThermoForge : ModuleRules
 			"DeveloperSettings",  
 			"GameplayTags", 
 			"NavigationSystem", 
-			"GameplayTasks"
+			"GameplayTasks",
+			"Json"
 		});
 		
 		